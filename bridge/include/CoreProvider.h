@@ -66,6 +66,7 @@ class IMenuManager;
 struct DatabaseInfo;
 class IPlayerInfoBridge;
 class ICommandArgs;
+class ITextListener_SMC;
 
 typedef ke::Function<bool(int client, const ICommandArgs*)> CommandFunc;
 
@@ -127,6 +128,7 @@ public:
 	bool			(*AreConfigsExecuted)();
 	void			(*ExecuteConfigs)(IPluginContext *ctx);
 	void			(*GetDBInfoFromKeyValues)(KeyValues *, DatabaseInfo *);
+	void			(*WalkKeyValues)(KeyValues *, ITextListener_SMC *);
 	int				(*GetActivityFlags)();
 	int				(*GetImmunityMode)();
 	void			(*UpdateAdminCmdFlags)(const char *cmd, OverrideType type, FlagBits bits, bool remove);
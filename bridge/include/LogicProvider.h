@@ -76,6 +76,7 @@ struct sm_logic_t
 	void			(*SetEntityLumpWritable)(bool writable);
 	bool			(*ParseEntityLumpString)(const char *entityString, int &status, size_t &position);
 	const char *	(*GetEntityLumpString)();
+	void			(*GetAdminAccessCacheStats)(uint64_t *hits, uint64_t *misses, uint64_t *flushes, size_t *commands);
 	IScriptManager	*scripts;
 	IShareSys		*sharesys;
 	IExtensionSys	*extsys;
@@ -46,4 +46,6 @@ parser.options.add_argument('--scripting-only', action='store_true', dest='scrip
                           help="Only build and package the files required for scripting in SourcePawn.")
 parser.options.add_argument('--enable-asan', action='store_true', dest='enable_asan',
                             default=False, help='Enable ASAN (clang only)')
+parser.options.add_argument('--enable-benchmarks', action='store_true', dest='benchmarks',
+                            default=False, help='Build the host-less core/logic benchmark (tools/logicbench)')
 parser.Configure()
@@ -46,8 +46,22 @@
 ChatTriggers g_ChatTriggers;
 bool g_bSupressSilentFails = false;
 
+/* Distinct words looked up as triggers before the cache starts over. Chat is
+ * player input, so this keeps typos and spam from growing it without bound.
+ */
+static const size_t kMaxCachedTriggers = 256;
+
+static const char *s_StageNames[] = {
+	"parse",
+	"flood check",
+	"trigger lookup",
+	"say forward",
+	"trigger exec",
+	"post forward",
+};
+
 ChatTriggers::ChatTriggers() : m_bWillProcessInPost(false),
-	m_ReplyTo(SM_REPLY_CONSOLE), m_ArgSBackup(NULL)
+	m_ReplyTo(SM_REPLY_CONSOLE), m_ArgSBackup(NULL), m_TriggerCacheGen(0)
 {
 	m_PubTrigger = "!";
 	m_PrivTrigger = "/";
@@ -56,6 +70,8 @@ ChatTriggers::ChatTriggers() : m_bWillProcessInPost(false),
 #if SOURCE_ENGINE == SE_EPISODEONE
 	m_bIsINS = false;
 #endif
+	memset(m_Stages, 0, sizeof(m_Stages));
+	UpdateTriggerTable();
 }
 
 ChatTriggers::~ChatTriggers()
@@ -85,6 +101,19 @@ void ChatTriggers::SetChatTrigger(ChatTriggerType type, const char *value)
 	} else {
 		m_PubTrigger = filtered.get();
 	}
+	UpdateTriggerTable();
+}
+
+void ChatTriggers::UpdateTriggerTable()
+{
+	for (size_t i = 0; i < sizeof(m_TriggerType) / sizeof(m_TriggerType[0]); i++)
+		m_TriggerType[i] = ChatTrigger_None;
+
+	// Prefer the silent trigger in case of clashes.
+	for (const char *c = m_PubTrigger.c_str(); *c; c++)
+		m_TriggerType[(unsigned char)*c] = ChatTrigger_Public;
+	for (const char *c = m_PrivTrigger.c_str(); *c; c++)
+		m_TriggerType[(unsigned char)*c] = ChatTrigger_Private;
 }
 
 ConfigResult ChatTriggers::OnSourceModConfigChanged(const char *key,
@@ -118,6 +147,8 @@ void ChatTriggers::OnSourceModAllInitialized()
 	m_pDidFloodBlock = forwardsys->CreateForward("OnClientFloodResult", ET_Event, 2, NULL, Param_Cell, Param_Cell);
 	m_pOnClientSayCmd = forwardsys->CreateForward("OnClientSayCommand", ET_Event, 3, NULL, Param_Cell, Param_String, Param_String);
 	m_pOnClientSayCmd_Post = forwardsys->CreateForward("OnClientSayCommand_Post", ET_Ignore, 3, NULL, Param_Cell, Param_String, Param_String);
+
+	rootmenu->AddRootConsoleCommand3("chat", "Chat trigger statistics", this);
 }
 
 void ChatTriggers::OnSourceModAllInitialized_Post()
@@ -163,7 +194,9 @@ void ChatTriggers::OnSourceModGameInitialized()
 
 void ChatTriggers::OnSourceModShutdown()
 {
+	rootmenu->RemoveRootConsoleCommand("chat", this);
 	hooks_.clear();
+	m_TriggerCache.clear();
 
 	forwardsys->ReleaseForward(m_pShouldFloodBlock);
 	forwardsys->ReleaseForward(m_pDidFloodBlock);
@@ -182,6 +215,8 @@ bool ChatTriggers::OnSayCommand_Pre(int client, const ICommandArgs *command)
 	if (!args)
 		return false;
 
+	Clock::time_point start = Clock::now();
+
 	/* Save these off for post hook as the command data returned from the engine in older engine versions
 	 * can be NULL, despite the data still being there and valid. */
 	m_Arg0Backup = command->Arg(0);
@@ -226,9 +261,9 @@ bool ChatTriggers::OnSayCommand_Pre(int client, const ICommandArgs *command)
 	 * This results in having a double-quoted message passed to the OnClientSayCommand ("message") forward,
 	 * but losing the last quote in the OnClientSayCommand_Post ("message) forward.
 	 * To compensate this, we copy the args into our own buffer where the engine won't mess with
-	 * and strip the quotes. */
-	delete [] m_ArgSBackup;
-	m_ArgSBackup = new char[CCommand::MaxCommandLength()+1];
+	 * and strip the quotes. The buffer is sized for the longest command, so it is only allocated once. */
+	if (!m_ArgSBackup)
+		m_ArgSBackup = new char[CCommand::MaxCommandLength()+1];
 	memcpy(m_ArgSBackup, args, len+1);
 
 	/* Strip the quotes from the argument */
@@ -240,6 +275,8 @@ bool ChatTriggers::OnSayCommand_Pre(int client, const ICommandArgs *command)
 		}
 	}
 
+	RecordStage(ChatStage_Parse, start);
+
 	/* The server console cannot do this */
 	if (client == 0)
 	{
@@ -273,16 +310,11 @@ bool ChatTriggers::OnSayCommand_Pre(int client, const ICommandArgs *command)
 		return true;
 	}
 
-	bool is_trigger = false;
-	bool is_silent = false;
+	start = Clock::now();
 
-	// Prefer the silent trigger in case of clashes.
-	if (strchr(m_PrivTrigger.c_str(), m_ArgSBackup[0])) {
-		is_trigger = true;
-		is_silent = true;
-	} else if (strchr(m_PubTrigger.c_str(), m_ArgSBackup[0])) {
-		is_trigger = true;
-	}
+	ChatTriggerType type = m_TriggerType[(unsigned char)m_ArgSBackup[0]];
+	bool is_trigger = (type != ChatTrigger_None);
+	bool is_silent = (type == ChatTrigger_Private);
 
 	if (is_trigger) {
 		// Bump the args past the chat trigger - we only support single-character triggers now.
@@ -302,6 +334,8 @@ bool ChatTriggers::OnSayCommand_Pre(int client, const ICommandArgs *command)
 		m_bWillProcessInPost = true;
 	}
 
+	RecordStage(ChatStage_Lookup, start);
+
 	if (is_silent && (m_bIsChatTrigger || (g_bSupressSilentFails && pPlayer->GetAdminId() != INVALID_ADMIN_ID)))
 		return true;
 
@@ -320,17 +354,21 @@ bool ChatTriggers::OnSayCommand_Post(int client, const ICommandArgs *command)
 		m_bWillProcessInPost = false;
 
 		/* Execute the cached command */
+		Clock::time_point start = Clock::now();
 		unsigned int old = SetReplyTo(SM_REPLY_CHAT);
 		serverpluginhelpers->ClientCommand(PEntityOfEntIndex(client), m_ToExecute);
 		SetReplyTo(old);
+		RecordStage(ChatStage_Execute, start);
 	}
 
 	if (!m_bPluginIgnored && m_pOnClientSayCmd_Post->GetFunctionCount() != 0)
 	{
+		Clock::time_point start = Clock::now();
 		m_pOnClientSayCmd_Post->PushCell(client);
 		m_pOnClientSayCmd_Post->PushString(m_Arg0Backup);
 		m_pOnClientSayCmd_Post->PushString(m_ArgSBackup);
 		m_pOnClientSayCmd_Post->Execute(NULL);
+		RecordStage(ChatStage_PostForward, start);
 	}
 
 	m_bIsChatTrigger = false;
@@ -358,34 +396,35 @@ bool ChatTriggers::PreProcessTrigger(edict_t *pEdict, const char *args)
 		return false;
 	}
 
-	/* See if we have this registered */
-	bool prepended = false;
-	if (!g_ConCmds.LookForSourceModCommand(cmd_buf))
+	/* See if we have this registered. Command lookups lowercase the name to hash
+	 * it, so remember what each trigger word resolved to until commands change.
+	 */
+	if (m_TriggerCacheGen != g_ConCmds.GetGeneration()
+		|| m_TriggerCache.elements() >= kMaxCachedTriggers)
 	{
-		/* Check if we had an "sm_" prefix */
-		if (strncasecmp(cmd_buf, "sm_", 3) == 0)
-		{
-			return false;
-		}
-
-		/* Now, prepend.  Don't worry about the buffers.  This will
-		 * work because the sizes are limited from earlier.
-		 */
-		char new_buf[80];
-		strcpy(new_buf, "sm_");
-		ke::SafeStrcpy(&new_buf[3], sizeof(new_buf)-3, cmd_buf);
+		m_TriggerCache.clear();
+		m_TriggerCacheGen = g_ConCmds.GetGeneration();
+	}
 
-		/* Recheck */
-		if (!g_ConCmds.LookForSourceModCommand(new_buf))
-		{
-			return false;
-		}
+	TriggerCommand trigger;
+	TriggerCommand *cached;
+	if (m_TriggerCache.retrieve(cmd_buf, &cached))
+	{
+		trigger = *cached;
+	}
+	else
+	{
+		trigger = ResolveTrigger(cmd_buf);
+		m_TriggerCache.insert(cmd_buf, trigger);
+	}
 
-		prepended = true;
+	if (!trigger.info)
+	{
+		return false;
 	}
 
 	/* See if we need to do extra string manipulation */
-	if (prepended)
+	if (trigger.prepended)
 	{
 		ke::SafeSprintf(m_ToExecute, sizeof(m_ToExecute), "sm_%s", args);
 	} else {
@@ -395,15 +434,43 @@ bool ChatTriggers::PreProcessTrigger(edict_t *pEdict, const char *args)
 	return true;
 }
 
+ChatTriggers::TriggerCommand ChatTriggers::ResolveTrigger(const char *cmd)
+{
+	TriggerCommand trigger;
+	trigger.info = g_ConCmds.FindSourceModCommand(cmd);
+	trigger.prepended = false;
+
+	/* Check if we had an "sm_" prefix */
+	if (trigger.info || strncasecmp(cmd, "sm_", 3) == 0)
+	{
+		return trigger;
+	}
+
+	/* Now, prepend.  Don't worry about the buffers.  This will
+	 * work because the sizes are limited from earlier.
+	 */
+	char new_buf[80];
+	strcpy(new_buf, "sm_");
+	ke::SafeStrcpy(&new_buf[3], sizeof(new_buf)-3, cmd);
+
+	/* Recheck */
+	trigger.info = g_ConCmds.FindSourceModCommand(new_buf);
+	trigger.prepended = (trigger.info != NULL);
+
+	return trigger;
+}
+
 cell_t ChatTriggers::CallOnClientSayCommand(int client)
 {
 	cell_t res = Pl_Continue;
 	if (m_pOnClientSayCmd->GetFunctionCount() != 0)
 	{
+		Clock::time_point start = Clock::now();
 		m_pOnClientSayCmd->PushCell(client);
 		m_pOnClientSayCmd->PushString(m_Arg0Backup);
 		m_pOnClientSayCmd->PushString(m_ArgSBackup);
 		m_pOnClientSayCmd->Execute(&res);
+		RecordStage(ChatStage_Forward, start);
 	}
 
 	m_bPluginIgnored = (res >= Pl_Stop);
@@ -433,6 +500,7 @@ bool ChatTriggers::IsChatTrigger()
 bool ChatTriggers::ClientIsFlooding(int client)
 {
 	bool is_flooding = false;
+	Clock::time_point start = Clock::now();
 
 	if (m_pShouldFloodBlock->GetFunctionCount() != 0)
 	{
@@ -454,9 +522,54 @@ bool ChatTriggers::ClientIsFlooding(int client)
 		m_pDidFloodBlock->Execute(NULL);
 	}
 
+	RecordStage(ChatStage_Flood, start);
 	return is_flooding;
 }
 
+void ChatTriggers::RecordStage(ChatStage stage, Clock::time_point start)
+{
+	double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+	StageStats &stats = m_Stages[stage];
+	stats.calls++;
+	stats.total_us += us;
+	if (us > stats.max_us)
+		stats.max_us = us;
+}
+
+void ChatTriggers::OnRootConsoleCommand(const char *cmdname, const ICommandArgs *command)
+{
+	if (command->ArgC() >= 3 && strcmp(command->Arg(2), "reset") == 0)
+	{
+		memset(m_Stages, 0, sizeof(m_Stages));
+		rootmenu->ConsolePrint("[SM] Chat statistics have been reset.");
+		return;
+	}
+
+	if (command->ArgC() < 3 || strcmp(command->Arg(2), "stats") != 0)
+	{
+		rootmenu->ConsolePrint("SourceMod Chat Menu:");
+		rootmenu->DrawGenericOption("stats", "Show time spent in each stage of say processing");
+		rootmenu->DrawGenericOption("reset", "Reset the statistics");
+		return;
+	}
+
+	rootmenu->ConsolePrint("[SM] Say processing times:");
+	rootmenu->ConsolePrint("  %-15s %-10s %-10s %-10s %s", "Stage", "Calls", "Avg (us)", "Max (us)", "Total (ms)");
+	for (int i = 0; i < ChatStage_Count; i++)
+	{
+		const StageStats &stats = m_Stages[i];
+		double avg = stats.calls ? stats.total_us / stats.calls : 0.0;
+		rootmenu->ConsolePrint("  %-15s %-10llu %-10.2f %-10.2f %.3f",
+			s_StageNames[i],
+			(unsigned long long)stats.calls,
+			avg,
+			stats.max_us,
+			stats.total_us / 1000.0);
+	}
+	rootmenu->ConsolePrint("  %u trigger word(s) cached", (unsigned int)m_TriggerCache.elements());
+}
+
 bool ChatTriggers::WasFloodedMessage()
 {
 	return m_bWasFloodedMessage;
@@ -38,9 +38,16 @@
 #include <IGameHelpers.h>
 #include <compat_wrappers.h>
 #include <IForwardSys.h>
+#include <IRootConsoleMenu.h>
+#include <sm_hashmap.h>
 #include <amtl/am-string.h>
+#include <chrono>
 
-class ChatTriggers : public SMGlobalClass
+struct ConCmdInfo;
+
+class ChatTriggers :
+	public SMGlobalClass,
+	public IRootConsoleCommand
 {
 public:
 	ChatTriggers();
@@ -55,6 +62,8 @@ public: //SMGlobalClass
 		ConfigSource source,
 		char *error,
 		size_t maxlength);
+public: //IRootConsoleCommand
+	void OnRootConsoleCommand(const char *cmdname, const ICommandArgs *command) override;
 private: //ConCommand
 	bool OnSayCommand_Pre(int client, const ICommandArgs *args);
 	bool OnSayCommand_Post(int client, const ICommandArgs *args);
@@ -69,11 +78,35 @@ private:
 	enum ChatTriggerType {
 		ChatTrigger_Public,
 		ChatTrigger_Private,
+		ChatTrigger_None,
+	};
+	enum ChatStage {
+		ChatStage_Parse,
+		ChatStage_Flood,
+		ChatStage_Lookup,
+		ChatStage_Forward,
+		ChatStage_Execute,
+		ChatStage_PostForward,
+
+		ChatStage_Count
+	};
+	struct StageStats {
+		uint64_t calls;
+		double total_us;
+		double max_us;
+	};
+	struct TriggerCommand {
+		ConCmdInfo *info;	/**< NULL if the word is not a SourceMod command */
+		bool prepended;		/**< Matched after prepending "sm_" */
 	};
+	typedef std::chrono::steady_clock Clock;
 	void SetChatTrigger(ChatTriggerType type, const char *value);
+	void UpdateTriggerTable();
 	bool PreProcessTrigger(edict_t *pEdict, const char *args);
+	TriggerCommand ResolveTrigger(const char *cmd);
 	bool ClientIsFlooding(int client);
 	cell_t CallOnClientSayCommand(int client);
+	void RecordStage(ChatStage stage, Clock::time_point start);
 private:
 	std::vector<ke::RefPtr<CommandHook>> hooks_;
 	std::string m_PubTrigger;
@@ -84,6 +117,10 @@ private:
 	bool m_bPluginIgnored;
 	unsigned int m_ReplyTo;
 	char m_ToExecute[300];
+	ChatTriggerType m_TriggerType[256];
+	StringHashMap<TriggerCommand> m_TriggerCache;
+	unsigned int m_TriggerCacheGen;
+	StageStats m_Stages[ChatStage_Count];
 	const char *m_Arg0Backup;
 	char *m_ArgSBackup;
 	IForward *m_pShouldFloodBlock;
@@ -48,7 +48,7 @@ ConCmdManager g_ConCmds;
 typedef std::list<CmdHook *> PluginHookList;
 void RegisterInPlugin(CmdHook *hook);
 
-ConCmdManager::ConCmdManager()
+ConCmdManager::ConCmdManager() : m_Generation(0)
 {
 }
 
@@ -134,6 +134,7 @@ void ConCmdManager::OnPluginDestroyed(IPlugin *plugin)
 	}
 
 	delete pList;
+	m_Generation++;
 }
 
 void CommandCallback(DISPATCH_ARGS)
@@ -362,6 +363,7 @@ bool ConCmdManager::AddAdminCommand(IPluginFunction *pFunction,
 	cmdgroup->hooks.push_back(pHook);
 	pInfo->hooks.append(pHook);
 	RegisterInPlugin(pHook);
+	m_Generation++;
 	return true;
 }
 
@@ -381,6 +383,7 @@ bool ConCmdManager::AddServerCommand(IPluginFunction *pFunction,
 
 	pInfo->hooks.append(pHook);
 	RegisterInPlugin(pHook);
+	m_Generation++;
 	return true;
 }
 
@@ -487,6 +490,7 @@ void ConCmdManager::RemoveConCmd(ConCmdInfo *info, const char *name, bool untrac
 {
 	/* Remove from the trie */
 	m_Cmds.remove(name);
+	m_Generation++;
 
 	/* Remove console-specific information
 	 * This should always be true as of right now
@@ -518,12 +522,20 @@ void ConCmdManager::RemoveConCmd(ConCmdInfo *info, const char *name, bool untrac
 }
 
 bool ConCmdManager::LookForSourceModCommand(const char *cmd)
+{
+	return FindSourceModCommand(cmd) != NULL;
+}
+
+ConCmdInfo *ConCmdManager::FindSourceModCommand(const char *cmd)
 {
 	ConCmdInfo *pInfo;
 	if (!m_Cmds.retrieve(cmd, &pInfo))
-		return false;
+		return NULL;
 
-	return pInfo->sourceMod && !pInfo->hooks.empty();
+	if (!pInfo->sourceMod || pInfo->hooks.empty())
+		return NULL;
+
+	return pInfo;
 }
 
 bool ConCmdManager::LookForCommandAdminFlags(const char *cmd, FlagBits *pFlags)
@@ -633,4 +645,10 @@ void ConCmdManager::OnRootConsoleCommand(const char *cmdname, const ICommandArgs
 	}
 
 	UTIL_ConsolePrint("[SM] Usage: sm cmds <plugin #>");
+
+	uint64_t hits, misses, flushes;
+	size_t commands;
+	logicore.GetAdminAccessCacheStats(&hits, &misses, &flushes, &commands);
+	UTIL_ConsolePrint("[SM] Admin access cache: %llu hits, %llu misses, %llu flushes, %u commands cached",
+		(unsigned long long)hits, (unsigned long long)misses, (unsigned long long)flushes, (unsigned int)commands);
 }
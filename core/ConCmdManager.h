@@ -170,6 +170,7 @@ public:
 	ResultType DispatchClientCommand(int client, const char *cmd, int args, ResultType type);
 	void UpdateAdminCmdFlags(const char *cmd, OverrideType type, FlagBits bits, bool remove);
 	bool LookForSourceModCommand(const char *cmd);
+	ConCmdInfo *FindSourceModCommand(const char *cmd);
 	bool LookForCommandAdminFlags(const char *cmd, FlagBits *pFlags);
 private:
 	bool InternalDispatch(int client, const ICommandArgs *args);
@@ -184,12 +185,19 @@ public:
 	{
 		return m_CmdList;
 	}
+
+	/* Changes whenever a command or command hook is added or removed. */
+	inline unsigned int GetGeneration() const
+	{
+		return m_Generation;
+	}
 private:
 	typedef StringHashMap<ke::RefPtr<CommandGroup> > GroupMap;
 
 	NameHashSet<ConCmdInfo *, ConCmdInfo::ConCmdPolicy> m_Cmds; /* command lookup */
 	GroupMap m_CmdGrps;				/* command group map */
 	ConCmdList m_CmdList;			/* command list */
+	unsigned int m_Generation;		/* bumped on any command change */
 };
 
 extern ConCmdManager g_ConCmds;
@@ -551,11 +551,17 @@ void CHalfLife2::SetEdictStateChanged(edict_t *pEdict, unsigned short offset)
 }
 
 bool CHalfLife2::TextMsg(int client, int dest, const char *msg)
+{
+	cell_t players[] = {client};
+
+	return TextMsg(players, 1, dest, msg);
+}
+
+bool CHalfLife2::TextMsg(cell_t *players, int count, int dest, const char *msg)
 {
 #ifndef USE_PROTOBUF_USERMESSAGES
 	bf_write *pBitBuf = NULL;
 #endif
-	cell_t players[] = {client};
 
 	if (dest == HUD_PRINTTALK)
 	{
@@ -569,7 +575,7 @@ bool CHalfLife2::TextMsg(int client, int dest, const char *msg)
 
 #if SOURCE_ENGINE == SE_CSGO || SOURCE_ENGINE == SE_BLADE || SOURCE_ENGINE == SE_MCV
 			CCSUsrMsg_SayText *pMsg;
-			if ((pMsg = (CCSUsrMsg_SayText *)g_UserMsgs.StartProtobufMessage(m_SayTextMsg, players, 1, USERMSG_RELIABLE)) == NULL)
+			if ((pMsg = (CCSUsrMsg_SayText *)g_UserMsgs.StartProtobufMessage(m_SayTextMsg, players, count, USERMSG_RELIABLE)) == NULL)
 			{
 				return false;
 			}
@@ -578,7 +584,7 @@ bool CHalfLife2::TextMsg(int client, int dest, const char *msg)
 			pMsg->set_text(buffer);
 			pMsg->set_chat(false);
 #else
-			if ((pBitBuf = g_UserMsgs.StartBitBufMessage(m_SayTextMsg, players, 1, USERMSG_RELIABLE)) == NULL)
+			if ((pBitBuf = g_UserMsgs.StartBitBufMessage(m_SayTextMsg, players, count, USERMSG_RELIABLE)) == NULL)
 			{
 				return false;
 			}
@@ -596,7 +602,7 @@ bool CHalfLife2::TextMsg(int client, int dest, const char *msg)
 
 #if SOURCE_ENGINE == SE_CSGO || SOURCE_ENGINE == SE_BLADE || SOURCE_ENGINE == SE_MCV
 	CCSUsrMsg_TextMsg *pMsg;
-	if ((pMsg = (CCSUsrMsg_TextMsg *)g_UserMsgs.StartProtobufMessage(m_MsgTextMsg, players, 1, USERMSG_RELIABLE)) == NULL)
+	if ((pMsg = (CCSUsrMsg_TextMsg *)g_UserMsgs.StartProtobufMessage(m_MsgTextMsg, players, count, USERMSG_RELIABLE)) == NULL)
 	{
 		return false;
 	}
@@ -609,7 +615,7 @@ bool CHalfLife2::TextMsg(int client, int dest, const char *msg)
 	pMsg->add_params("");
 	pMsg->add_params("");
 #else
-	if ((pBitBuf = g_UserMsgs.StartBitBufMessage(m_MsgTextMsg, players, 1, USERMSG_RELIABLE)) == NULL)
+	if ((pBitBuf = g_UserMsgs.StartBitBufMessage(m_MsgTextMsg, players, count, USERMSG_RELIABLE)) == NULL)
 	{
 		return false;
 	}
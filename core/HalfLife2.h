@@ -226,6 +226,7 @@ public: //IGameHelpers
 	bool FindDataMapInfo(datamap_t *pMap, const char *offset, sm_datatable_info_t *pDataTable);
 	void SetEdictStateChanged(edict_t *pEdict, unsigned short offset);
 	bool TextMsg(int client, int dest, const char *msg);
+	bool TextMsg(cell_t *players, int count, int dest, const char *msg);
 	bool HintTextMsg(int client, const char *msg);
 	bool HintTextMsg(cell_t *players, int count, const char *msg);
 	bool ShowVGUIMenu(int client, const char *name, KeyValues *data, bool show);
@@ -93,6 +93,14 @@ public:
 	SMProtobufMessage( protobuf::Message *message )
 	{
 		msg = message;
+		templateId = INVALID_MESSAGE_ID;
+	}
+
+	// Templates own their message, which lives until the handle is closed.
+	SMProtobufMessage( protobuf::Message *message, int msg_id )
+	{
+		msg = message;
+		templateId = msg_id;
 	}
 
 	~SMProtobufMessage()
@@ -106,6 +114,21 @@ public:
 			handlesys->FreeHandle(hndl, &sec);
 			iter = childHandles.erase(iter);
 		}
+
+		if (templateId != INVALID_MESSAGE_ID)
+		{
+			delete msg;
+		}
+	}
+
+	inline bool IsTemplate() const
+	{
+		return templateId != INVALID_MESSAGE_ID;
+	}
+
+	inline int GetTemplateId() const
+	{
+		return templateId;
 	}
 
 	inline void AddChildHandle(Handle_t hndl)
@@ -1183,9 +1206,131 @@ public:
 		return true;
 	}
 
+	// Bulk versions of the repeated field accessors. The field is looked up
+	// once for the whole array, and nothing is added unless every value is valid.
+	inline bool AddInt32OrUnsignedOrEnumArray(const char *pszFieldName, const int32 *values, int count)
+	{
+		GETCHECK_FIELD();
+		CHECK_FIELD_TYPE3(INT32, UINT32, ENUM);
+		CHECK_FIELD_REPEATED();
+
+		const protobuf::Reflection *pReflection = msg->GetReflection();
+		if (fieldType == protobuf::FieldDescriptor::CPPTYPE_UINT32)
+		{
+			for (int i = 0; i < count; i++)
+				pReflection->AddUInt32(msg, field, (uint32)values[i]);
+		}
+		else if (fieldType == protobuf::FieldDescriptor::CPPTYPE_INT32)
+		{
+			for (int i = 0; i < count; i++)
+				pReflection->AddInt32(msg, field, values[i]);
+		}
+		else // CPPTYPE_ENUM
+		{
+			const protobuf::EnumDescriptor *pEnum = field->enum_type();
+			for (int i = 0; i < count; i++)
+			{
+				if (!pEnum->FindValueByNumber(values[i]))
+					return false;
+			}
+
+			for (int i = 0; i < count; i++)
+				pReflection->AddEnum(msg, field, pEnum->FindValueByNumber(values[i]));
+		}
+
+		return true;
+	}
+
+	inline bool AddFloatOrDoubleArray(const char *pszFieldName, const float *values, int count)
+	{
+		GETCHECK_FIELD();
+		CHECK_FIELD_TYPE2(FLOAT, DOUBLE);
+		CHECK_FIELD_REPEATED();
+
+		const protobuf::Reflection *pReflection = msg->GetReflection();
+		if (fieldType == protobuf::FieldDescriptor::CPPTYPE_DOUBLE)
+		{
+			for (int i = 0; i < count; i++)
+				pReflection->AddDouble(msg, field, (double)values[i]);
+		}
+		else
+		{
+			for (int i = 0; i < count; i++)
+				pReflection->AddFloat(msg, field, values[i]);
+		}
+
+		return true;
+	}
+
+	inline bool AddStringArray(const char *pszFieldName, const char * const *values, int count)
+	{
+		GETCHECK_FIELD();
+		CHECK_FIELD_TYPE(STRING);
+		CHECK_FIELD_REPEATED();
+
+		const protobuf::Reflection *pReflection = msg->GetReflection();
+		for (int i = 0; i < count; i++)
+			pReflection->AddString(msg, field, values[i]);
+
+		return true;
+	}
+
+	// Copies up to maxvalues elements, beginning at start, and stores how many
+	// were copied in *copied. start may equal the element count.
+	inline bool GetRepeatedInt32OrUnsignedOrEnumArray(const char *pszFieldName, int start, int32 *out, int maxvalues, int *copied)
+	{
+		GETCHECK_FIELD();
+		CHECK_FIELD_TYPE3(INT32, UINT32, ENUM);
+		CHECK_FIELD_REPEATED();
+
+		const protobuf::Reflection *pReflection = msg->GetReflection();
+		int elemCount = pReflection->FieldSize(*msg, field);
+		if (start < 0 || start > elemCount)
+			return false;
+
+		int num = elemCount - start < maxvalues ? elemCount - start : maxvalues;
+		for (int i = 0; i < num; i++)
+		{
+			if (fieldType == protobuf::FieldDescriptor::CPPTYPE_UINT32)
+				out[i] = (int32)pReflection->GetRepeatedUInt32(*msg, field, start + i);
+			else if (fieldType == protobuf::FieldDescriptor::CPPTYPE_INT32)
+				out[i] = pReflection->GetRepeatedInt32(*msg, field, start + i);
+			else // CPPTYPE_ENUM
+				out[i] = pReflection->GetRepeatedEnum(*msg, field, start + i)->number();
+		}
+
+		*copied = num;
+		return true;
+	}
+
+	inline bool GetRepeatedFloatOrDoubleArray(const char *pszFieldName, int start, float *out, int maxvalues, int *copied)
+	{
+		GETCHECK_FIELD();
+		CHECK_FIELD_TYPE2(FLOAT, DOUBLE);
+		CHECK_FIELD_REPEATED();
+
+		const protobuf::Reflection *pReflection = msg->GetReflection();
+		int elemCount = pReflection->FieldSize(*msg, field);
+		if (start < 0 || start > elemCount)
+			return false;
+
+		int num = elemCount - start < maxvalues ? elemCount - start : maxvalues;
+		for (int i = 0; i < num; i++)
+		{
+			if (fieldType == protobuf::FieldDescriptor::CPPTYPE_DOUBLE)
+				out[i] = (float)pReflection->GetRepeatedDouble(*msg, field, start + i);
+			else
+				out[i] = pReflection->GetRepeatedFloat(*msg, field, start + i);
+		}
+
+		*copied = num;
+		return true;
+	}
+
 private:
 	protobuf::Message *msg;
 	PBHandleList childHandles;
+	int templateId;
 };
 
 #endif // _INCLUDE_SOURCEMOD_SMPBMESSAGE_H_
@@ -44,6 +44,13 @@
 
 UserMessages g_UserMsgs;
 
+#ifdef USE_PROTOBUF_USERMESSAGES
+/* Cleared messages kept per message id. Only one message is built at a time,
+ * plus the intercept and hook copies, so a few are enough.
+ */
+static const size_t kMaxPooledMessages = 4;
+#endif
+
 #if SOURCE_ENGINE == SE_CSGO || SOURCE_ENGINE == SE_BLADE || SOURCE_ENGINE == SE_MCV
 SH_DECL_HOOK3_void(IVEngineServer, SendUserMessage, SH_NOATTRIB, 0, IRecipientFilter &, int, const protobuf::Message &);
 #else
@@ -68,6 +75,9 @@ UserMessages::UserMessages()
 	m_InHook = false;
 	m_CurFlags = 0;
 	m_CurId = INVALID_MESSAGE_ID;
+#ifdef USE_PROTOBUF_USERMESSAGES
+	m_InterceptId = INVALID_MESSAGE_ID;
+#endif
 }
 
 UserMessages::~UserMessages()
@@ -108,6 +118,23 @@ void UserMessages::OnSourceModAllShutdown()
 #endif
 	}
 	m_HookCount = 0;
+
+#ifdef USE_PROTOBUF_USERMESSAGES
+	if (m_InterceptBuffer)
+	{
+		delete m_InterceptBuffer;
+		m_InterceptBuffer = NULL;
+	}
+
+	for (size_t i = 0; i < 255; i++)
+	{
+		for (size_t j = 0; j < m_MessagePool[i].size(); j++)
+		{
+			delete m_MessagePool[i][j];
+		}
+		m_MessagePool[i].clear();
+	}
+#endif
 }
 
 int UserMessages::GetMessageIndex(const char *msg)
@@ -268,7 +295,7 @@ google::protobuf::Message *UserMessages::StartProtobufMessage(int msg_id, const
 	if (m_CurFlags & USERMSG_BLOCKHOOKS)
 	{
 		// direct message creation, return buffer "from engine". keep track
-		m_FakeEngineBuffer = GetMessagePrototype(msg_id)->New();
+		m_FakeEngineBuffer = AcquireMessage(msg_id);
 		buffer = m_FakeEngineBuffer;
 	} else {
 		char messageName[32];
@@ -283,12 +310,12 @@ google::protobuf::Message *UserMessages::StartProtobufMessage(int msg_id, const
 		{
 		case MRES_IGNORED:
 		case MRES_HANDLED:
-			m_FakeEngineBuffer = GetMessagePrototype(msg_id)->New();
+			m_FakeEngineBuffer = AcquireMessage(msg_id);
 			buffer = m_FakeEngineBuffer;
 			break;		
 
 		case MRES_OVERRIDE:
-			m_FakeEngineBuffer = GetMessagePrototype(msg_id)->New();
+			m_FakeEngineBuffer = AcquireMessage(msg_id);
 		// fallthrough
 		case MRES_SUPERCEDE:
 			buffer = msg;
@@ -313,7 +340,7 @@ bool UserMessages::EndMessage()
 	if (m_CurFlags & USERMSG_BLOCKHOOKS)
 	{
 		ENGINE_CALL(SendUserMessage)(static_cast<IRecipientFilter &>(m_CellRecFilter), m_CurId, *m_FakeEngineBuffer);
-		delete m_FakeEngineBuffer;
+		ReleaseMessage(m_CurId, m_FakeEngineBuffer);
 		m_FakeEngineBuffer = NULL;
 	} else {
 		OnMessageEnd_Pre();
@@ -324,7 +351,7 @@ bool UserMessages::EndMessage()
 		case MRES_HANDLED:
 		case MRES_OVERRIDE:
 			engine->SendUserMessage(static_cast<IRecipientFilter &>(m_CellRecFilter), m_CurId, *m_FakeEngineBuffer);
-			delete m_FakeEngineBuffer;
+			ReleaseMessage(m_CurId, m_FakeEngineBuffer);
 			m_FakeEngineBuffer = NULL;
 			break;
 		//case MRES_SUPERCEDE:
@@ -348,6 +375,81 @@ bool UserMessages::EndMessage()
 	return true;
 }
 
+#ifdef USE_PROTOBUF_USERMESSAGES
+protobuf::Message *UserMessages::NewProtobufMessage(int msg_id)
+{
+	if (msg_id < 0 || msg_id >= 255)
+	{
+		return NULL;
+	}
+
+	const protobuf::Message *prototype = GetMessagePrototype(msg_id);
+	if (!prototype)
+	{
+		return NULL;
+	}
+
+	return prototype->New();
+}
+
+bool UserMessages::SendProtobufMessage(int msg_id, const protobuf::Message &msg, const cell_t players[], unsigned int playersNum, int flags)
+{
+	if (m_InExec || m_InHook)
+	{
+		return false;
+	}
+	if (msg_id < 0 || msg_id >= 255)
+	{
+		return false;
+	}
+
+	/* Hooks may rewrite the message, so they get a pooled copy instead. */
+	if (!(flags & USERMSG_BLOCKHOOKS)
+		&& (!m_msgHooks[msg_id].empty() || !m_msgIntercepts[msg_id].empty()))
+	{
+		protobuf::Message *buffer = StartProtobufMessage(msg_id, players, playersNum, flags);
+		if (!buffer)
+		{
+			return false;
+		}
+
+		buffer->CopyFrom(msg);
+		return EndMessage();
+	}
+
+	m_CurId = msg_id;
+	m_CellRecFilter.Initialize(players, playersNum);
+
+	m_CurFlags = flags;
+	if (m_CurFlags & USERMSG_INITMSG)
+	{
+		m_CellRecFilter.SetToInit(true);
+	}
+	if (m_CurFlags & USERMSG_RELIABLE)
+	{
+		m_CellRecFilter.SetToReliable(true);
+	}
+
+	m_InExec = true;
+
+	if (m_CurFlags & USERMSG_BLOCKHOOKS)
+	{
+		ENGINE_CALL(SendUserMessage)(static_cast<IRecipientFilter &>(m_CellRecFilter), msg_id, msg);
+	} else {
+		engine->SendUserMessage(static_cast<IRecipientFilter &>(m_CellRecFilter), msg_id, msg);
+	}
+
+	/* Our engine hook points this at the message it saw; don't keep it. */
+	m_FakeEngineBuffer = NULL;
+
+	m_InExec = false;
+	m_CurFlags = 0;
+	m_CellRecFilter.Reset();
+
+	return true;
+}
+#endif
+
 UserMessageType UserMessages::GetUserMessageType() const
 {
 #ifdef USE_PROTOBUF_USERMESSAGES
@@ -456,6 +558,34 @@ const protobuf::Message *UserMessages::GetMessagePrototype(int msg_type)
 	return g_VietnamUsermessageHelpers.GetPrototype(msg_type);
 #endif
 }
+
+protobuf::Message *UserMessages::AcquireMessage(int msg_type)
+{
+	std::vector<protobuf::Message *> &pool = m_MessagePool[msg_type];
+	if (pool.empty())
+	{
+		return GetMessagePrototype(msg_type)->New();
+	}
+
+	protobuf::Message *msg = pool.back();
+	pool.pop_back();
+	return msg;
+}
+
+void UserMessages::ReleaseMessage(int msg_type, protobuf::Message *msg)
+{
+	std::vector<protobuf::Message *> &pool = m_MessagePool[msg_type];
+	if (pool.size() >= kMaxPooledMessages)
+	{
+		delete msg;
+		return;
+	}
+
+	// Clear() keeps string and repeated field storage around, so filling the
+	// message in again mostly avoids allocating.
+	msg->Clear();
+	pool.push_back(msg);
+}
 #endif
 
 #ifdef USE_PROTOBUF_USERMESSAGES
@@ -599,8 +729,9 @@ bf_write *UserMessages::OnStartMessage_Pre(IRecipientFilter *filter, int msg_typ
 	{
 #ifdef USE_PROTOBUF_USERMESSAGES
 		if (m_InterceptBuffer)
-			delete m_InterceptBuffer;
-		m_InterceptBuffer = GetMessagePrototype(msg_type)->New();
+			ReleaseMessage(m_InterceptId, m_InterceptBuffer);
+		m_InterceptBuffer = AcquireMessage(msg_type);
+		m_InterceptId = msg_type;
 
 		UM_RETURN_META_VALUE(MRES_SUPERCEDE, m_InterceptBuffer);
 #else
@@ -794,11 +925,14 @@ void UserMessages::OnMessageEnd_Pre()
 
 	{
 #if SOURCE_ENGINE == SE_CSGO || SOURCE_ENGINE == SE_BLADE || SOURCE_ENGINE == SE_MCV
+		/* The original may be the game's own message, built against the game's
+		 * descriptors rather than ours, so copy it through the wire format.
+		 */
 		int size = m_OrigBuffer->ByteSize();
 		uint8 *data = (uint8 *)stackalloc(size);
 		m_OrigBuffer->SerializePartialToArray(data, size);
 
-		protobuf::Message *pTempMsg = GetMessagePrototype(m_CurId)->New();
+		protobuf::Message *pTempMsg = AcquireMessage(m_CurId);
 		pTempMsg->ParsePartialFromArray(data, size);
 #else
 		bf_write *pTempMsg = m_OrigBuffer;
@@ -824,7 +958,7 @@ void UserMessages::OnMessageEnd_Pre()
 		}
 
 #if SOURCE_ENGINE == SE_CSGO || SOURCE_ENGINE == SE_BLADE || SOURCE_ENGINE == SE_MCV
-		delete pTempMsg;
+		ReleaseMessage(m_CurId, pTempMsg);
 #endif
 	}
 
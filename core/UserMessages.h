@@ -52,6 +52,7 @@ using namespace SourceMod;
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <netmessages.pb.h>
+#include <vector>
 
 using namespace google;
 #else
@@ -102,6 +103,15 @@ public: //IUserMessages
 		bool intercept=false);
 	UserMessageType GetUserMessageType() const;
 public:
+#ifdef USE_PROTOBUF_USERMESSAGES
+	/* Creates a message that the caller owns, e.g. for a template. */
+	protobuf::Message *NewProtobufMessage(int msg_id);
+
+	/* Sends a prebuilt message without taking ownership. It is only copied
+	 * if a hook could modify it on the way out.
+	 */
+	bool SendProtobufMessage(int msg_id, const protobuf::Message &msg, const cell_t players[], unsigned int playersNum, int flags);
+#endif
 #if SOURCE_ENGINE == SE_CSGO || SOURCE_ENGINE == SE_BLADE || SOURCE_ENGINE == SE_MCV
 	void OnSendUserMessage_Pre(IRecipientFilter &filter, int msg_type, const protobuf::Message &msg);
 	void OnSendUserMessage_Post(IRecipientFilter &filter, int msg_type, const protobuf::Message &msg);
@@ -122,6 +132,8 @@ public:
 private:
 #ifdef USE_PROTOBUF_USERMESSAGES
 	const protobuf::Message *GetMessagePrototype(int msg_type);
+	protobuf::Message *AcquireMessage(int msg_type);
+	void ReleaseMessage(int msg_type, protobuf::Message *msg);
 	bool InternalHook(int msg_id, IProtobufUserMessageListener *pListener, bool intercept, bool isNew);
 	bool InternalUnhook(int msg_id, IProtobufUserMessageListener *pListener, bool intercept, bool isNew);
 #else
@@ -146,6 +158,10 @@ private:
 	META_RES m_FakeMetaRes;
 
 	protobuf::Message *m_InterceptBuffer;
+	int m_InterceptId;
+
+	// Cleared messages kept for reuse, per message id.
+	std::vector<protobuf::Message *> m_MessagePool[255];
 #endif
 	size_t m_HookCount;
 	bool m_InHook;
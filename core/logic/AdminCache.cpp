@@ -225,6 +225,11 @@ AdminCache::AdminCache()
 	m_FirstGroup = -1;
 	m_InvalidatingAdmins = false;
 	m_destroying = false;
+	m_AccessGeneration = 0;
+	m_AccessCacheGeneration = 0;
+	m_AccessHits = 0;
+	m_AccessMisses = 0;
+	m_AccessFlushes = 0;
 }
 
 AdminCache::~AdminCache()
@@ -394,6 +399,8 @@ void AdminCache::DumpCommandOverrideCache(OverrideType type)
 
 AdminId AdminCache::CreateAdmin(const char *name)
 {
+	InvalidateAccessCache();
+
 	AdminId id;
 	AdminUser *pUser;
 
@@ -709,6 +716,8 @@ GroupId AdminCache::GetGroupImmunity(GroupId id, unsigned int number)
 
 void AdminCache::AddGroupCommandOverride(GroupId id, const char *name, OverrideType type, OverrideRule rule)
 {
+	InvalidateAccessCache();
+
 	AdminGroup *pGroup = (AdminGroup *)m_pMemory->GetAddress(id);
 	if (!pGroup || pGroup->magic != GRP_MAGIC_SET)
 	{
@@ -775,6 +784,8 @@ AuthMethod *AdminCache::GetMethodByIndex(unsigned int index)
 
 bool AdminCache::InvalidateAdmin(AdminId id)
 {
+	InvalidateAccessCache();
+
 	AdminUser *pUser = (AdminUser *)m_pMemory->GetAddress(id);
 	AdminUser *pOther;
 	if (!pUser || pUser->magic != USR_MAGIC_SET)
@@ -832,6 +843,8 @@ bool AdminCache::InvalidateAdmin(AdminId id)
 
 void AdminCache::InvalidateGroup(GroupId id)
 {
+	InvalidateAccessCache();
+
 	AdminGroup *pGroup = (AdminGroup *)m_pMemory->GetAddress(id);
 	AdminGroup *pOther;
 
@@ -913,8 +926,58 @@ void AdminCache::InvalidateGroup(GroupId id)
 	}
 }
 
+int AdminCache::RefreshGroupMembers(GroupId gid)
+{
+	InvalidateAccessCache();
+
+	AdminGroup *pGroup = GetGroup(gid);
+	if (!pGroup)
+	{
+		return 0;
+	}
+
+	/* Effective flags and immunity are folded in when an admin inherits a
+	 * group, so changes to the group afterwards have to be pushed out.
+	 * Immunity can only be raised here, since the admin's own level is not
+	 * kept separately.
+	 */
+	int count = 0;
+	int idx = m_FirstUser;
+	while (idx != INVALID_ADMIN_ID)
+	{
+		AdminUser *pUser = (AdminUser *)m_pMemory->GetAddress(idx);
+		int *table = (pUser->grp_count > 0) ? (int *)m_pMemory->GetAddress(pUser->grp_table) : NULL;
+		for (unsigned int i=0; i<pUser->grp_count; i++)
+		{
+			if (table[i] != gid)
+			{
+				continue;
+			}
+
+			pUser->eflags = pUser->flags;
+			for (unsigned int j=0; j<pUser->grp_count; j++)
+			{
+				AdminGroup *pOther = (AdminGroup *)m_pMemory->GetAddress(table[j]);
+				pUser->eflags |= pOther->addflags;
+			}
+			if (pGroup->immunity_level > pUser->immunity_level)
+			{
+				pUser->immunity_level = pGroup->immunity_level;
+			}
+			pUser->serialchange++;
+			count++;
+			break;
+		}
+		idx = pUser->next_user;
+	}
+
+	return count;
+}
+
 void AdminCache::InvalidateGroupCache()
 {
+	InvalidateAccessCache();
+
 	/* Nuke the free list */
 	m_FreeGroupList = -1;
 
@@ -964,6 +1027,8 @@ void AdminCache::RegisterAuthIdentType(const char *name)
 
 void AdminCache::InvalidateAdminCache(bool unlink_admins)
 {
+	InvalidateAccessCache();
+
 	m_InvalidatingAdmins = true;
 	if (!m_destroying)
 	{
@@ -1172,6 +1237,87 @@ bool AdminCache::BindAdminIdentity(AdminId id, const char *auth, const char *ide
 	return method->identities.insert(ident, id);
 }
 
+bool AdminCache::RemoveAdminByIdentity(const char *auth, const char *ident)
+{
+	AdminId id = FindAdminByIdentity(auth, ident);
+	if (id == INVALID_ADMIN_ID)
+	{
+		return false;
+	}
+
+	/* Only clients bound to this admin lose it; see InvalidateAdmin(). */
+	return InvalidateAdmin(id);
+}
+
+int AdminCache::RecheckIdentity(const char *auth, const char *ident)
+{
+	if (!m_AuthTables.contains(auth))
+	{
+		return -1;
+	}
+
+	/* Core only binds these methods itself; see CPlayer::DoBasicAdminChecks().
+	 * Anything else is bound by whichever plugin registered the method.
+	 */
+	bool by_name = (strcmp(auth, "name") == 0);
+	bool by_ip = (strcmp(auth, "ip") == 0);
+	bool by_steam = (strcmp(auth, "steam") == 0);
+	if (!by_name && !by_ip && !by_steam)
+	{
+		return 0;
+	}
+
+	char steamIdent[16];
+	if (by_steam)
+	{
+		if (!GetUnifiedSteamIdentity(ident, steamIdent, sizeof(steamIdent)))
+		{
+			return 0;
+		}
+		ident = steamIdent;
+	}
+
+	size_t ident_len = strlen(ident);
+	int changed = 0;
+	int maxClients = playerhelpers->GetMaxClients();
+	for (int i = 1; i <= maxClients; i++)
+	{
+		IGamePlayer *player = playerhelpers->GetGamePlayer(i);
+		if (!player->IsInGame() || !player->IsAuthorized() || player->GetAdminId() != INVALID_ADMIN_ID)
+		{
+			continue;
+		}
+
+		bool matches = false;
+		if (by_name)
+		{
+			matches = (strcmp(player->GetName(), ident) == 0);
+		}
+		else if (by_ip)
+		{
+			/* The player's address may have a port on it. */
+			const char *addr = player->GetIPAddress();
+			matches = (strncmp(addr, ident, ident_len) == 0)
+				&& (addr[ident_len] == '\0' || addr[ident_len] == ':');
+		}
+		else
+		{
+			char playerIdent[16];
+			const char *authstr = player->GetAuthString(false);
+			matches = authstr
+				&& GetUnifiedSteamIdentity(authstr, playerIdent, sizeof(playerIdent))
+				&& strcmp(playerIdent, ident) == 0;
+		}
+
+		if (matches && player->RunAdminCacheChecks())
+		{
+			changed++;
+		}
+	}
+
+	return changed;
+}
+
 AdminId AdminCache::FindAdminByIdentity(const char *auth, const char *identity)
 {
 	AuthMethod *method;
@@ -1196,6 +1342,8 @@ AdminId AdminCache::FindAdminByIdentity(const char *auth, const char *identity)
 
 void AdminCache::SetAdminFlag(AdminId id, AdminFlag flag, bool enabled)
 {
+	InvalidateAccessCache();
+
 	AdminUser *pUser = (AdminUser *)m_pMemory->GetAddress(id);
 	if (!pUser || pUser->magic != USR_MAGIC_SET)
 	{
@@ -1273,6 +1421,8 @@ FlagBits AdminCache::GetAdminFlags(AdminId id, AccessMode mode)
 
 void AdminCache::SetAdminFlags(AdminId id, AccessMode mode, FlagBits bits)
 {
+	InvalidateAccessCache();
+
 	AdminUser *pUser = (AdminUser *)m_pMemory->GetAddress(id);
 	if (!pUser || pUser->magic != USR_MAGIC_SET)
 	{
@@ -1292,6 +1442,8 @@ void AdminCache::SetAdminFlags(AdminId id, AccessMode mode, FlagBits bits)
 
 bool AdminCache::AdminInheritGroup(AdminId id, GroupId gid)
 {
+	InvalidateAccessCache();
+
 	AdminUser *pUser = (AdminUser *)m_pMemory->GetAddress(id);
 	if (!pUser || pUser->magic != USR_MAGIC_SET)
 	{
@@ -2028,51 +2180,105 @@ bool AdminCache::CheckClientCommandAccess(int client, const char *cmd, FlagBits
 
 bool AdminCache::CheckAdminCommandAccess(AdminId adm, const char *cmd, FlagBits cmdflags)
 {
-	if (adm != INVALID_ADMIN_ID)
+	if (adm == INVALID_ADMIN_ID)
 	{
-		FlagBits bits = GetAdminFlags(adm, Access_Effective);
+		return false;
+	}
 
-		/* root knows all, WHOA */
-		if ((bits & ADMFLAG_ROOT) == ADMFLAG_ROOT)
+	/* Anything that could change the answer bumps the generation, so drop
+	 * everything lazily here rather than on each (possibly bulk) change.
+	 */
+	if (m_AccessCacheGeneration != m_AccessGeneration
+		|| m_AccessCache.elements() >= kMaxAccessCacheCommands)
+	{
+		if (m_AccessCache.elements())
 		{
-			return true;
+			m_AccessCache.clear();
+			m_AccessFlushes++;
 		}
+		m_AccessCacheGeneration = m_AccessGeneration;
+	}
 
-		/* Check for overrides
-		* :TODO: is it worth optimizing this?
-		*/
-		unsigned int groups = GetAdminGroupCount(adm);
-		GroupId gid;
-		OverrideRule rule;
-		bool override = false;
-		for (unsigned int i = 0; i<groups; i++)
+	AccessCacheMap::Insert i = m_AccessCache.findForAdd(cmd);
+	if (i.found())
+	{
+		std::vector<AccessCacheEntry> &entries = i->value;
+		for (size_t j = 0; j < entries.size(); j++)
 		{
-			gid = GetAdminGroup(adm, i, NULL);
-			/* First get group-level override */
-			override = GetGroupCommandOverride(gid, cmd, Override_CommandGroup, &rule);
-			/* Now get the specific command override */
-			if (GetGroupCommandOverride(gid, cmd, Override_Command, &rule))
-			{
-				override = true;
-			}
-			if (override)
+			if (entries[j].admin == adm && entries[j].cmdflags == cmdflags)
 			{
-				if (rule == Command_Allow)
-				{
-					return true;
-				}
-				else if (rule == Command_Deny)
-				{
-					return false;
-				}
+				m_AccessHits++;
+				return entries[j].allowed;
 			}
 		}
+	}
+	else if (!m_AccessCache.add(i, cmd))
+	{
+		return ResolveAdminCommandAccess(adm, cmd, cmdflags);
+	}
+
+	m_AccessMisses++;
+
+	AccessCacheEntry entry;
+	entry.admin = adm;
+	entry.cmdflags = cmdflags;
+	entry.allowed = ResolveAdminCommandAccess(adm, cmd, cmdflags);
+	i->value.push_back(entry);
+	return entry.allowed;
+}
+
+void AdminCache::GetAccessCacheStats(uint64_t *hits, uint64_t *misses, uint64_t *flushes, size_t *commands)
+{
+	*hits = m_AccessHits;
+	*misses = m_AccessMisses;
+	*flushes = m_AccessFlushes;
+	*commands = (m_AccessCacheGeneration == m_AccessGeneration) ? m_AccessCache.elements() : 0;
+}
+
+bool AdminCache::ResolveAdminCommandAccess(AdminId adm, const char *cmd, FlagBits cmdflags)
+{
+	FlagBits bits = GetAdminFlags(adm, Access_Effective);
+
+	/* root knows all, WHOA */
+	if ((bits & ADMFLAG_ROOT) == ADMFLAG_ROOT)
+	{
+		return true;
+	}
 
-		/* See if our other flags match */
-		if ((bits & cmdflags) == cmdflags)
+	/* Check for overrides
+	* :TODO: is it worth optimizing this?
+	*/
+	unsigned int groups = GetAdminGroupCount(adm);
+	GroupId gid;
+	OverrideRule rule;
+	bool override = false;
+	for (unsigned int i = 0; i<groups; i++)
+	{
+		gid = GetAdminGroup(adm, i, NULL);
+		/* First get group-level override */
+		override = GetGroupCommandOverride(gid, cmd, Override_CommandGroup, &rule);
+		/* Now get the specific command override */
+		if (GetGroupCommandOverride(gid, cmd, Override_Command, &rule))
 		{
-			return true;
+			override = true;
 		}
+		if (override)
+		{
+			if (rule == Command_Allow)
+			{
+				return true;
+			}
+			else if (rule == Command_Deny)
+			{
+				return false;
+			}
+		}
+	}
+
+	/* See if our other flags match */
+	if ((bits & cmdflags) == cmdflags)
+	{
+		return true;
 	}
 
 	return false;
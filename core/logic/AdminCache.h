@@ -41,6 +41,7 @@
 #include <IForwardSys.h>
 #include <sm_hashmap.h>
 #include <sm_namehashset.h>
+#include <vector>
 
 using namespace SourceHook;
 
@@ -51,6 +52,18 @@ using namespace SourceHook;
 
 typedef StringHashMap<OverrideRule> OverrideMap;
 
+/* Bounds the access decision cache; it is simply flushed when full. */
+static const size_t kMaxAccessCacheCommands = 1024;
+
+struct AccessCacheEntry
+{
+	AdminId admin;
+	FlagBits cmdflags;
+	bool allowed;
+};
+
+typedef StringHashMap<std::vector<AccessCacheEntry> > AccessCacheMap;
+
 struct AdminGroup
 {
 	uint32_t magic;					/* Magic flag, for memory validation (ugh) */
@@ -192,7 +205,17 @@ public:
 	AdminUser *GetUser(AdminId id);
 	const char *GetString(int idx);
 	bool CheckAdminCommandAccess(AdminId adm, const char *cmd, FlagBits flags);
+	/** Incremental updates, for callers that don't want a full rebuild */
+	bool RemoveAdminByIdentity(const char *auth, const char *ident);
+	int RefreshGroupMembers(GroupId gid);
+	int RecheckIdentity(const char *auth, const char *ident);
+	void GetAccessCacheStats(uint64_t *hits, uint64_t *misses, uint64_t *flushes, size_t *commands);
 private:
+	bool ResolveAdminCommandAccess(AdminId adm, const char *cmd, FlagBits cmdflags);
+	void InvalidateAccessCache()
+	{
+		m_AccessGeneration++;
+	}
 	void _UnsetCommandOverride(const char *cmd);
 	void _UnsetCommandGroupOverride(const char *group);
 	void InvalidateGroupCache();
@@ -224,6 +247,13 @@ public:
 	bool m_InvalidatingAdmins;
 	bool m_destroying;
 	StringHashMap<AdminFlag> m_LevelNames;
+	/* Per-(admin, command) results of CheckAdminCommandAccess() */
+	AccessCacheMap m_AccessCache;
+	unsigned int m_AccessGeneration;
+	unsigned int m_AccessCacheGeneration;
+	uint64_t m_AccessHits;
+	uint64_t m_AccessMisses;
+	uint64_t m_AccessFlushes;
 };
 
 extern AdminCache g_Admins;
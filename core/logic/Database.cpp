@@ -50,9 +50,13 @@ using namespace std::chrono_literals;
 DBManager g_DBMan;
 
 DBManager::DBManager() 
-	: m_Terminate(false),
+	: m_ThinkRing(kThinkRingSize),
+	  m_WorkerSleeping(false),
+	  m_Terminate(false),
 	  m_pDefault(NULL)
 {
+	for (int i = 0; i < kPrioLevels; i++)
+		m_OpRings[i] = std::make_unique<RingBuffer<IDBThreadOperation *>>(kOpRingSize);
 }
 
 static void FrameHook(bool simulating)
@@ -375,15 +379,30 @@ void DBManager::KillWorkerThread()
 {
 	if (m_Worker)
 	{
+		/* The worker flushes its queues before it exits, so anything still
+		 * waiting for room has to reach it first.
+		 */
+		FlushOpOverflow(true);
+
+		m_Terminate = true;
 		{
 			std::lock_guard<std::mutex> lock(m_Lock);
-			m_Terminate = true;
 			m_QueueEvent.notify_all();
 		}
 		m_Worker->join();
 		m_Worker = nullptr;
 		m_Terminate = false;
 	}
+
+	/* Collect everything the worker finished, including whatever it couldn't
+	 * fit into the ring. Ring entries are always older than the overflow.
+	 */
+	DrainThinkQueue();
+	while (!m_ThinkOverflow.empty())
+	{
+		m_ThinkQueue.push(m_ThinkOverflow.first());
+		m_ThinkOverflow.pop();
+	}
 }
 
 static IdentityToken_t *s_pAddBlock = NULL;
@@ -402,17 +421,107 @@ bool DBManager::AddToThreadQueue(IDBThreadOperation *op, PrioQueueLevel prio)
 		});
 	}
 
-	/* Add to the queue */
+	/* Add to the queue. If the ring is full, or earlier ops of this priority
+	 * are already waiting for room, keep it on our side until RunFrame()
+	 * can hand it over; the op is still threaded, just a little later.
+	 */
+	Queue<IDBThreadOperation *> &overflow = m_OpOverflow[prio];
+	if (!overflow.empty() || !m_OpRings[prio]->TryPush(op))
+	{
+		overflow.push(op);
+	}
+	WakeWorker();
+
+	return true;
+}
+
+void DBManager::FlushOpOverflow(bool wait)
+{
+	bool pushed = false;
+	for (int i = 0; i < kPrioLevels; i++)
+	{
+		Queue<IDBThreadOperation *> &overflow = m_OpOverflow[i];
+		while (!overflow.empty())
+		{
+			if (m_OpRings[i]->TryPush(overflow.first()))
+			{
+				overflow.pop();
+				pushed = true;
+				continue;
+			}
+
+			if (!wait)
+				break;
+
+			WakeWorker();
+			std::this_thread::sleep_for(1ms);
+		}
+	}
+
+	if (pushed)
+		WakeWorker();
+}
+
+void DBManager::WakeWorker()
+{
+	// Pairs with the fence in ThreadMain(): either the worker sees the new
+	// op before it goes to sleep, or we see that it's asleep and wake it.
+	// The game thread only touches m_Lock when the worker is idle.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_WorkerSleeping)
 	{
 		std::lock_guard<std::mutex> lock(m_Lock);
-		Queue<IDBThreadOperation *> &queue = m_OpQueue.GetQueue(prio);
-		queue.push(op);
 		m_QueueEvent.notify_one();
 	}
+}
 
+IDBThreadOperation *DBManager::PopOp()
+{
+	IDBThreadOperation *op;
+	for (int i = 0; i < kPrioLevels; i++)
+	{
+		if (m_OpRings[i]->TryPop(&op))
+			return op;
+	}
+	return NULL;
+}
+
+bool DBManager::OpsPending()
+{
+	for (int i = 0; i < kPrioLevels; i++)
+	{
+		if (!m_OpRings[i]->empty())
+			return true;
+	}
+	return false;
+}
+
+bool DBManager::FlushThinkOverflow()
+{
+	while (!m_ThinkOverflow.empty())
+	{
+		if (!m_ThinkRing.TryPush(m_ThinkOverflow.first()))
+			return false;
+		m_ThinkOverflow.pop();
+	}
 	return true;
 }
 
+void DBManager::PushThink(IDBThreadOperation *op)
+{
+	// Never wait for room here: the game thread may be blocked joining us.
+	// Whatever doesn't fit is retried later, or collected after the join.
+	if (!FlushThinkOverflow() || !m_ThinkRing.TryPush(op))
+		m_ThinkOverflow.push(op);
+}
+
+void DBManager::DrainThinkQueue()
+{
+	m_ThinkRing.Drain([this](IDBThreadOperation *op) -> void {
+		m_ThinkQueue.push(op);
+	});
+}
+
 void DBManager::Run()
 {
 	// Initialize DB threadsafety.
@@ -438,69 +547,62 @@ void DBManager::Run()
 
 void DBManager::ThreadMain()
 {
-	std::unique_lock<std::mutex> lock(m_Lock);
-
 	while (true) {
-		// The lock has been acquired. Grab everything we can out of the
-		// queue. Since we want to flush the queue even if we're terminated,
-		// we process all operations we can before checking to terminate.
-		// There's no risk of starvation since the main thread blocks on us
-		// terminating.
-		auto queue = &m_OpQueue.GetLikelyQueue();
-		if (queue->empty()) {
+		// Read the terminate flag before looking at the queues. Every op the
+		// main thread pushed before asking us to stop is then visible, so we
+		// flush the queues even if we're terminated. There's no risk of
+		// starvation since the main thread blocks on us terminating.
+		bool terminate = m_Terminate;
+		bool think_flushed = FlushThinkOverflow();
+
+		IDBThreadOperation *op = PopOp();
+		if (!op) {
 			// If the queue is empty and we've been asked to stop, leave now.
-			if (m_Terminate)
+			if (terminate)
 				return;
 
-			// Otherwise, wait for something to happen.
-			m_QueueEvent.wait(lock);
+			// Otherwise, wait for something to happen. If finished ops are
+			// still waiting for room in the think ring, only nap so we can
+			// retry once the game thread has drained it.
+			std::unique_lock<std::mutex> lock(m_Lock);
+			m_WorkerSleeping = true;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!OpsPending() && !m_Terminate) {
+				if (think_flushed)
+					m_QueueEvent.wait(lock);
+				else
+					m_QueueEvent.wait_for(lock, 20ms);
+			}
+			m_WorkerSleeping = false;
 			continue;
 		}
 
-		IDBThreadOperation *op = queue->first();
-		queue->pop();
-
-		// Unlock the queue when we run the query, so the main thread can
-		// keep pumping events. We re-acquire the lock to check for more
-		// items. It's okay if we terminate while unlocked; the main
-		// thread would be blocked and we'd need to flush the queue
-		// anyway, so after we've depleted the queue here, we'll just
-		// reach the terminate at the top of the loop.
-		lock.unlock();
+		// Run the query without holding anything, so the main thread can
+		// keep pumping events, then give the result straight back.
 		op->RunThreadPart();
-
-		// Re-acquire the lock and give the data back to the main thread
-		// immediately. We use a separate lock to minimize game thread
-		// contention.
-		{
-			std::lock_guard<std::mutex> think_lock(m_ThinkLock);
-			m_ThinkQueue.push(op);
-		}
+		PushThink(op);
 
 		// Note that we add a 20ms delay after processing a query. This is
 		// questionable but the intent is to avoid starving the game thread.
 		if (!m_Terminate)
 			std::this_thread::sleep_for(20ms);
-
-		lock.lock();
 	}
 }
 
 void DBManager::RunFrame()
 {
+	FlushOpOverflow(false);
+	DrainThinkQueue();
+
 	/* Don't bother if we're empty */
-	if (!m_ThinkQueue.size())
+	if (m_ThinkQueue.empty())
 	{
 		return;
 	}
 
 	/* Dump one thing per-frame so the server stays sane. */
-	IDBThreadOperation *op;
-	{
-		std::lock_guard<std::mutex> lock(m_ThinkLock);
-		op = m_ThinkQueue.first();
-		m_ThinkQueue.pop();
-	}
+	IDBThreadOperation *op = m_ThinkQueue.first();
+	m_ThinkQueue.pop();
 	op->RunThinkPart();
 	op->Destroy();
 }
@@ -38,11 +38,14 @@
 #include <sh_list.h>
 #include <IThreader.h>
 #include <IPluginSys.h>
+#include <IDBDriver.h>
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <thread>
-#include "sm_simple_prioqueue.h"
+#include <sm_queue.h>
+#include <sm_ringbuffer.h>
 #include <am-refcounting.h>
 #include "DatabaseConfBuilder.h"
 
@@ -97,18 +100,42 @@ public:
 private:
 	void ClearConfigs();
 	void KillWorkerThread();
+	void FlushOpOverflow(bool wait);
+	void WakeWorker();
+	IDBThreadOperation *PopOp();
+	bool OpsPending();
+	bool FlushThinkOverflow();
+	void PushThink(IDBThreadOperation *op);
+	void DrainThinkQueue();
 private:
 	CVector<IDBDriver *> m_drivers;
 
-	/* Threading stuff */
-	PrioQueue<IDBThreadOperation *> m_OpQueue;
+	/* Threading stuff. The game thread pushes into m_OpRings and the worker
+	 * pushes finished operations into m_ThinkRing; neither side takes a lock
+	 * to hand work over. m_Lock only guards the worker going to sleep.
+	 */
+	static constexpr size_t kOpRingSize = 256;
+	static constexpr size_t kThinkRingSize = 256;
+	static constexpr int kPrioLevels = PrioQueue_Low + 1;
+
+	std::unique_ptr<RingBuffer<IDBThreadOperation *>> m_OpRings[kPrioLevels];
+	RingBuffer<IDBThreadOperation *> m_ThinkRing;
+
+	/* Game thread only: ops that didn't fit into a full ring, and finished
+	 * ops drained from m_ThinkRing that haven't been run yet.
+	 */
+	Queue<IDBThreadOperation *> m_OpOverflow[kPrioLevels];
 	Queue<IDBThreadOperation *> m_ThinkQueue;
+
+	/* Worker thread only while it runs; read by the game thread after join. */
+	Queue<IDBThreadOperation *> m_ThinkOverflow;
+
 	CVector<bool> m_drSafety;			/* which drivers are safe? */
 	std::unique_ptr<std::thread> m_Worker;
 	std::condition_variable m_QueueEvent;
-	std::mutex m_ThinkLock;
 	std::mutex m_Lock;
-	bool m_Terminate;
+	std::atomic<bool> m_WorkerSleeping;
+	std::atomic<bool> m_Terminate;
 
 	DatabaseConfBuilder m_Builder;
 	HandleType_t m_DriverType;
@@ -137,6 +137,10 @@ SMCResult DatabaseConfBuilder::ReadSMC_KeyValue(const SMCStates *states, const c
 			m_ParseCurrent->info.maxTimeout = atoi(value);
 		} else if (strcmp(key, "port") == 0) {
 			m_ParseCurrent->info.port = atoi(value);
+		} else {
+			/* Anything else is passed through to the driver. */
+			m_ParseCurrent->optionStrings.push_back(key);
+			m_ParseCurrent->optionStrings.push_back(value);
 		}
 	}
 
@@ -158,6 +162,14 @@ SMCResult DatabaseConfBuilder::ReadSMC_LeavingSection(const SMCStates *states)
 		m_ParseCurrent->info.host = m_ParseCurrent->host.c_str();
 		m_ParseCurrent->info.user = m_ParseCurrent->user.c_str();
 		m_ParseCurrent->info.pass = m_ParseCurrent->pass.c_str();
+
+		if (!m_ParseCurrent->optionStrings.empty())
+		{
+			for (size_t i = 0; i < m_ParseCurrent->optionStrings.size(); i++)
+				m_ParseCurrent->options.push_back(m_ParseCurrent->optionStrings[i].c_str());
+			m_ParseCurrent->options.push_back(nullptr);
+			m_ParseCurrent->info.options = &m_ParseCurrent->options[0];
+		}
 		
 		/* Save it.. */
 		m_ParseCurrent->AddRef();
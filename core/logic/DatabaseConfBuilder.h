@@ -55,6 +55,12 @@ public:
 	std::string database;
 	IDBDriver *realDriver;
 	DatabaseInfo info;
+
+	/* Driver-specific keys, stored as key/value pairs. options points into
+	 * optionStrings and is what info.options refers to.
+	 */
+	std::vector<std::string> optionStrings;
+	std::vector<const char *> options;
 };
 
 class ConfDbInfoList : public std::vector<ke::RefPtr<ConfDbInfo>>
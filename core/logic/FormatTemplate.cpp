@@ -0,0 +1,268 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#include "FormatTemplate.h"
+#include "Translator.h"
+#include <IPluginSys.h>
+#include <bridge/include/IScriptManager.h>
+#include <bridge/include/CoreProvider.h>
+#include <string.h>
+
+/* Phrases remembered per template. Templates are usually rendered with a
+ * handful of distinct keys and languages, so this stays a linear scan.
+ */
+static const size_t kMaxPhraseMemos = 8;
+
+FormatTemplate::FormatTemplate(const char *format)
+	: m_NextPhrase(0),
+	  m_PhraseGeneration(0)
+{
+	const char *fmt = format;
+	while (*fmt != '\0')
+	{
+		const char *start = fmt;
+		while (*fmt != '\0' && *fmt != '%')
+			fmt++;
+		if (fmt != start)
+			AddLiteral(start, fmt - start);
+		if (*fmt == '\0')
+			break;
+
+		FormatSpec spec;
+		fmt = ParseFormatSpec(fmt + 1, &spec);
+		if (IsRenderedFormatSpec(spec.ch))
+		{
+			Segment seg;
+			seg.spec = spec;
+			seg.offset = 0;
+			seg.length = 0;
+			m_Segments.push_back(seg);
+		}
+		else if (spec.ch == '\0')
+		{
+			/* A trailing '%' is printed as-is. */
+			AddLiteral("%", 1);
+			break;
+		}
+		else
+		{
+			/* "%%" and unknown conversions print the character itself. */
+			AddLiteral(&spec.ch, 1);
+		}
+	}
+}
+
+void FormatTemplate::AddLiteral(const char *str, size_t length)
+{
+	if (m_Segments.empty() || m_Segments.back().spec.ch != '\0')
+	{
+		Segment seg;
+		seg.spec.ch = '\0';
+		seg.spec.flags = 0;
+		seg.spec.width = 0;
+		seg.spec.prec = -1;
+		seg.offset = m_Literals.size();
+		seg.length = 0;
+		m_Segments.push_back(seg);
+	}
+
+	m_Literals.append(str, length);
+	m_Segments.back().length += length;
+}
+
+size_t FormatTemplate::Render(char *buffer,
+	size_t maxlen,
+	IPluginContext *pCtx,
+	const cell_t *params,
+	int *param)
+{
+	if (!buffer || !maxlen)
+	{
+		return 0;
+	}
+
+	char *buf_p = buffer;
+	size_t llen = maxlen - 1;
+	int arg = *param;
+
+	/* Like atcprintf, stop as soon as the buffer is full, even if there are
+	 * conversions left that would have consumed (or rejected) arguments.
+	 */
+	for (size_t i = 0; i < m_Segments.size() && llen; i++)
+	{
+		const Segment &seg = m_Segments[i];
+		if (seg.spec.ch == '\0')
+		{
+			size_t length = (seg.length < llen) ? seg.length : llen;
+			memcpy(buf_p, m_Literals.c_str() + seg.offset, length);
+			buf_p += length;
+			llen -= length;
+			continue;
+		}
+
+		FormatSpecResult res;
+		if (seg.spec.ch == 't' || seg.spec.ch == 'T')
+			res = RenderPhrase(seg.spec, buf_p, llen, pCtx, params, arg);
+		else
+			res = RenderFormatSpec(seg.spec, buf_p, llen, pCtx, params, arg);
+
+		if (res == FormatSpec_Error)
+			return 0;
+		if (res == FormatSpec_Full)
+			break;
+	}
+
+	*buf_p = '\0';
+	*param = arg;
+	return (maxlen - llen - 1);
+}
+
+FormatSpecResult FormatTemplate::RenderPhrase(const FormatSpec &spec,
+	char *&buf_p,
+	size_t &llen,
+	IPluginContext *pCtx,
+	const cell_t *params,
+	int &arg)
+{
+	int args = params[0];
+	int needed = (spec.ch == 'T') ? 1 : 0;
+	if ((arg + needed) > args)
+	{
+		pCtx->ThrowNativeErrorEx(SP_ERROR_PARAM, "String formatted incorrectly - parameter %d (total %d)", arg, args);
+		return FormatSpec_Error;
+	}
+
+	char *key;
+	cell_t target;
+	pCtx->LocalToString(params[arg++], &key);
+	if (spec.ch == 'T')
+	{
+		cell_t *addr;
+		pCtx->LocalToPhysAddr(params[arg++], &addr);
+		target = *addr;
+	}
+	else
+	{
+		target = bridge->GetGlobalTarget();
+	}
+
+	unsigned int langid;
+	if (!GetTranslationLanguage(pCtx, target, arg, &langid))
+		return FormatSpec_Error;
+
+	IPlugin *pl = scripts->FindPluginByContext(pCtx->GetContext());
+	PhraseMemo *memo = FindPhrase(pCtx, pl->GetPhrases(), key, langid, arg);
+	if (!memo)
+		return FormatSpec_Error;
+
+	size_t res;
+	if (memo->fmt_count)
+	{
+		Translation trans;
+		trans.szPhrase = NULL;
+		trans.fmt_count = memo->fmt_count;
+		trans.fmt_order = memo->fmt_order;
+
+		cell_t new_params[MAX_TRANSLATE_PARAMS];
+		if (!PrepareTranslationParams(pCtx, &trans, params, arg, new_params))
+			return FormatSpec_Error;
+
+		res = memo->text->Render(buf_p, llen + 1, pCtx, new_params, &arg);
+	}
+	else
+	{
+		res = memo->text->Render(buf_p, llen + 1, pCtx, params, &arg);
+	}
+
+	buf_p += res;
+	llen -= res;
+	return FormatSpec_Continue;
+}
+
+FormatTemplate::PhraseMemo *FormatTemplate::FindPhrase(IPluginContext *pCtx,
+	IPhraseCollection *pPhrases,
+	const char *key,
+	unsigned int langid,
+	int arg)
+{
+	/* Anything remembered from before a reparse may point at stale text. */
+	unsigned int generation = g_Translator.GetGeneration();
+	if (generation != m_PhraseGeneration)
+	{
+		m_Phrases.clear();
+		m_NextPhrase = 0;
+		m_PhraseGeneration = generation;
+	}
+
+	for (size_t i = 0; i < m_Phrases.size(); i++)
+	{
+		PhraseMemo &memo = m_Phrases[i];
+		if (memo.phrases == pPhrases && memo.langid == langid && memo.key.compare(key) == 0)
+			return &memo;
+	}
+
+	Translation trans;
+	if (!FindTranslationWithFallback(pCtx, pPhrases, key, langid, arg, &trans))
+		return NULL;
+
+	PhraseMemo *memo;
+	if (m_Phrases.size() < kMaxPhraseMemos)
+	{
+		m_Phrases.reserve(kMaxPhraseMemos);
+		m_Phrases.emplace_back();
+		memo = &m_Phrases.back();
+	}
+	else
+	{
+		memo = &m_Phrases[m_NextPhrase];
+		m_NextPhrase = (m_NextPhrase + 1) % kMaxPhraseMemos;
+	}
+
+	memo->phrases = pPhrases;
+	memo->langid = langid;
+	memo->key = key;
+	memo->fmt_count = trans.fmt_count;
+	if (trans.fmt_count)
+		memcpy(memo->fmt_order, trans.fmt_order, trans.fmt_count * sizeof(int));
+	memo->text.reset(new FormatTemplate(trans.szPhrase));
+	return memo;
+}
+
+size_t FormatTemplate::ApproxSize() const
+{
+	size_t size = sizeof(FormatTemplate)
+		+ m_Literals.capacity()
+		+ m_Segments.capacity() * sizeof(Segment);
+	for (size_t i = 0; i < m_Phrases.size(); i++)
+		size += sizeof(PhraseMemo) + m_Phrases[i].key.size() + m_Phrases[i].text->ApproxSize();
+	return size;
+}
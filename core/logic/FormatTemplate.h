@@ -0,0 +1,105 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#ifndef _INCLUDE_SOURCEMOD_FORMAT_TEMPLATE_H_
+#define _INCLUDE_SOURCEMOD_FORMAT_TEMPLATE_H_
+
+#include "common_logic.h"
+#include "sprintf.h"
+#include <ITranslator.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace SourceMod;
+
+/**
+ * A format string split up front into literal runs and conversions, so that
+ * rendering it repeatedly skips the parsing atcprintf does on every call.
+ * Render() has the same contract and output as atcprintf().
+ *
+ * %t and %T cannot be resolved at compile time, since the phrase key and the
+ * target are script arguments and phrase files can be reparsed. Instead each
+ * template remembers the last few phrases it rendered, along with their
+ * compiled text, and drops them when the translator's generation changes.
+ */
+class FormatTemplate
+{
+	struct Segment
+	{
+		/* spec.ch is 0 for a literal run. */
+		FormatSpec spec;
+		size_t offset;
+		size_t length;
+	};
+
+	struct PhraseMemo
+	{
+		IPhraseCollection *phrases;
+		unsigned int langid;
+		std::string key;
+		unsigned int fmt_count;
+		int fmt_order[MAX_TRANSLATE_PARAMS];
+		std::unique_ptr<FormatTemplate> text;
+	};
+public:
+	explicit FormatTemplate(const char *format);
+
+	size_t Render(char *buffer,
+		size_t maxlen,
+		IPluginContext *pCtx,
+		const cell_t *params,
+		int *param);
+
+	size_t ApproxSize() const;
+private:
+	void AddLiteral(const char *str, size_t length);
+	FormatSpecResult RenderPhrase(const FormatSpec &spec,
+		char *&buf_p,
+		size_t &llen,
+		IPluginContext *pCtx,
+		const cell_t *params,
+		int &arg);
+	PhraseMemo *FindPhrase(IPluginContext *pCtx,
+		IPhraseCollection *pPhrases,
+		const char *key,
+		unsigned int langid,
+		int arg);
+private:
+	std::string m_Literals;
+	std::vector<Segment> m_Segments;
+	std::vector<PhraseMemo> m_Phrases;
+	size_t m_NextPhrase;
+	unsigned int m_PhraseGeneration;
+};
+
+#endif //_INCLUDE_SOURCEMOD_FORMAT_TEMPLATE_H_
@@ -31,6 +31,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
 #include <sh_list.h>
 #include <sh_string.h>
 #include "GameConfigs.h"
@@ -599,8 +601,21 @@ SMCResult CGameConfig::ReadSMC_LeavingSection(const SMCStates *states)
 					s_TempSig.library, 
 					m_CurFile);
 			}
+			else if (s_TempSig.sig[0] && g_GameConfigs.m_cache.FindSignature(s_TempSig.library, s_TempSig.sig, &final_addr))
+			{
+				if (!m_FileStats.empty())
+				{
+					m_FileStats.back().sigCacheHits++;
+				}
+				m_Sigs.replace(m_offset.c_str(), final_addr);
+			}
 			else if (s_TempSig.sig[0])
 			{
+				if (!m_FileStats.empty())
+				{
+					m_FileStats.back().sigScans++;
+				}
+
 				if (s_TempSig.sig[0] == '@')
 				{
 #if defined PLATFORM_WINDOWS
@@ -654,6 +669,7 @@ SMCResult CGameConfig::ReadSMC_LeavingSection(const SMCStates *states)
 					}
 				}
 
+				g_GameConfigs.m_cache.StoreSignature(s_TempSig.library, s_TempSig.sig, final_addr);
 				m_Sigs.replace(m_offset.c_str(), final_addr);
 			}
 
@@ -791,7 +807,7 @@ public:
 				(!had_game && matched_engine) ||
 				(matched_engine && matched_game))
 			{
-				if (fileList->find(cur_file) == fileList->end())
+				if (std::find(fileList->begin(), fileList->end(), cur_file) == fileList->end())
 				{
 					fileList->push_back(cur_file);
 				}
@@ -806,7 +822,7 @@ public:
 		return SMCResult_Continue;
 	}
 public:
-	List<String> *fileList;
+	std::vector<std::string> *fileList;
 	unsigned int state;
 	unsigned int ignoreLevel;
 	char cur_file[PLATFORM_MAX_PATH];
@@ -825,6 +841,7 @@ bool CGameConfig::Reparse(char *error, size_t maxlength)
 	m_Props.clear();
 	m_Keys.clear();
 	m_Addresses.clear();
+	m_FileStats.clear();
 
 	char path[PLATFORM_MAX_PATH];
 
@@ -855,40 +872,16 @@ bool CGameConfig::Reparse(char *error, size_t maxlength)
 	}
 
 	/* Otherwise, it's time to parse the master. */
-	SMCError err;
-	SMCStates state = {0, 0};
-	List<String> fileList;
-	master_reader.fileList = &fileList;
-	const char *pEngine[2] = { m_pBaseEngine, m_pEngine  };
-
-	for (unsigned char iter = 0; iter < SM_ARRAYSIZE(pEngine); ++iter)
+	std::vector<std::string> fileList;
+	if (!ReadMasterFile(path, fileList, error, maxlength))
 	{
-		if (pEngine[iter] == NULL)
-		{
-			continue;
-		}
-
-		this->SetParseEngine(pEngine[iter]);
-		err = textparsers->ParseSMCFile(path, &master_reader, &state, error, maxlength);
-		if (err != SMCError_Okay)
-		{
-			const char *msg = textparsers->GetSMCErrorString(err);
-
-			logger->LogError("[SM] Error parsing master gameconf file \"%s\":", path);
-			logger->LogError("[SM] Error %d on line %d, col %d: %s", 
-				err,
-				state.line,
-				state.col,
-				msg ? msg : "Unknown error");
-			return false;
-		}
+		return false;
 	}
 
 	/* Go through each file we found and parse it. */
-	List<String>::iterator iter;
-	for (iter = fileList.begin(); iter != fileList.end(); iter++)
+	for (size_t i = 0; i < fileList.size(); i++)
 	{
-		ke::SafeSprintf(path, sizeof(path), "%s/%s", m_File, (*iter).c_str());
+		ke::SafeSprintf(path, sizeof(path), "%s/%s", m_File, fileList[i].c_str());
 		if (!EnterFile(path, error, maxlength))
 		{
 			return false;
@@ -938,6 +931,63 @@ bool CGameConfig::Reparse(char *error, size_t maxlength)
 	return true;
 }
 
+bool CGameConfig::ReadMasterFile(const char *path, std::vector<std::string> &fileList, char *error, size_t maxlength)
+{
+	time_t modtime = 0;
+#ifdef PLATFORM_WINDOWS
+	struct _stat64 s;
+	if (_stat64(path, &s) == 0)
+#elif defined PLATFORM_POSIX
+	struct stat s;
+	if (stat(path, &s) == 0)
+#endif
+	{
+		modtime = s.st_mtime;
+	}
+
+	GameConfigCache &cache = g_GameConfigs.m_cache;
+	const GameConfigCache::MasterEntry *cached = cache.FindMaster(path, m_pBaseEngine, m_pEngine, modtime);
+	if (cached)
+	{
+		fileList = cached->files;
+		return true;
+	}
+
+	SMCError err;
+	SMCStates state = {0, 0};
+	master_reader.fileList = &fileList;
+	const char *pEngine[2] = { m_pBaseEngine, m_pEngine  };
+
+	for (unsigned char iter = 0; iter < SM_ARRAYSIZE(pEngine); ++iter)
+	{
+		if (pEngine[iter] == NULL)
+		{
+			continue;
+		}
+
+		this->SetParseEngine(pEngine[iter]);
+		err = textparsers->ParseSMCFile(path, &master_reader, &state, error, maxlength);
+		if (err != SMCError_Okay)
+		{
+			const char *msg = textparsers->GetSMCErrorString(err);
+
+			logger->LogError("[SM] Error parsing master gameconf file \"%s\":", path);
+			logger->LogError("[SM] Error %d on line %d, col %d: %s", 
+				err,
+				state.line,
+				state.col,
+				msg ? msg : "Unknown error");
+			return false;
+		}
+	}
+
+	GameConfigCache::MasterEntry entry;
+	entry.modtime = modtime;
+	entry.files = fileList;
+	cache.StoreMaster(path, m_pBaseEngine, m_pEngine, std::move(entry));
+	return true;
+}
+
 bool CGameConfig::EnterFile(const char *file, char *error, size_t maxlength)
 {
 	SMCError err;
@@ -945,6 +995,15 @@ bool CGameConfig::EnterFile(const char *file, char *error, size_t maxlength)
 
 	g_pSM->BuildPath(Path_SM, m_CurFile, sizeof(m_CurFile), "gamedata/%s", file);
 
+	FileLoadStat stat;
+	stat.file = file;
+	stat.ms = 0.0;
+	stat.sigScans = 0;
+	stat.sigCacheHits = 0;
+	m_FileStats.push_back(std::move(stat));
+
+	auto start = std::chrono::steady_clock::now();
+
 	/* Initialize parse states */
 	m_IgnoreLevel = 0;
 	bShouldBeReadingDefault = true;
@@ -983,6 +1042,8 @@ bool CGameConfig::EnterFile(const char *file, char *error, size_t maxlength)
 		}
 	}
 
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	m_FileStats.back().ms = elapsed.count();
 	return true;
 }
 
@@ -1150,11 +1211,74 @@ void GameConfigManager::OnSourceModAllInitialized()
 	}
 
 	sharesys->AddInterface(NULL, this);
+	rootmenu->AddRootConsoleCommand3("gamedata", "View gamedata load statistics", this);
+}
+
+void GameConfigManager::OnSourceModShutdown()
+{
+	rootmenu->RemoveRootConsoleCommand("gamedata", this);
 }
 
 void GameConfigManager::OnSourceModAllShutdown()
 {
 	CloseGameConfigFile(g_pGameConf);
+	m_cache.Clear();
+}
+
+void GameConfigManager::OnRootConsoleCommand(const char *cmdname, const ICommandArgs *command)
+{
+	if (command->ArgC() >= 3 && strcmp(command->Arg(2), "flush") == 0)
+	{
+		m_cache.Clear();
+		rootmenu->ConsolePrint("[SM] Gamedata cache has been flushed.");
+		return;
+	}
+
+	if (command->ArgC() < 3 || strcmp(command->Arg(2), "times") != 0)
+	{
+		rootmenu->ConsolePrint("SourceMod Gamedata Menu:");
+		rootmenu->DrawGenericOption("times", "Show per-file load times of loaded gamedata");
+		rootmenu->DrawGenericOption("flush", "Flush the shared master/signature cache");
+		return;
+	}
+
+	struct Row
+	{
+		const CGameConfig *conf;
+		const CGameConfig::FileLoadStat *stat;
+	};
+	std::vector<Row> rows;
+	double total = 0.0;
+	for (NameHashSet<CGameConfig *>::iterator iter = m_Lookup.iter(); !iter.empty(); iter.next())
+	{
+		const CGameConfig *conf = *iter;
+		for (size_t i = 0; i < conf->m_FileStats.size(); i++)
+		{
+			rows.push_back({conf, &conf->m_FileStats[i]});
+			total += conf->m_FileStats[i].ms;
+		}
+	}
+
+	std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) -> bool {
+		return a.stat->ms > b.stat->ms;
+	});
+
+	rootmenu->ConsolePrint("[SM] Gamedata load times (slowest first):");
+	rootmenu->ConsolePrint("  %-10s %-6s %-6s %s", "Time (ms)", "Scans", "Cached", "File");
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		rootmenu->ConsolePrint("  %-10.3f %-6u %-6u %s",
+			rows[i].stat->ms,
+			rows[i].stat->sigScans,
+			rows[i].stat->sigCacheHits,
+			rows[i].stat->file.c_str());
+	}
+	rootmenu->ConsolePrint("[SM] Total: %.3f ms across %u files.", total, (unsigned int)rows.size());
+	rootmenu->ConsolePrint("[SM] Master cache: %u hits, %u misses. Signature cache: %u hits, %u misses.",
+		m_cache.master_hits,
+		m_cache.master_misses,
+		m_cache.sig_hits,
+		m_cache.sig_misses);
 }
 
 bool GameConfigManager::LoadGameConfigFile(const char *file, IGameConfig **_pConfig, char *error, size_t maxlength)
@@ -1325,3 +1449,77 @@ bool GameConfigManager::TryGetGameBinaryInfo(const char* pszName, GameBinaryInfo
 
 	return m_gameBinInfos.retrieve(pszName, pDest);
 }
+
+GameConfigCache::GameConfigCache()
+	: master_hits(0),
+	  master_misses(0),
+	  sig_hits(0),
+	  sig_misses(0)
+{
+}
+
+static inline std::string MakeMasterKey(const char *path, const char *baseEngine, const char *engine)
+{
+	std::string key(path);
+	key += '|';
+	key += baseEngine ? baseEngine : "";
+	key += '|';
+	key += engine ? engine : "";
+	return key;
+}
+
+const GameConfigCache::MasterEntry *GameConfigCache::FindMaster(const char *path,
+	const char *baseEngine,
+	const char *engine,
+	time_t modtime)
+{
+	std::string key = MakeMasterKey(path, baseEngine, engine);
+	StringHashMap<MasterEntry>::Result r = m_Masters.find(key.c_str());
+	if (!r.found() || r->value.modtime != modtime)
+	{
+		master_misses++;
+		return NULL;
+	}
+
+	master_hits++;
+	return &r->value;
+}
+
+void GameConfigCache::StoreMaster(const char *path, const char *baseEngine, const char *engine, MasterEntry &&entry)
+{
+	std::string key = MakeMasterKey(path, baseEngine, engine);
+	m_Masters.replace(key.c_str(), std::move(entry));
+}
+
+bool GameConfigCache::FindSignature(const char *library, const char *sig, void **addr)
+{
+	std::string key(library);
+	key += ':';
+	key += sig;
+	if (!m_Sigs.retrieve(key.c_str(), addr))
+	{
+		sig_misses++;
+		return false;
+	}
+
+	sig_hits++;
+	return true;
+}
+
+void GameConfigCache::StoreSignature(const char *library, const char *sig, void *addr)
+{
+	std::string key(library);
+	key += ':';
+	key += sig;
+	m_Sigs.replace(key.c_str(), addr);
+}
+
+void GameConfigCache::Clear()
+{
+	m_Masters.clear();
+	m_Sigs.clear();
+	master_hits = 0;
+	master_misses = 0;
+	sig_hits = 0;
+	sig_misses = 0;
+}
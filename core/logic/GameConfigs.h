@@ -35,6 +35,7 @@
 #include "common_logic.h"
 #include <IGameConfigs.h>
 #include <ITextParsers.h>
+#include <IRootConsoleMenu.h>
 #include <am-refcounting.h>
 #include <sm_hashmap.h>
 #include <sm_namehashset.h>
@@ -56,6 +57,7 @@ public:
 public:
 	bool Reparse(char *error, size_t maxlength);
 	bool EnterFile(const char *file, char *error, size_t maxlength);
+	bool ReadMasterFile(const char *path, std::vector<std::string> &fileList, char *error, size_t maxlength);
 	void SetBaseEngine(const char *engine);
 	void SetParseEngine(const char *engine);
 public: //ITextListener_SMC
@@ -127,6 +129,16 @@ private:
 	const char *m_pEngine;
 	const char *m_pBaseEngine;
 	time_t m_ModTime;
+
+	/* Per-file load statistics from the last Reparse() */
+	struct FileLoadStat
+	{
+		std::string file;
+		double ms;
+		unsigned int sigScans;
+		unsigned int sigCacheHits;
+	};
+	std::vector<FileLoadStat> m_FileStats;
 };
 
 struct GameBinaryInfo
@@ -153,9 +165,42 @@ private:
 	std::vector<std::string> m_ordered;
 };
 
+/**
+ * Results shared between every gamedata file: master.games.txt file lists and
+ * resolved signatures. Signatures are keyed by library and signature text, so
+ * the same pattern declared by sdktools.games, sdkhooks.games and core.games
+ * is only scanned for once.
+ */
+class GameConfigCache
+{
+public:
+	struct MasterEntry
+	{
+		time_t modtime;
+		std::vector<std::string> files;
+	};
+public:
+	GameConfigCache();
+public:
+	const MasterEntry *FindMaster(const char *path, const char *baseEngine, const char *engine, time_t modtime);
+	void StoreMaster(const char *path, const char *baseEngine, const char *engine, MasterEntry &&entry);
+	bool FindSignature(const char *library, const char *sig, void **addr);
+	void StoreSignature(const char *library, const char *sig, void *addr);
+	void Clear();
+public:
+	unsigned int master_hits;
+	unsigned int master_misses;
+	unsigned int sig_hits;
+	unsigned int sig_misses;
+private:
+	StringHashMap<MasterEntry> m_Masters;
+	StringHashMap<void *> m_Sigs;
+};
+
 class GameConfigManager : 
 	public IGameConfigManager,
-	public SMGlobalClass
+	public SMGlobalClass,
+	public IRootConsoleCommand
 {
 public:
 	GameConfigManager();
@@ -173,7 +218,10 @@ public: //IGameConfigManager
 public: //SMGlobalClass
 	void OnSourceModStartup(bool late);
 	void OnSourceModAllInitialized();
+	void OnSourceModShutdown();
 	void OnSourceModAllShutdown();
+public: //IRootConsoleCommand
+	void OnRootConsoleCommand(const char *cmdname, const ICommandArgs *command) override;
 public:
 	bool TryGetGameBinaryInfo(const char* pszName, GameBinaryInfo* pDest);
 	void RemoveCachedConfig(CGameConfig *config);
@@ -185,6 +233,7 @@ private:
 public:
 	StringHashMap<ITextListener_SMC *> m_customHandlers;
 	GameBinPathManager m_gameBinPathManager;
+	GameConfigCache m_cache;
 };
 
 extern GameConfigManager g_GameConfigs;
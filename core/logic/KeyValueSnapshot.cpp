@@ -0,0 +1,169 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#include <ctype.h>
+#include "KeyValueSnapshot.h"
+
+static void AppendLower(std::string &out, const char *str)
+{
+	for (; *str; str++)
+		out += (char)tolower((unsigned char)*str);
+}
+
+uint32_t KeyValueSnapshot::Find(const char *path)
+{
+	std::string key;
+	AppendLower(key, path);
+
+	uint32_t node;
+	if (!paths_.retrieve(key.c_str(), &node))
+		return kInvalidNode;
+	return node;
+}
+
+size_t KeyValueSnapshot::GetMemUsage() const
+{
+	return sizeof(KeyValueSnapshot) +
+	       nodes_.capacity() * sizeof(Node) +
+	       strings_.capacity() +
+	       paths_.mem_usage();
+}
+
+KeyValueSnapshotBuilder::KeyValueSnapshotBuilder()
+	: snapshot_(new KeyValueSnapshot),
+	  ignore_depth_(0),
+	  done_(false)
+{
+}
+
+KeyValueSnapshot *KeyValueSnapshotBuilder::Finish()
+{
+	if (snapshot_->nodes_.empty())
+		return NULL;
+
+	snapshot_->nodes_.shrink_to_fit();
+	snapshot_->strings_.shrink_to_fit();
+	return snapshot_.release();
+}
+
+uint32_t KeyValueSnapshotBuilder::AddString(const char *str)
+{
+	std::vector<char> &strings = snapshot_->strings_;
+	uint32_t offset = (uint32_t)strings.size();
+	strings.insert(strings.end(), str, str + strlen(str) + 1);
+	return offset;
+}
+
+uint32_t KeyValueSnapshotBuilder::AddNode(const char *name, const char *value)
+{
+	KeyValueSnapshot::Node node;
+	node.name = AddString(name);
+	node.value = value ? AddString(value) : KeyValueSnapshot::kInvalidNode;
+	node.first_child = KeyValueSnapshot::kInvalidNode;
+	node.next_sibling = KeyValueSnapshot::kInvalidNode;
+
+	uint32_t index = (uint32_t)snapshot_->nodes_.size();
+	snapshot_->nodes_.push_back(node);
+
+	if (!stack_.empty())
+	{
+		Frame &parent = stack_.back();
+		if (parent.last_child == KeyValueSnapshot::kInvalidNode)
+			snapshot_->nodes_[parent.node].first_child = index;
+		else
+			snapshot_->nodes_[parent.last_child].next_sibling = index;
+		parent.last_child = index;
+	}
+
+	/* Duplicate paths keep the first node, like KeyValues::FindKey(). */
+	snapshot_->paths_.insert(path_.c_str(), index);
+	return index;
+}
+
+void KeyValueSnapshotBuilder::AppendPath(const char *name)
+{
+	if (stack_.size() > 1)
+		path_ += '/';
+	AppendLower(path_, name);
+}
+
+SMCResult KeyValueSnapshotBuilder::ReadSMC_NewSection(const SMCStates *states, const char *name)
+{
+	if (ignore_depth_ || (stack_.empty() && done_))
+	{
+		ignore_depth_++;
+		return SMCResult_Continue;
+	}
+
+	size_t path_length = path_.size();
+	if (!stack_.empty())
+		AppendPath(name);
+
+	Frame frame;
+	frame.node = AddNode(name, NULL);
+	frame.last_child = KeyValueSnapshot::kInvalidNode;
+	frame.path_length = path_length;
+	stack_.push_back(frame);
+
+	return SMCResult_Continue;
+}
+
+SMCResult KeyValueSnapshotBuilder::ReadSMC_KeyValue(const SMCStates *states, const char *key, const char *value)
+{
+	if (ignore_depth_ || stack_.empty())
+		return SMCResult_Continue;
+
+	size_t path_length = path_.size();
+	AppendPath(key);
+	AddNode(key, value);
+	path_.resize(path_length);
+
+	return SMCResult_Continue;
+}
+
+SMCResult KeyValueSnapshotBuilder::ReadSMC_LeavingSection(const SMCStates *states)
+{
+	if (ignore_depth_)
+	{
+		ignore_depth_--;
+		return SMCResult_Continue;
+	}
+	if (stack_.empty())
+		return SMCResult_Continue;
+
+	path_.resize(stack_.back().path_length);
+	stack_.pop_back();
+	if (stack_.empty())
+		done_ = true;
+
+	return SMCResult_Continue;
+}
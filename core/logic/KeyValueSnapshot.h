@@ -0,0 +1,154 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#ifndef _INCLUDE_SOURCEMOD_KEYVALUE_SNAPSHOT_H_
+#define _INCLUDE_SOURCEMOD_KEYVALUE_SNAPSHOT_H_
+
+#include "common_logic.h"
+#include <ITextParsers.h>
+#include <IHandleSys.h>
+#include <sm_hashmap.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace SourceMod;
+
+/**
+ * A read-only, compiled copy of a KeyValues tree. Nodes and strings are kept
+ * in flat arrays, and every node is indexed by its full path from the root
+ * ("items/awp/price"), so lookups are a single hash probe instead of a walk.
+ *
+ * Paths are matched case-insensitively, like KeyValues. If a section has
+ * duplicate keys, the first one wins, also like KeyValues.
+ *
+ * A snapshot is plain data and may be built on any thread.
+ */
+class KeyValueSnapshot
+{
+	friend class KeyValueSnapshotBuilder;
+public:
+	static const uint32_t kInvalidNode = 0xFFFFFFFF;
+
+	struct Node
+	{
+		uint32_t name;          /* Offset into the string pool */
+		uint32_t value;         /* Offset into the string pool, or kInvalidNode for sections */
+		uint32_t first_child;
+		uint32_t next_sibling;
+	};
+
+public:
+	/* Returns the node at the given path, or kInvalidNode. "" is the root. */
+	uint32_t Find(const char *path);
+
+	bool IsSection(uint32_t node) const
+	{
+		return nodes_[node].value == kInvalidNode;
+	}
+	const char *GetName(uint32_t node) const
+	{
+		return &strings_[nodes_[node].name];
+	}
+	const char *GetValue(uint32_t node) const
+	{
+		return IsSection(node) ? NULL : &strings_[nodes_[node].value];
+	}
+	uint32_t FirstChild(uint32_t node) const
+	{
+		return nodes_[node].first_child;
+	}
+	uint32_t NextSibling(uint32_t node) const
+	{
+		return nodes_[node].next_sibling;
+	}
+
+	size_t size() const
+	{
+		return nodes_.size();
+	}
+	size_t GetMemUsage() const;
+
+private:
+	std::vector<Node> nodes_;
+	std::vector<char> strings_;
+	StringHashMap<uint32_t> paths_;
+};
+
+/**
+ * Builds a snapshot from SMC parse events, either from ITextParsers or from
+ * a KeyValues tree walked by core. The first top-level section becomes the
+ * root, the same way FileToKeyValues() treats a file; anything after it is
+ * ignored.
+ */
+class KeyValueSnapshotBuilder : public ITextListener_SMC
+{
+	struct Frame
+	{
+		uint32_t node;
+		uint32_t last_child;
+		size_t path_length;
+	};
+public:
+	KeyValueSnapshotBuilder();
+
+	/* Returns the snapshot, or NULL if no root section was seen. */
+	KeyValueSnapshot *Finish();
+
+public: //ITextListener_SMC
+	SMCResult ReadSMC_NewSection(const SMCStates *states, const char *name) override;
+	SMCResult ReadSMC_KeyValue(const SMCStates *states, const char *key, const char *value) override;
+	SMCResult ReadSMC_LeavingSection(const SMCStates *states) override;
+
+private:
+	uint32_t AddString(const char *str);
+	uint32_t AddNode(const char *name, const char *value);
+	void AppendPath(const char *name);
+
+private:
+	std::unique_ptr<KeyValueSnapshot> snapshot_;
+	std::vector<Frame> stack_;
+	std::string path_;
+	size_t ignore_depth_;
+	bool done_;
+};
+
+extern HandleType_t g_KeyValueSnapshotType;
+
+/**
+ * Wraps a snapshot in a new handle. The handle takes ownership, or the
+ * snapshot is freed on failure.
+ */
+Handle_t CreateKeyValueSnapshotHandle(IdentityToken_t *owner, KeyValueSnapshot *snapshot);
+
+#endif //_INCLUDE_SOURCEMOD_KEYVALUE_SNAPSHOT_H_
@@ -31,32 +31,87 @@
 
 #include "LumpManager.h"
 
-#include <iomanip>
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 
 EntityLumpParseResult::operator bool() const {
 	return m_Status == Status_OK;
 }
 
+const char* EntityLumpParseResult::Description() const {
+	switch (m_Status) {
+		case Status_OK:
+			return "No error";
+		case Status_UnexpectedChar:
+			return "Unexpected character";
+	}
+	return "Unknown error";
+}
+
+static inline bool IsLumpWhitespace(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static inline const char* SkipWhitespace(const char* p) {
+	while (IsLumpWhitespace(*p)) {
+		p++;
+	}
+	return p;
+}
+
+/**
+ * Reads a quoted string starting at the opening quote into out, and returns a pointer past the
+ * closing quote, or nullptr if the string is not terminated.  A backslash escapes the next
+ * character, matching what std::quoted accepted before.
+ */
+static const char* ReadQuoted(const char* p, std::string& out) {
+	const char* start = ++p;
+	while (*p != '"' && *p != '\\' && *p != '\0') {
+		p++;
+	}
+	
+	// Common case: no escapes, so the value can be copied in one go.
+	out.assign(start, p - start);
+	if (*p == '"') {
+		return p + 1;
+	}
+	
+	while (*p != '\0') {
+		if (*p == '\\') {
+			if (*++p == '\0') {
+				break;
+			}
+		} else if (*p == '"') {
+			return p + 1;
+		}
+		out.push_back(*p++);
+	}
+	return nullptr;
+}
+
 EntityLumpParseResult EntityLumpManager::Parse(const char* pMapEntities) {
 	m_Entities.clear();
+	InvalidateIndex();
 	
-	std::istringstream mapEntities(pMapEntities);
+	// Scratch entry reused across blocks, so each block only allocates its final storage.
+	EntityLumpEntry entry;
 	
+	const char* p = pMapEntities;
 	for (;;) {
-		std::string token;
-		mapEntities >> std::ws >> token >> std::ws;
+		p = SkipWhitespace(p);
 		
 		// Assert that we're at the start of a new block, otherwise we're done parsing
-		if (token != "{") {
-			if (token == "\0") {
+		if (*p != '{') {
+			if (*p == '\0') {
 				break;
 			} else {
 				return EntityLumpParseResult {
-					Status_UnexpectedChar, mapEntities.tellg()
+					Status_UnexpectedChar, p - pMapEntities
 				};
 			}
 		}
+		p = SkipWhitespace(p + 1);
 		
 		/**
 		 * Parse key / value pairs until we reach a closing brace.  We currently assume there
@@ -66,28 +121,31 @@ EntityLumpParseResult EntityLumpManager::Parse(const char* pMapEntities) {
 		 * braces (`shared/mapentities_shared.cpp::MapEntity_ParseToken`), but I haven't seen
 		 * those in practice.
 		 */
-		EntityLumpEntry entry;
-		while (mapEntities.peek() != '}') {
-			std::string key, value;
+		entry.clear();
+		while (*p != '}') {
+			entry.emplace_back();
+			auto& pair = entry.back();
 			
-			if (mapEntities.peek() != '"') {
+			const char* next = (*p == '"') ? ReadQuoted(p, pair.first) : nullptr;
+			if (!next) {
 				return EntityLumpParseResult {
-					Status_UnexpectedChar, mapEntities.tellg()
+					Status_UnexpectedChar, p - pMapEntities
 				};
 			}
-			mapEntities >> quoted(key) >> std::ws;
+			p = SkipWhitespace(next);
 			
-			if (mapEntities.peek() != '"') {
+			next = (*p == '"') ? ReadQuoted(p, pair.second) : nullptr;
+			if (!next) {
 				return EntityLumpParseResult {
-					Status_UnexpectedChar, mapEntities.tellg()
+					Status_UnexpectedChar, p - pMapEntities
 				};
 			}
-			mapEntities >> quoted(value) >> std::ws;
-			
-			entry.emplace_back(key, value);
+			p = SkipWhitespace(next);
 		}
-		mapEntities.get();
-		m_Entities.push_back(std::make_shared<EntityLumpEntry>(entry));
+		p++;
+		
+		m_Entities.push_back(std::make_shared<EntityLumpEntry>(
+				std::make_move_iterator(entry.begin()), std::make_move_iterator(entry.end())));
 	}
 	
 	return EntityLumpParseResult{};
@@ -114,10 +172,12 @@ std::weak_ptr<EntityLumpEntry> EntityLumpManager::Get(size_t index) {
 }
 
 void EntityLumpManager::Erase(size_t index) {
+	InvalidateIndex();
 	m_Entities.erase(m_Entities.begin() + index);
 }
 
 void EntityLumpManager::Insert(size_t index) {
+	InvalidateIndex();
 	m_Entities.emplace(m_Entities.begin() + index, std::make_shared<EntityLumpEntry>());
 }
 
@@ -129,3 +189,54 @@ size_t EntityLumpManager::Append() {
 size_t EntityLumpManager::Length() {
 	return m_Entities.size();
 }
+
+int EntityLumpManager::Find(EntityLumpIndexKey key, const char* value, int start) {
+	if (!m_IndexValid) {
+		BuildIndex();
+	}
+	
+	auto it = m_Index[key].find(value);
+	if (it == m_Index[key].end()) {
+		return -1;
+	}
+	
+	// Indexes are stored in ascending order.
+	const std::vector<int>& matches = it->second;
+	auto next = std::upper_bound(matches.begin(), matches.end(), start);
+	if (next == matches.end()) {
+		return -1;
+	}
+	return *next;
+}
+
+void EntityLumpManager::InvalidateIndex() {
+	if (!m_IndexValid) {
+		return;
+	}
+	for (auto& index : m_Index) {
+		index.clear();
+	}
+	m_IndexValid = false;
+}
+
+void EntityLumpManager::BuildIndex() {
+	static const char* const kIndexKeys[Index_Count] = {
+		"classname",
+		"targetname",
+		"hammerid",
+	};
+	
+	for (size_t i = 0; i < m_Entities.size(); i++) {
+		bool found[Index_Count] = {};
+		for (const auto& pair : *m_Entities[i]) {
+			for (int key = 0; key < Index_Count; key++) {
+				if (!found[key] && pair.first == kIndexKeys[key]) {
+					m_Index[key][pair.second].push_back(static_cast<int>(i));
+					found[key] = true;
+					break;
+				}
+			}
+		}
+	}
+	m_IndexValid = true;
+}
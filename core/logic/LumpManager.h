@@ -35,6 +35,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 /**
  * Entity lump manager.  Provides a list that stores a list of key / value pairs and the
@@ -56,6 +57,17 @@ enum EntityLumpParseStatus {
 	Status_UnexpectedChar,
 };
 
+/**
+ * @brief Keys that EntityLumpManager::Find() can look up entries by.
+ */
+enum EntityLumpIndexKey {
+	Index_Classname,
+	Index_Targetname,
+	Index_HammerId,
+	
+	Index_Count
+};
+
 /**
  * @brief Result of parsing an entity lump.  On a parse error, m_Status is not Status_OK and
  * m_Position indicates the offset within the string that caused the parse error.
@@ -109,8 +121,30 @@ public:
 	 */
 	size_t Length();
 
+	/**
+	 * @brief Returns the index of the first entry after start whose value for the given key
+	 * matches exactly, or -1 if there is none.  Pass -1 as start to search from the beginning.
+	 *
+	 * Only the first occurrence of the key in each entry is considered.  The index is built on
+	 * first use and kept until the lump is modified.
+	 */
+	int Find(EntityLumpIndexKey key, const char* value, int start);
+
+	/**
+	 * @brief Discards the lookup index.  Must be called after modifying an entry's key / value
+	 * pairs; changes made through this class invalidate it automatically.
+	 */
+	void InvalidateIndex();
+
+private:
+	void BuildIndex();
+
 private:
 	std::vector<std::shared_ptr<EntityLumpEntry>> m_Entities;
+	
+	using EntityLumpIndex = std::unordered_map<std::string, std::vector<int>>;
+	EntityLumpIndex m_Index[Index_Count];
+	bool m_IndexValid = false;
 };
 
 #endif // _INCLUDE_LUMPMANAGER_H_
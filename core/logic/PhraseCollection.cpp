@@ -37,10 +37,13 @@
 
 CPhraseCollection::CPhraseCollection()
 {
+	g_Translator.InvalidateTranslations();
 }
 
 CPhraseCollection::~CPhraseCollection()
 {
+	/* Another collection may be allocated at the same address. */
+	g_Translator.InvalidateTranslations();
 }
 
 void CPhraseCollection::Destroy()
@@ -70,6 +73,7 @@ IPhraseFile *CPhraseCollection::AddPhraseFile(const char *filename)
 	}
 
 	m_Files.push_back(pFile);
+	g_Translator.InvalidateTranslations();
 
 	return pFile;
 }
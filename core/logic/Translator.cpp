@@ -110,6 +110,7 @@ void CPhraseFile::ParseWarning(const char *message, ...)
 void CPhraseFile::ReparseFile()
 {
 	m_PhraseLookup.clear();
+	m_pTranslator->InvalidateTranslations();
 
 	m_LangCount = m_pTranslator->GetLanguageCount();
 
@@ -687,7 +688,7 @@ const char *CPhraseFile::GetFilename()
  ** MAIN TRANSLATOR CODE **
  **************************/
 
-Translator::Translator() : m_ServerLang(SOURCEMOD_LANGUAGE_ENGLISH)
+Translator::Translator() : m_ServerLang(SOURCEMOD_LANGUAGE_ENGLISH), m_Generation(0)
 {
 	m_pStringTab = new BaseStringTable(2048);
 	strncopy(m_InitialLang, "en", sizeof(m_InitialLang));
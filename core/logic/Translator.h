@@ -149,6 +149,20 @@ public: //ITranslator
 		const char **pFailPhrase);
 	bool GetLanguageInfo(unsigned int number, const char **code, const char **name);
 	void RebuildLanguageDatabase();
+public:
+	/**
+	 * Bumped whenever a lookup may resolve differently than before (a file
+	 * was reparsed, or a collection was created, changed or destroyed).
+	 * Anything holding on to translation results should key on this.
+	 */
+	unsigned int GetGeneration() const
+	{
+		return m_Generation;
+	}
+	void InvalidateTranslations()
+	{
+		m_Generation++;
+	}
 private:
 	bool AddLanguage(const char *langcode, const char *description);
 private:
@@ -161,6 +175,7 @@ private:
 	String m_CustomError;
 	unsigned int m_ServerLang;
 	char m_InitialLang[4];
+	unsigned int m_Generation;
 };
 
 /* Nice little wrapper to handle error logging and whatnot */
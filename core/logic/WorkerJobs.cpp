@@ -0,0 +1,258 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#include "WorkerJobs.h"
+#include "ThreadSupport.h"
+#include "PluginSys.h"
+#include <ISourceMod.h>
+#include <thread>
+
+/* Number of threads in the pool. Jobs are meant to be multi-millisecond
+ * batches, so a small pool is enough to keep them off the game thread.
+ */
+static const size_t kWorkerThreads = 2;
+
+/* Jobs that are queued or running, across all plugins. */
+static const size_t kMaxPendingJobs = 256;
+
+WorkerJobManager g_WorkerJobs;
+
+static void FrameHook(bool simulating)
+{
+	g_WorkerJobs.RunFrame();
+}
+
+WorkerJobManager::WorkerJobManager()
+	: m_NextId(0),
+	  m_Terminate(false),
+	  m_Done(kMaxPendingJobs)
+{
+}
+
+void WorkerJobManager::OnSourceModAllInitialized()
+{
+	g_PluginSys.AddPluginsListener(this);
+	g_pSM->AddGameFrameHook(&FrameHook);
+}
+
+void WorkerJobManager::OnSourceModShutdown()
+{
+	g_pSM->RemoveGameFrameHook(&FrameHook);
+	g_PluginSys.RemovePluginsListener(this);
+
+	/* Nothing will be delivered anymore, so don't bother draining. */
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Queue.clear();
+	}
+	StopWorkers();
+
+	for (auto iter = m_Jobs.begin(); iter != m_Jobs.end(); iter++)
+		delete iter->second;
+	m_Jobs.clear();
+	m_Done.Drain([](JobEntry *entry) -> void {});
+}
+
+void WorkerJobManager::OnPluginWillUnload(IPlugin *plugin)
+{
+	IdentityToken_t *owner = plugin->GetIdentity();
+
+	std::vector<JobEntry *> cancelled;
+	for (auto iter = m_Jobs.begin(); iter != m_Jobs.end(); iter++)
+	{
+		if (iter->second->owner == owner)
+			cancelled.push_back(iter->second);
+	}
+
+	for (size_t i = 0; i < cancelled.size(); i++)
+		CancelEntry(cancelled[i]);
+}
+
+void WorkerJobManager::StartWorkers()
+{
+	for (size_t i = m_Workers.size(); i < kWorkerThreads; i++)
+	{
+		WorkerThread *worker = new WorkerThread(this);
+		worker->handle_ = g_pThreader->MakeThread(worker, Thread_Default);
+		if (!worker->handle_)
+		{
+			delete worker;
+			break;
+		}
+		m_Workers.push_back(worker);
+	}
+}
+
+void WorkerJobManager::StopWorkers()
+{
+	if (m_Workers.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Terminate = true;
+		m_QueueEvent.notify_all();
+	}
+
+	for (size_t i = 0; i < m_Workers.size(); i++)
+	{
+		m_Workers[i]->handle_->WaitForThread();
+		m_Workers[i]->handle_->DestroyThis();
+		delete m_Workers[i];
+	}
+	m_Workers.clear();
+	m_Terminate = false;
+}
+
+int WorkerJobManager::Submit(IdentityToken_t *owner, IWorkerJob *job)
+{
+	if (m_Jobs.size() >= kMaxPendingJobs)
+	{
+		delete job;
+		return 0;
+	}
+
+	StartWorkers();
+	if (m_Workers.empty())
+	{
+		delete job;
+		return 0;
+	}
+
+	/* Ids wrap around but skip 0, which means failure. */
+	do
+	{
+		if (++m_NextId <= 0)
+			m_NextId = 1;
+	} while (m_Jobs.find(m_NextId) != m_Jobs.end());
+
+	JobEntry *entry = new JobEntry;
+	entry->id = m_NextId;
+	entry->owner = owner;
+	entry->cancelled = false;
+	entry->job.reset(job);
+	m_Jobs[entry->id] = entry;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Queue.push_back(entry);
+		m_QueueEvent.notify_one();
+	}
+
+	return entry->id;
+}
+
+bool WorkerJobManager::Cancel(int id, IdentityToken_t *owner)
+{
+	auto iter = m_Jobs.find(id);
+	if (iter == m_Jobs.end() || iter->second->owner != owner || iter->second->cancelled)
+		return false;
+
+	CancelEntry(iter->second);
+	return true;
+}
+
+void WorkerJobManager::CancelEntry(JobEntry *entry)
+{
+	/* If no worker has picked the job up yet, drop it right away. Otherwise
+	 * it is deleted by RunFrame() once the worker hands it back.
+	 */
+	bool removed = false;
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		for (auto iter = m_Queue.begin(); iter != m_Queue.end(); iter++)
+		{
+			if (*iter == entry)
+			{
+				m_Queue.erase(iter);
+				removed = true;
+				break;
+			}
+		}
+	}
+
+	if (removed)
+	{
+		m_Jobs.erase(entry->id);
+		delete entry;
+		return;
+	}
+
+	entry->cancelled = true;
+}
+
+void WorkerJobManager::RunFrame()
+{
+	m_Done.Drain([this](JobEntry *entry) -> void {
+		m_Jobs.erase(entry->id);
+		if (!entry->cancelled)
+			entry->job->RunThinkPart(entry->id);
+		delete entry;
+	});
+}
+
+void WorkerJobManager::ThreadMain()
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+
+	while (true)
+	{
+		if (m_Queue.empty())
+		{
+			if (m_Terminate)
+				return;
+
+			m_QueueEvent.wait(lock);
+			continue;
+		}
+
+		JobEntry *entry = m_Queue.front();
+		m_Queue.pop_front();
+
+		lock.unlock();
+		entry->job->RunThreadPart();
+
+		/* The ring has a slot for every live job, so there is always room. */
+		while (!m_Done.TryPush(entry))
+			std::this_thread::yield();
+
+		lock.lock();
+	}
+}
+
+void WorkerJobManager::WorkerThread::RunThread(IThreadHandle *pHandle)
+{
+	manager_->ThreadMain();
+}
+
+void WorkerJobManager::WorkerThread::OnTerminate(IThreadHandle *pHandle, bool cancel)
+{
+}
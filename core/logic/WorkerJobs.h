@@ -0,0 +1,144 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#ifndef _INCLUDE_SOURCEMOD_WORKER_JOBS_H_
+#define _INCLUDE_SOURCEMOD_WORKER_JOBS_H_
+
+#include "common_logic.h"
+#include <IThreader.h>
+#include <IPluginSys.h>
+#include <sm_ringbuffer.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace SourceMod;
+
+/**
+ * A unit of pure-data work run on a worker thread. RunThreadPart() must not
+ * touch handles, plugins or anything else owned by the game thread; it should
+ * only operate on data the job copied when it was created.
+ */
+class IWorkerJob
+{
+public:
+	virtual ~IWorkerJob()
+	{
+	}
+
+	/* Called on a worker thread. */
+	virtual void RunThreadPart() =0;
+
+	/* Called on the game thread once RunThreadPart() has finished. */
+	virtual void RunThinkPart(int id) =0;
+};
+
+class WorkerJobManager :
+	public SMGlobalClass,
+	public IPluginsListener
+{
+	struct JobEntry
+	{
+		int id;
+		IdentityToken_t *owner;
+		bool cancelled;
+		std::unique_ptr<IWorkerJob> job;
+	};
+
+	class WorkerThread : public IThread
+	{
+	public:
+		explicit WorkerThread(WorkerJobManager *manager)
+			: manager_(manager), handle_(NULL)
+		{
+		}
+		void RunThread(IThreadHandle *pHandle) override;
+		void OnTerminate(IThreadHandle *pHandle, bool cancel) override;
+	public:
+		WorkerJobManager *manager_;
+		IThreadHandle *handle_;
+	};
+public:
+	WorkerJobManager();
+public: //SMGlobalClass
+	void OnSourceModAllInitialized() override;
+	void OnSourceModShutdown() override;
+public: //IPluginsListener
+	void OnPluginWillUnload(IPlugin *plugin) override;
+public:
+	/**
+	 * Queues a job. Returns a job id greater than zero, or 0 if the queue is
+	 * full. The manager takes ownership of the job either way.
+	 */
+	int Submit(IdentityToken_t *owner, IWorkerJob *job);
+
+	/**
+	 * Cancels a job owned by the given identity. The job's think part will
+	 * never run; a job that is already running finishes but its result is
+	 * discarded.
+	 */
+	bool Cancel(int id, IdentityToken_t *owner);
+
+	void RunFrame();
+
+	size_t Pending() const
+	{
+		return m_Jobs.size();
+	}
+private:
+	void ThreadMain();
+	void StartWorkers();
+	void StopWorkers();
+	void CancelEntry(JobEntry *entry);
+private:
+	/* Game thread only */
+	std::unordered_map<int, JobEntry *> m_Jobs;
+	std::vector<WorkerThread *> m_Workers;
+	int m_NextId;
+
+	/* Shared with workers */
+	std::mutex m_Lock;
+	std::condition_variable m_QueueEvent;
+	std::deque<JobEntry *> m_Queue;
+	bool m_Terminate;
+
+	/* Finished jobs, pushed by any worker and drained by RunFrame(). Never
+	 * needs more room than kMaxPendingJobs.
+	 */
+	RingBuffer<JobEntry *> m_Done;
+};
+
+extern WorkerJobManager g_WorkerJobs;
+
+#endif //_INCLUDE_SOURCEMOD_WORKER_JOBS_H_
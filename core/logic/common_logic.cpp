@@ -167,6 +167,11 @@ static const char* GetEntityLumpString()
 	return g_strMapEntities.c_str();
 }
 
+static void GetAdminAccessCacheStats(uint64_t *hits, uint64_t *misses, uint64_t *flushes, size_t *commands)
+{
+	g_Admins.GetAccessCacheStats(hits, misses, flushes, commands);
+}
+
 // Defined in smn_filesystem.cpp.
 extern bool OnLogPrint(const char *msg);
 
@@ -205,6 +210,7 @@ static sm_logic_t logic =
 	SetEntityLumpWritable,
 	ParseEntityLumpString,
 	GetEntityLumpString,
+	GetAdminAccessCacheStats,
 	&g_PluginSys,
 	&g_ShareSys,
 	&g_Extensions,
@@ -26,6 +26,8 @@
 // or <http://www.sourcemod.net/license.php>.
 #include "frame_tasks.h"
 #include <am-vector.h>
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 using namespace SourceMod;
@@ -39,11 +41,30 @@ SourceMod::ScheduleTaskForNextFrame(ke::Function<void()>&& task)
 	sNextTasks.push_back(std::forward<decltype(task)>(task));
 }
 
+static const unsigned int kDefaultTaskBudgetUs = 1000;
+
+static std::vector<ke::RefPtr<BudgetedTaskQueue>> sBudgetedQueues;
+static ke::RefPtr<BudgetedTaskQueue> sDefaultQueue;
+
+static void
+RunBudgetedTaskQueues()
+{
+	if (sBudgetedQueues.empty())
+		return;
+
+	// Queues may be unregistered by the tasks they run, so iterate a copy.
+	std::vector<ke::RefPtr<BudgetedTaskQueue>> queues(sBudgetedQueues);
+	for (size_t i = 0; i < queues.size(); i++)
+		queues[i]->Run();
+}
+
 void
 SourceMod::RunScheduledFrameTasks(bool simulating)
 {
-	if (sNextTasks.empty())
+	if (sNextTasks.empty()) {
+		RunBudgetedTaskQueues();
 		return;
+	}
 
 	// Swap.
 	std::vector<ke::Function<void()>> temp(std::move(sNextTasks));
@@ -53,4 +74,117 @@ SourceMod::RunScheduledFrameTasks(bool simulating)
 	for (size_t i = 0; i < sWorkTasks.size(); i++)
 		sWorkTasks[i]();
 	sWorkTasks.clear();
+
+	RunBudgetedTaskQueues();
+}
+
+void
+SourceMod::RegisterBudgetedTaskQueue(BudgetedTaskQueue *queue)
+{
+	for (size_t i = 0; i < sBudgetedQueues.size(); i++) {
+		if (sBudgetedQueues[i] == queue)
+			return;
+	}
+	sBudgetedQueues.push_back(queue);
+}
+
+void
+SourceMod::UnregisterBudgetedTaskQueue(BudgetedTaskQueue *queue)
+{
+	for (size_t i = 0; i < sBudgetedQueues.size(); i++) {
+		if (sBudgetedQueues[i] == queue) {
+			sBudgetedQueues.erase(sBudgetedQueues.begin() + i);
+			return;
+		}
+	}
+}
+
+BudgetedTaskQueue *
+SourceMod::GetDefaultBudgetedTaskQueue()
+{
+	if (!sDefaultQueue) {
+		sDefaultQueue = new BudgetedTaskQueue(kDefaultTaskBudgetUs);
+		RegisterBudgetedTaskQueue(sDefaultQueue);
+	}
+	return sDefaultQueue;
+}
+
+BudgetedTaskQueue::BudgetedTaskQueue(unsigned int budget_us)
+ : budget_us_(budget_us),
+   seq_(0),
+   executed_(0),
+   deferred_(0),
+   overruns_(0)
+{
+}
+
+// std::push_heap/pop_heap keep the "largest" element at the front, so the
+// entry that should run first must compare greater than everything else.
+bool
+BudgetedTaskQueue::Compare(const Entry &a, const Entry &b)
+{
+	if (a.priority != b.priority)
+		return a.priority < b.priority;
+	return a.seq > b.seq;
+}
+
+void
+BudgetedTaskQueue::Push(int priority, ke::Function<void()>&& task)
+{
+	// Tasks pushed while the queue is running are not eligible until the
+	// next frame, so a task that reschedules itself cannot spin forever.
+	Entry entry;
+	entry.priority = priority;
+	entry.seq = seq_++;
+	entry.task = std::move(task);
+	incoming_.push_back(std::move(entry));
+}
+
+size_t
+BudgetedTaskQueue::Cancel()
+{
+	size_t count = Pending();
+	heap_.clear();
+	incoming_.clear();
+	return count;
+}
+
+void
+BudgetedTaskQueue::Run()
+{
+	for (size_t i = 0; i < incoming_.size(); i++) {
+		heap_.push_back(std::move(incoming_[i]));
+		std::push_heap(heap_.begin(), heap_.end(), Compare);
+	}
+	incoming_.clear();
+
+	if (heap_.empty())
+		return;
+
+	// Keep ourselves alive in case a task drops the last reference.
+	ke::RefPtr<BudgetedTaskQueue> self(this);
+
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+	Clock::time_point deadline = start + std::chrono::microseconds(budget_us_);
+
+	size_t ran = 0;
+	Clock::time_point now = start;
+	while (!heap_.empty()) {
+		if (ran && now >= deadline)
+			break;
+
+		std::pop_heap(heap_.begin(), heap_.end(), Compare);
+		ke::Function<void()> task(std::move(heap_.back().task));
+		heap_.pop_back();
+
+		task();
+		ran++;
+		executed_++;
+		now = Clock::now();
+	}
+
+	if (now > deadline)
+		overruns_++;
+	deferred_ += heap_.size();
 }
@@ -28,6 +28,9 @@
 #define _include_sourcemod_logic_frame_tasks_h_
 
 #include <am-function.h>
+#include <am-refcounting.h>
+#include <stdint.h>
+#include <vector>
 
 namespace SourceMod {
 
@@ -35,6 +38,72 @@ void ScheduleTaskForNextFrame(ke::Function<void()>&& task);
 
 void RunScheduledFrameTasks(bool simulating);
 
+// A queue of prioritized tasks that only runs for a limited amount of time
+// each frame. Tasks with a higher priority run first; tasks with the same
+// priority run in the order they were pushed. Whatever does not fit in the
+// budget is carried over to the next frame. At least one task runs per frame,
+// so a queue always makes progress even if a single task exceeds the budget.
+class BudgetedTaskQueue : public ke::Refcounted<BudgetedTaskQueue>
+{
+public:
+	explicit BudgetedTaskQueue(unsigned int budget_us);
+
+	void Push(int priority, ke::Function<void()>&& task);
+
+	// Drops every pending task, returning how many were cancelled.
+	size_t Cancel();
+
+	// Runs pending tasks until the budget is exhausted.
+	void Run();
+
+	size_t Pending() const {
+		return heap_.size() + incoming_.size();
+	}
+	unsigned int budget() const {
+		return budget_us_;
+	}
+	void set_budget(unsigned int budget_us) {
+		budget_us_ = budget_us;
+	}
+
+	// Number of tasks that have run.
+	uint64_t executed() const {
+		return executed_;
+	}
+	// Number of times a task was carried over to a later frame.
+	uint64_t deferred() const {
+		return deferred_;
+	}
+	// Number of frames in which the queue ran past its budget.
+	uint64_t overruns() const {
+		return overruns_;
+	}
+
+private:
+	struct Entry {
+		int priority;
+		uint64_t seq;
+		ke::Function<void()> task;
+	};
+	static bool Compare(const Entry &a, const Entry &b);
+
+private:
+	std::vector<Entry> heap_;
+	std::vector<Entry> incoming_;
+	unsigned int budget_us_;
+	uint64_t seq_;
+	uint64_t executed_;
+	uint64_t deferred_;
+	uint64_t overruns_;
+};
+
+// Registered queues are run after the next-frame tasks every frame.
+void RegisterBudgetedTaskQueue(BudgetedTaskQueue *queue);
+void UnregisterBudgetedTaskQueue(BudgetedTaskQueue *queue);
+
+// Shared queue used by RequestFrameBudgeted.
+BudgetedTaskQueue *GetDefaultBudgetedTaskQueue();
+
 }
 
 #endif // _include_sourcemod_logic_frame_tasks_h_
@@ -32,6 +32,7 @@
 #include "common_logic.h"
 #include <IAdminSystem.h>
 #include <IForwardSys.h>
+#include "AdminCache.h"
 
 using namespace SourceMod;
 
@@ -362,6 +363,41 @@ static cell_t RemoveAdmin(IPluginContext *pContext, const cell_t *params)
 	return adminsys->InvalidateAdmin(id);
 }
 
+static cell_t RemoveAdminByIdentity(IPluginContext *pContext, const cell_t *params)
+{
+	char *auth, *identity;
+	pContext->LocalToString(params[1], &auth);
+	pContext->LocalToString(params[2], &identity);
+
+	return g_Admins.RemoveAdminByIdentity(auth, identity) ? 1 : 0;
+}
+
+static cell_t RecheckAdminIdentity(IPluginContext *pContext, const cell_t *params)
+{
+	char *auth, *identity;
+	pContext->LocalToString(params[1], &auth);
+	pContext->LocalToString(params[2], &identity);
+
+	int changed = g_Admins.RecheckIdentity(auth, identity);
+	if (changed < 0)
+	{
+		return pContext->ThrowNativeError("Invalid auth method \"%s\"", auth);
+	}
+
+	return changed;
+}
+
+static cell_t RemoveAdmGroup(IPluginContext *pContext, const cell_t *params)
+{
+	adminsys->InvalidateGroup(params[1]);
+	return 1;
+}
+
+static cell_t RefreshAdmGroupMembers(IPluginContext *pContext, const cell_t *params)
+{
+	return g_Admins.RefreshGroupMembers(params[1]);
+}
+
 static cell_t FlagBitsToBitArray(IPluginContext *pContext, const cell_t *params)
 {
 	FlagBits bits = (FlagBits)params[1];
@@ -571,6 +607,10 @@ REGISTER_NATIVES(adminNatives)
 	{"GetAdminPassword",		GetAdminPassword},
 	{"FindAdminByIdentity",		FindAdminByIdentity},
 	{"RemoveAdmin",				RemoveAdmin},
+	{"RemoveAdminByIdentity",	RemoveAdminByIdentity},
+	{"RecheckAdminIdentity",	RecheckAdminIdentity},
+	{"RemoveAdmGroup",			RemoveAdmGroup},
+	{"RefreshAdmGroupMembers",	RefreshAdmGroupMembers},
 	{"FlagBitsToBitArray",		FlagBitsToBitArray},
 	{"FlagBitArrayToBits",		FlagBitArrayToBits},
 	{"FlagArrayToBits",			FlagArrayToBits},
@@ -608,6 +648,8 @@ REGISTER_NATIVES(adminNatives)
 	{"GroupId.GroupImmunitiesCount.get",	GetAdmGroupImmuneCount},
 	{"GroupId.ImmunityLevel.get",	GetAdmGroupImmunityLevel},
 	{"GroupId.ImmunityLevel.set",   SetAdmGroupImmunityLevel},
+	{"GroupId.Remove",				RemoveAdmGroup},
+	{"GroupId.RefreshMembers",		RefreshAdmGroupMembers},
 	/* -------------------------------------------------- */
 	{NULL,						NULL},
 };
@@ -38,6 +38,7 @@
 #include <sm_hashmap.h>
 #include "sm_memtable.h"
 #include <IHandleSys.h>
+#include "smn_adt_trie.h"
 
 HandleType_t htCellTrie;
 HandleType_t htSnapshot;
@@ -294,6 +295,63 @@ static cell_t CreateTrie(IPluginContext *pContext, const cell_t *params)
 	return hndl;
 }
 
+Handle_t CreateStringMapFromPairs(IdentityToken_t *owner, const StringPairList &pairs)
+{
+	CellTrie *pTrie = new CellTrie;
+
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		const char *key = pairs[i].first.c_str();
+		StringHashMap<Entry>::Insert ins = pTrie->map.findForAdd(key);
+		if (!ins.found() && !pTrie->map.add(ins, key))
+			continue;
+		ins->value.setString(pairs[i].second.c_str());
+	}
+
+	Handle_t hndl;
+	if ((hndl = handlesys->CreateHandle(htCellTrie, pTrie, owner, g_pCoreIdent, NULL))
+		== BAD_HANDLE)
+	{
+		delete pTrie;
+		return BAD_HANDLE;
+	}
+
+	return hndl;
+}
+
+cell_t SetStringMapStrings(IPluginContext *pContext, Handle_t hndl, const StringPairList &pairs, bool replace)
+{
+	CellTrie *pTrie;
+	HandleError err;
+	HandleSecurity sec = HandleSecurity(pContext->GetIdentity(), g_pCoreIdent);
+
+	if ((err = handlesys->ReadHandle(hndl, htCellTrie, &sec, (void **)&pTrie))
+		!= HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	cell_t stored = 0;
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		const char *key = pairs[i].first.c_str();
+		StringHashMap<Entry>::Insert ins = pTrie->map.findForAdd(key);
+		if (!ins.found())
+		{
+			if (!pTrie->map.add(ins, key))
+				continue;
+		}
+		else if (!replace)
+		{
+			continue;
+		}
+		ins->value.setString(pairs[i].second.c_str());
+		stored++;
+	}
+
+	return stored;
+}
+
 static cell_t CreateIntTrie(IPluginContext *pContext, const cell_t *params)
 {
 	IntCellTrie *pTrie = new IntCellTrie;
@@ -0,0 +1,63 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#ifndef _INCLUDE_SOURCEMOD_ADT_TRIE_H_
+#define _INCLUDE_SOURCEMOD_ADT_TRIE_H_
+
+#include <IHandleSys.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace SourceMod;
+
+extern HandleType_t htCellTrie;
+
+typedef std::vector<std::pair<std::string, std::string>> StringPairList;
+
+/**
+ * Creates a StringMap owned by the given identity and fills it with string
+ * values. Later duplicates of a key replace earlier ones.
+ *
+ * @return          New handle, or BAD_HANDLE on failure.
+ */
+Handle_t CreateStringMapFromPairs(IdentityToken_t *owner, const StringPairList &pairs);
+
+/**
+ * Stores string values into a plugin's StringMap. Throws a native error on
+ * an invalid handle.
+ *
+ * @param replace   If false, existing keys are left untouched.
+ * @return          Number of values stored.
+ */
+cell_t SetStringMapStrings(IPluginContext *pContext, Handle_t hndl, const StringPairList &pairs, bool replace);
+
+#endif //_INCLUDE_SOURCEMOD_ADT_TRIE_H_
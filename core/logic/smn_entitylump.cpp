@@ -121,6 +121,31 @@ cell_t sm_LumpManagerLength(IPluginContext *pContext, const cell_t *params) {
 	return lumpmanager->Length();
 }
 
+static cell_t FindLumpEntry(IPluginContext *pContext, EntityLumpIndexKey key, const char *value, int start) {
+	if (start < -1 || start >= static_cast<int>(lumpmanager->Length())) {
+		return pContext->ThrowNativeError("Invalid start index %d", start);
+	}
+	return lumpmanager->Find(key, value, start);
+}
+
+cell_t sm_LumpManagerFindByClassname(IPluginContext *pContext, const cell_t *params) {
+	char *classname;
+	pContext->LocalToString(params[1], &classname);
+	return FindLumpEntry(pContext, Index_Classname, classname, params[2]);
+}
+
+cell_t sm_LumpManagerFindByTargetname(IPluginContext *pContext, const cell_t *params) {
+	char *targetname;
+	pContext->LocalToString(params[1], &targetname);
+	return FindLumpEntry(pContext, Index_Targetname, targetname, params[2]);
+}
+
+cell_t sm_LumpManagerFindByHammerId(IPluginContext *pContext, const cell_t *params) {
+	char hammerid[12];
+	snprintf(hammerid, sizeof(hammerid), "%d", params[1]);
+	return FindLumpEntry(pContext, Index_HammerId, hammerid, params[2]);
+}
+
 cell_t sm_LumpEntryGet(IPluginContext *pContext, const cell_t *params) {
 	HandleSecurity sec(pContext->GetIdentity(), g_pCoreIdent);
 	HandleError err;
@@ -189,6 +214,7 @@ cell_t sm_LumpEntryUpdate(IPluginContext *pContext, const cell_t *params) {
 	if (value != nullptr) {
 		pair.second = value;
 	}
+	lumpmanager->InvalidateIndex();
 	
 	return 0;
 }
@@ -224,6 +250,7 @@ cell_t sm_LumpEntryInsert(IPluginContext *pContext, const cell_t *params) {
 	pContext->LocalToString(params[4], &value);
 	
 	entry->emplace(entry->begin() + index, key, value);
+	lumpmanager->InvalidateIndex();
 	
 	return 0;
 }
@@ -255,6 +282,7 @@ cell_t sm_LumpEntryErase(IPluginContext *pContext, const cell_t *params) {
 	}
 	
 	entry->erase(entry->begin() + index);
+	lumpmanager->InvalidateIndex();
 	
 	return 0;
 }
@@ -285,6 +313,7 @@ cell_t sm_LumpEntryAppend(IPluginContext *pContext, const cell_t *params) {
 	pContext->LocalToString(params[3], &value);
 	
 	entry->emplace_back(key, value);
+	lumpmanager->InvalidateIndex();
 	
 	return 0;
 }
@@ -354,6 +383,9 @@ REGISTER_NATIVES(entityLumpNatives)
 	{ "EntityLump.Insert", sm_LumpManagerInsert },
 	{ "EntityLump.Append", sm_LumpManagerAppend },
 	{ "EntityLump.Length", sm_LumpManagerLength },
+	{ "EntityLump.FindByClassname", sm_LumpManagerFindByClassname },
+	{ "EntityLump.FindByTargetname", sm_LumpManagerFindByTargetname },
+	{ "EntityLump.FindByHammerId", sm_LumpManagerFindByHammerId },
 	
 	{ "EntityLumpEntry.Get", sm_LumpEntryGet },
 	{ "EntityLumpEntry.Update", sm_LumpEntryUpdate },
@@ -43,8 +43,11 @@
 #include "sprintf.h"
 #include <am-utility.h>
 #include "handle_helpers.h"
+#include "CellArray.h"
+#include "smn_adt_trie.h"
 #include <bridge/include/IFileSystemBridge.h>
 #include <bridge/include/CoreProvider.h>
+#include <string>
 
 #if defined PLATFORM_WINDOWS
 #include <io.h>
@@ -58,6 +61,10 @@
 #define FPERM_O_READ		0x0004	/* Anyone can read. */
 #define FPERM_O_WRITE		0x0002	/* Anyone can write. */
 #define FPERM_O_EXEC		0x0001	/* Anyone can exec. */
+#elif defined PLATFORM_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 HandleType_t g_FileType;
@@ -67,6 +74,7 @@ IChangeableForward *g_pLogHook = NULL;
 
 class ValveFile;
 class SystemFile;
+class MappedFile;
 
 class FileObject
 {
@@ -89,6 +97,9 @@ public:
 	virtual SystemFile *AsSystemFile() {
 		return NULL;
 	}
+	virtual MappedFile *AsMappedFile() {
+		return NULL;
+	}
 };
 
 class ValveFile : public FileObject
@@ -253,6 +264,168 @@ private:
 	FILE *fp_;
 };
 
+// Read-only view of a local file mapped into memory. Reads never go through
+// stdio, which makes bulk line reads over large files cheap.
+class MappedFile : public FileObject
+{
+public:
+	~MappedFile() {
+		Close();
+	}
+
+	static MappedFile *Open(const char *path) {
+#if defined PLATFORM_WINDOWS
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return NULL;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.HighPart != 0) {
+			CloseHandle(file);
+			return NULL;
+		}
+
+		const char *data = NULL;
+		if (size.LowPart) {
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			CloseHandle(file);
+			if (!mapping)
+				return NULL;
+			data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			if (!data)
+				return NULL;
+		} else {
+			CloseHandle(file);
+		}
+		return new MappedFile(data, size.LowPart);
+#elif defined PLATFORM_POSIX
+		int fd = open(path, O_RDONLY);
+		if (fd == -1)
+			return NULL;
+
+		struct stat s;
+		if (fstat(fd, &s) != 0 || !S_ISREG(s.st_mode)) {
+			close(fd);
+			return NULL;
+		}
+
+		const char *data = NULL;
+		if (s.st_size) {
+			void *addr = mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (addr == MAP_FAILED) {
+				close(fd);
+				return NULL;
+			}
+			data = (const char *)addr;
+		}
+		close(fd);
+		return new MappedFile(data, s.st_size);
+#endif
+	}
+
+	size_t Size() override {
+		return size_;
+	}
+	size_t Read(void *pOut, int size) override {
+		size_t count = size < 0 ? 0 : (size_t)size;
+		if (count > size_ - pos_) {
+			count = size_ - pos_;
+			eof_ = true;
+		}
+		memcpy(pOut, data_ + pos_, count);
+		pos_ += count;
+		return count;
+	}
+	char *ReadLine(char *pOut, int size) override {
+		if (size <= 0)
+			return NULL;
+		if (pos_ >= size_) {
+			eof_ = true;
+			return NULL;
+		}
+
+		// Same contract as fgets(): stop after a newline or size - 1 chars.
+		size_t max = (size_t)size - 1;
+		size_t avail = size_ - pos_;
+		if (max > avail)
+			max = avail;
+		const char *start = data_ + pos_;
+		const char *nl = (const char *)memchr(start, '\n', max);
+		size_t count = nl ? (size_t)(nl - start) + 1 : max;
+		memcpy(pOut, start, count);
+		pOut[count] = '\0';
+		pos_ += count;
+		return pOut;
+	}
+	size_t Write(const void *pData, int size) override {
+		return 0;
+	}
+	bool Seek(int pos, int seek_type) override {
+		long base;
+		switch (seek_type) {
+			case SEEK_SET: base = 0; break;
+			case SEEK_CUR: base = (long)pos_; break;
+			case SEEK_END: base = (long)size_; break;
+			default: return false;
+		}
+		if (base + pos < 0 || size_t(base + pos) > size_)
+			return false;
+		pos_ = size_t(base + pos);
+		eof_ = false;
+		return true;
+	}
+	int Tell() override {
+		return (int)pos_;
+	}
+	bool HasError() override {
+		return false;
+	}
+	bool Flush() override {
+		return true;
+	}
+	bool EndOfFile() override {
+		return eof_;
+	}
+	void Close() override {
+		if (!data_)
+			return;
+#if defined PLATFORM_WINDOWS
+		UnmapViewOfFile(data_);
+#elif defined PLATFORM_POSIX
+		munmap((void *)data_, size_);
+#endif
+		data_ = NULL;
+	}
+	virtual MappedFile *AsMappedFile() {
+		return this;
+	}
+
+	// Direct access to the unread part of the file.
+	const char *cursor() const {
+		return data_ + pos_;
+	}
+	size_t remaining() const {
+		return size_ - pos_;
+	}
+	void advance(size_t count) {
+		pos_ += count;
+		if (pos_ >= size_)
+			eof_ = true;
+	}
+
+private:
+	MappedFile(const char *data, size_t size)
+	: data_(data), size_(size), pos_(0), eof_(false)
+	{}
+
+private:
+	const char *data_;
+	size_t size_;
+	size_t pos_;
+	bool eof_;
+};
+
 struct ValveDirectory
 {
 	FileFindHandle_t hndl = -1;
@@ -503,7 +676,12 @@ static cell_t sm_OpenFile(IPluginContext *pContext, const cell_t *params)
 	if (params[0] <= 2 || !params[3]) {
 		char realpath[PLATFORM_MAX_PATH];
 		g_pSM->BuildPath(Path_Game, realpath, sizeof(realpath), "%s", name);
-		file = SystemFile::Open(realpath, mode);
+
+		// "m" requests a memory-mapped, read-only file.
+		if (mode[0] == 'r' && strchr(mode, 'm') && !strchr(mode, '+'))
+			file = MappedFile::Open(realpath);
+		else
+			file = SystemFile::Open(realpath, mode);
 	} else {
 		char *pathID;
 		pContext->LocalToStringNULL(params[4], &pathID);
@@ -854,7 +1032,7 @@ static cell_t sm_WriteFileLine(IPluginContext *pContext, const cell_t *params)
 		bridge->filesystem->FPrint(vfile->handle(), buffer);
 		bridge->filesystem->FPrint(vfile->handle(), "\n");
 	} else {
-		assert(false);
+		return pContext->ThrowNativeError("Cannot write to a read-only, memory-mapped file");
 	}
 
 	return 1;
@@ -979,7 +1157,7 @@ static cell_t sm_LogToOpenFile(IPluginContext *pContext, const cell_t *params)
 
 	SystemFile *sysfile = file->AsSystemFile();
 	if (!sysfile)
-		return pContext->ThrowNativeError("Cannot log to files in the Valve file system");
+		return pContext->ThrowNativeError("Can only log to writable files outside the Valve file system (not memory-mapped)");
 
 	char buffer[2048];
 	g_pSM->SetGlobalTarget(SOURCEMOD_SERVER_LANGUAGE);
@@ -1004,7 +1182,7 @@ static cell_t sm_LogToOpenFileEx(IPluginContext *pContext, const cell_t *params)
 
 	SystemFile *sysfile = file->AsSystemFile();
 	if (!sysfile)
-		return pContext->ThrowNativeError("Cannot log to files in the Valve file system");
+		return pContext->ThrowNativeError("Can only log to writable files outside the Valve file system (not memory-mapped)");
 
 	char buffer[2048];
 	g_pSM->SetGlobalTarget(SOURCEMOD_SERVER_LANGUAGE);
@@ -1019,6 +1197,131 @@ static cell_t sm_LogToOpenFileEx(IPluginContext *pContext, const cell_t *params)
 	return 1;
 }
 
+// Reads |count| values of type T in one go and zero/sign-extends them into
+// cells. The values are read into the tail of the output buffer first, then
+// widened front to back, so no temporary buffer is needed.
+template <typename T>
+static size_t ReadWidened(FileObject *file, cell_t *data, cell_t count)
+{
+	if (count <= 0)
+		return 0;
+
+	T *raw = reinterpret_cast<T *>(data + count) - count;
+	size_t read = file->Read(raw, sizeof(T) * count);
+	size_t values = read / sizeof(T);
+	for (size_t i = 0; i < values; i++)
+		data[i] = raw[i];
+	return values * sizeof(T);
+}
+
+// Reads one line, however long, without its line terminator. Returns false
+// at end of file.
+static bool ReadWholeLine(FileObject *file, std::string &line)
+{
+	line.clear();
+
+	if (MappedFile *mapped = file->AsMappedFile()) {
+		size_t avail = mapped->remaining();
+		if (!avail)
+			return false;
+		const char *start = mapped->cursor();
+		const char *nl = (const char *)memchr(start, '\n', avail);
+		size_t len = nl ? (size_t)(nl - start) : avail;
+		line.assign(start, len);
+		mapped->advance(nl ? len + 1 : len);
+	} else {
+		char buffer[1024];
+		bool any = false;
+		while (file->ReadLine(buffer, sizeof(buffer))) {
+			any = true;
+			line += buffer;
+			if (!line.empty() && line.back() == '\n')
+				break;
+		}
+		if (!any)
+			return false;
+		if (!line.empty() && line.back() == '\n')
+			line.pop_back();
+	}
+
+	if (!line.empty() && line.back() == '\r')
+		line.pop_back();
+	return true;
+}
+
+static void TrimWhitespace(std::string &str)
+{
+	size_t start = 0;
+	while (start < str.size() && textparsers->IsWhitespace(&str[start]))
+		start++;
+	size_t end = str.size();
+	while (end > start && textparsers->IsWhitespace(&str[end - 1]))
+		end--;
+	str = str.substr(start, end - start);
+}
+
+static cell_t File_ReadLines(IPluginContext *pContext, const cell_t *params)
+{
+	OpenHandle<FileObject> file(pContext, params[1], g_FileType);
+	if (!file.Ok())
+		return 0;
+
+	OpenHandle<ICellArray> array(pContext, params[2], htCellArray);
+	if (!array.Ok())
+		return 0;
+
+	cell_t maxlines = params[3];
+	bool skipEmpty = !!params[4];
+	size_t maxbytes = array->blocksize() * sizeof(cell_t);
+
+	cell_t count = 0;
+	std::string line;
+	while ((maxlines < 0 || count < maxlines) && ReadWholeLine(file, line)) {
+		if (skipEmpty && line.empty())
+			continue;
+
+		cell_t *blk = array->push();
+		if (!blk)
+			return pContext->ThrowNativeError("Failed to grow array");
+
+		ke::SafeStrcpy((char *)blk, maxbytes, line.c_str());
+		count++;
+	}
+
+	return count;
+}
+
+static cell_t File_ReadKeyValuePairs(IPluginContext *pContext, const cell_t *params)
+{
+	OpenHandle<FileObject> file(pContext, params[1], g_FileType);
+	if (!file.Ok())
+		return 0;
+
+	char *delim;
+	pContext->LocalToString(params[3], &delim);
+	size_t delimlen = strlen(delim);
+	if (!delimlen)
+		return pContext->ThrowNativeError("Delimiter cannot be empty");
+
+	StringPairList pairs;
+	std::string line;
+	while (ReadWholeLine(file, line)) {
+		size_t pos = line.find(delim);
+		if (pos == std::string::npos)
+			continue;
+
+		std::string key = line.substr(0, pos);
+		std::string value = line.substr(pos + delimlen);
+		TrimWhitespace(key);
+		TrimWhitespace(value);
+		if (key.empty())
+			continue;
+		pairs.emplace_back(std::move(key), std::move(value));
+	}
+
+	return SetStringMapStrings(pContext, params[2], pairs, !!params[4]);
+}
+
 static cell_t sm_ReadFile(IPluginContext *pContext, const cell_t *params)
 {
 	OpenHandle<FileObject> file(pContext, params[1], g_FileType);
@@ -1035,23 +1338,11 @@ static cell_t sm_ReadFile(IPluginContext *pContext, const cell_t *params)
 			break;
 
 		case 2:
-			for (cell_t i = 0; i < params[3]; i++) {
-				uint16_t val;
-				if (file->Read(&val, sizeof(val)) != sizeof(val))
-					break;
-				read += sizeof(val);
-				*data++ = val;
-			}
+			read = ReadWidened<uint16_t>(file, data, params[3]);
 			break;
 
 		case 1:
-			for (cell_t i = 0; i < params[3]; i++) {
-				uint8_t val;
-				if (file->Read(&val, sizeof(val)) != sizeof(val))
-					break;
-				read += sizeof(val);
-				*data++ = val;
-			}
+			read = ReadWidened<uint8_t>(file, data, params[3]);
 			break;
 
 		default:
@@ -1279,6 +1570,8 @@ REGISTER_NATIVES(filesystem)
 	{"File.ReadInt16",			File_ReadTyped<int16_t>},
 	{"File.ReadUint16",			File_ReadTyped<uint16_t>},
 	{"File.ReadInt32",			File_ReadTyped<int32_t>},
+	{"File.ReadLines",			File_ReadLines},
+	{"File.ReadKeyValuePairs",	File_ReadKeyValuePairs},
 	{"File.WriteInt8",			File_WriteTyped<int8_t>},
 	{"File.WriteInt16",			File_WriteTyped<int16_t>},
 	{"File.WriteInt32",			File_WriteTyped<int32_t>},
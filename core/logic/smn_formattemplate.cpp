@@ -0,0 +1,111 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#include "common_logic.h"
+#include <IHandleSys.h>
+#include "FormatTemplate.h"
+
+using namespace SourceMod;
+
+HandleType_t g_FormatTemplateType = 0;
+
+class FormatTemplateNatives :
+	public SMGlobalClass,
+	public IHandleTypeDispatch
+{
+public: //SMGlobalClass
+	void OnSourceModAllInitialized()
+	{
+		g_FormatTemplateType = handlesys->CreateType("FormatTemplate", this, 0, NULL, NULL, g_pCoreIdent, NULL);
+	}
+
+	void OnSourceModShutdown()
+	{
+		handlesys->RemoveType(g_FormatTemplateType, g_pCoreIdent);
+		g_FormatTemplateType = 0;
+	}
+public: //IHandleTypeDispatch
+	void OnHandleDestroy(HandleType_t type, void *object)
+	{
+		delete static_cast<FormatTemplate *>(object);
+	}
+
+	bool GetHandleApproxSize(HandleType_t type, void *object, unsigned int *pSize)
+	{
+		*pSize = (unsigned int)static_cast<FormatTemplate *>(object)->ApproxSize();
+		return true;
+	}
+} s_FormatTemplateNatives;
+
+static cell_t FormatTemplate_Ctor(IPluginContext *pContext, const cell_t *params)
+{
+	char *format;
+	pContext->LocalToString(params[1], &format);
+
+	FormatTemplate *tmpl = new FormatTemplate(format);
+	Handle_t hndl = handlesys->CreateHandle(g_FormatTemplateType, tmpl, pContext->GetIdentity(), g_pCoreIdent, NULL);
+	if (hndl == BAD_HANDLE)
+	{
+		delete tmpl;
+		return BAD_HANDLE;
+	}
+
+	return hndl;
+}
+
+static cell_t FormatTemplate_Format(IPluginContext *pContext, const cell_t *params)
+{
+	HandleSecurity sec(pContext->GetIdentity(), g_pCoreIdent);
+	HandleError err;
+	FormatTemplate *tmpl;
+
+	if ((err = handlesys->ReadHandle(params[1], g_FormatTemplateType, &sec, (void **)&tmpl))
+		!= HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error: %d)", params[1], err);
+	}
+
+	/* Like FormatEx, the buffer must not also be passed as an argument. */
+	char *buf;
+	int arg = 4;
+	pContext->LocalToString(params[2], &buf);
+
+	return (cell_t)tmpl->Render(buf, static_cast<size_t>(params[3]), pContext, params, &arg);
+}
+
+REGISTER_NATIVES(formatTemplateNatives)
+{
+	{"FormatTemplate.FormatTemplate",   FormatTemplate_Ctor},
+	{"FormatTemplate.Format",           FormatTemplate_Format},
+
+	{NULL,                              NULL},
+};
@@ -0,0 +1,262 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#include "common_logic.h"
+#include <IPluginSys.h>
+#include <IHandleSys.h>
+#include "frame_tasks.h"
+
+using namespace SourceMod;
+
+HandleType_t g_FrameTaskQueueType = 0;
+
+class FrameTaskNatives :
+	public SMGlobalClass,
+	public IHandleTypeDispatch
+{
+public: //SMGlobalClass
+	void OnSourceModAllInitialized()
+	{
+		g_FrameTaskQueueType = handlesys->CreateType("FrameTaskQueue", this, 0, NULL, NULL, g_pCoreIdent, NULL);
+	}
+
+	void OnSourceModShutdown()
+	{
+		handlesys->RemoveType(g_FrameTaskQueueType, g_pCoreIdent);
+		g_FrameTaskQueueType = 0;
+	}
+
+	ConfigResult OnSourceModConfigChanged(const char *key,
+		const char *value,
+		ConfigSource source,
+		char *error,
+		size_t maxlength)
+	{
+		if (strcmp(key, "FrameTaskBudget") == 0)
+		{
+			int budget = atoi(value);
+			if (budget <= 0)
+			{
+				ke::SafeStrcpy(error, maxlength, "Invalid value: must be a positive number of microseconds");
+				return ConfigResult_Reject;
+			}
+			GetDefaultBudgetedTaskQueue()->set_budget(budget);
+			return ConfigResult_Accept;
+		}
+		return ConfigResult_Ignore;
+	}
+public: //IHandleTypeDispatch
+	void OnHandleDestroy(HandleType_t type, void *object)
+	{
+		BudgetedTaskQueue *queue = static_cast<BudgetedTaskQueue *>(object);
+		queue->Cancel();
+		UnregisterBudgetedTaskQueue(queue);
+		queue->Release();
+	}
+
+	bool GetHandleApproxSize(HandleType_t type, void *object, unsigned int *pSize)
+	{
+		BudgetedTaskQueue *queue = static_cast<BudgetedTaskQueue *>(object);
+		*pSize = sizeof(BudgetedTaskQueue) + (unsigned int)queue->Pending() * 32;
+		return true;
+	}
+} s_FrameTaskNatives;
+
+/* The callback is looked up again when the task runs, so a plugin that has
+ * been unloaded in the meantime is simply skipped.
+ */
+static bool PushPawnTask(IPluginContext *pContext, BudgetedTaskQueue *queue, funcid_t funcid, cell_t data, int priority)
+{
+	IPlugin *pPlugin = pluginsys->FindPluginByContext(pContext->GetContext());
+	if (!pPlugin->GetBaseContext()->GetFunctionById(funcid))
+	{
+		pContext->ReportError("Invalid function id (%X)", funcid);
+		return false;
+	}
+
+	Handle_t owner = pPlugin->GetMyHandle();
+	queue->Push(priority, [owner, funcid, data]() -> void {
+		IPlugin *pPlugin = pluginsys->PluginFromHandle(owner, NULL);
+		if (!pPlugin)
+			return;
+
+		IPluginFunction *pFunction = pPlugin->GetBaseContext()->GetFunctionById(funcid);
+		if (!pFunction)
+			return;
+
+		pFunction->PushCell(data);
+		pFunction->Execute(NULL);
+	});
+	return true;
+}
+
+static BudgetedTaskQueue *ReadQueue(IPluginContext *pContext, Handle_t hndl)
+{
+	HandleSecurity sec(pContext->GetIdentity(), g_pCoreIdent);
+	HandleError err;
+	BudgetedTaskQueue *queue;
+
+	if ((err = handlesys->ReadHandle(hndl, g_FrameTaskQueueType, &sec, (void **)&queue))
+		!= HandleError_None)
+	{
+		pContext->ReportError("Invalid Handle %x (error: %d)", hndl, err);
+		return NULL;
+	}
+	return queue;
+}
+
+static cell_t sm_RequestFrameBudgeted(IPluginContext *pContext, const cell_t *params)
+{
+	PushPawnTask(pContext, GetDefaultBudgetedTaskQueue(), params[1], params[2], params[3]);
+	return 0;
+}
+
+static cell_t sm_GetFrameTaskStats(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = GetDefaultBudgetedTaskQueue();
+
+	cell_t *deferred, *overruns;
+	pContext->LocalToPhysAddr(params[1], &deferred);
+	pContext->LocalToPhysAddr(params[2], &overruns);
+	*deferred = (cell_t)queue->deferred();
+	*overruns = (cell_t)queue->overruns();
+
+	return (cell_t)queue->Pending();
+}
+
+static cell_t FrameTaskQueue_Ctor(IPluginContext *pContext, const cell_t *params)
+{
+	if (params[1] <= 0)
+	{
+		return pContext->ThrowNativeError("Invalid frame budget: %d", params[1]);
+	}
+
+	/* The handle holds one reference; the frame registry takes its own. */
+	BudgetedTaskQueue *queue = new BudgetedTaskQueue(params[1]);
+	queue->AddRef();
+
+	Handle_t hndl = handlesys->CreateHandle(g_FrameTaskQueueType, queue, pContext->GetIdentity(), g_pCoreIdent, NULL);
+	if (hndl == BAD_HANDLE)
+	{
+		queue->Release();
+		return BAD_HANDLE;
+	}
+
+	RegisterBudgetedTaskQueue(queue);
+	return hndl;
+}
+
+static cell_t FrameTaskQueue_Push(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = ReadQueue(pContext, params[1]);
+	if (!queue)
+		return 0;
+
+	PushPawnTask(pContext, queue, params[2], params[3], params[4]);
+	return 0;
+}
+
+static cell_t FrameTaskQueue_Cancel(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = ReadQueue(pContext, params[1]);
+	if (!queue)
+		return 0;
+
+	return (cell_t)queue->Cancel();
+}
+
+static cell_t FrameTaskQueue_Pending_get(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = ReadQueue(pContext, params[1]);
+	if (!queue)
+		return 0;
+
+	return (cell_t)queue->Pending();
+}
+
+static cell_t FrameTaskQueue_Budget_get(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = ReadQueue(pContext, params[1]);
+	if (!queue)
+		return 0;
+
+	return (cell_t)queue->budget();
+}
+
+static cell_t FrameTaskQueue_Budget_set(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = ReadQueue(pContext, params[1]);
+	if (!queue)
+		return 0;
+
+	if (params[2] <= 0)
+	{
+		return pContext->ThrowNativeError("Invalid frame budget: %d", params[2]);
+	}
+
+	queue->set_budget(params[2]);
+	return 0;
+}
+
+static cell_t FrameTaskQueue_Deferred_get(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = ReadQueue(pContext, params[1]);
+	if (!queue)
+		return 0;
+
+	return (cell_t)queue->deferred();
+}
+
+static cell_t FrameTaskQueue_Overruns_get(IPluginContext *pContext, const cell_t *params)
+{
+	BudgetedTaskQueue *queue = ReadQueue(pContext, params[1]);
+	if (!queue)
+		return 0;
+
+	return (cell_t)queue->overruns();
+}
+
+REGISTER_NATIVES(frameTaskNatives)
+{
+	{"RequestFrameBudgeted",            sm_RequestFrameBudgeted},
+	{"GetFrameTaskStats",               sm_GetFrameTaskStats},
+
+	{"FrameTaskQueue.FrameTaskQueue",   FrameTaskQueue_Ctor},
+	{"FrameTaskQueue.Push",             FrameTaskQueue_Push},
+	{"FrameTaskQueue.Cancel",           FrameTaskQueue_Cancel},
+	{"FrameTaskQueue.Pending.get",      FrameTaskQueue_Pending_get},
+	{"FrameTaskQueue.Budget.get",       FrameTaskQueue_Budget_get},
+	{"FrameTaskQueue.Budget.set",       FrameTaskQueue_Budget_set},
+	{"FrameTaskQueue.Deferred.get",     FrameTaskQueue_Deferred_get},
+	{"FrameTaskQueue.Overruns.get",     FrameTaskQueue_Overruns_get},
+
+	{NULL,                              NULL},
+};
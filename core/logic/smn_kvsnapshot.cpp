@@ -0,0 +1,273 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#include "common_logic.h"
+#include <IHandleSys.h>
+#include <ISourceMod.h>
+#include <bridge/include/CoreProvider.h>
+#include "KeyValueSnapshot.h"
+#include "smn_adt_trie.h"
+
+HandleType_t g_KeyValueSnapshotType = 0;
+
+class KeyValueSnapshotNatives :
+	public SMGlobalClass,
+	public IHandleTypeDispatch
+{
+public: //SMGlobalClass
+	void OnSourceModAllInitialized()
+	{
+		g_KeyValueSnapshotType = handlesys->CreateType("KeyValuesSnapshot", this, 0, NULL, NULL, g_pCoreIdent, NULL);
+	}
+
+	void OnSourceModShutdown()
+	{
+		handlesys->RemoveType(g_KeyValueSnapshotType, g_pCoreIdent);
+		g_KeyValueSnapshotType = 0;
+	}
+public: //IHandleTypeDispatch
+	void OnHandleDestroy(HandleType_t type, void *object)
+	{
+		delete static_cast<KeyValueSnapshot *>(object);
+	}
+
+	bool GetHandleApproxSize(HandleType_t type, void *object, unsigned int *pSize)
+	{
+		*pSize = (unsigned int)static_cast<KeyValueSnapshot *>(object)->GetMemUsage();
+		return true;
+	}
+} s_KeyValueSnapshotNatives;
+
+Handle_t CreateKeyValueSnapshotHandle(IdentityToken_t *owner, KeyValueSnapshot *snapshot)
+{
+	Handle_t hndl = handlesys->CreateHandle(g_KeyValueSnapshotType, snapshot, owner, g_pCoreIdent, NULL);
+	if (hndl == BAD_HANDLE)
+		delete snapshot;
+	return hndl;
+}
+
+static KeyValueSnapshot *ReadSnapshot(IPluginContext *pContext, Handle_t hndl)
+{
+	HandleSecurity sec(pContext->GetIdentity(), g_pCoreIdent);
+	HandleError err;
+	KeyValueSnapshot *snapshot;
+
+	if ((err = handlesys->ReadHandle(hndl, g_KeyValueSnapshotType, &sec, (void **)&snapshot))
+		!= HandleError_None)
+	{
+		pContext->ReportError("Invalid Handle %x (error: %d)", hndl, err);
+		return NULL;
+	}
+	return snapshot;
+}
+
+/* Looks up a value node; sections and missing keys both return NULL. */
+static const char *FindValue(IPluginContext *pContext, KeyValueSnapshot *snapshot, cell_t path_addr)
+{
+	char *path;
+	pContext->LocalToString(path_addr, &path);
+
+	uint32_t node = snapshot->Find(path);
+	if (node == KeyValueSnapshot::kInvalidNode)
+		return NULL;
+	return snapshot->GetValue(node);
+}
+
+static void CollectPairs(KeyValueSnapshot *snapshot, uint32_t section, const std::string &prefix,
+	bool recursive, StringPairList &pairs)
+{
+	for (uint32_t node = snapshot->FirstChild(section);
+		 node != KeyValueSnapshot::kInvalidNode;
+		 node = snapshot->NextSibling(node))
+	{
+		if (!snapshot->IsSection(node))
+		{
+			pairs.emplace_back(prefix + snapshot->GetName(node), snapshot->GetValue(node));
+		}
+		else if (recursive)
+		{
+			std::string sub_prefix = prefix + snapshot->GetName(node);
+			sub_prefix += '/';
+			CollectPairs(snapshot, node, sub_prefix, recursive, pairs);
+		}
+	}
+}
+
+static cell_t KeyValuesSnapshot_Ctor(IPluginContext *pContext, const cell_t *params)
+{
+	HandleError err;
+	KeyValues *kv = g_pSM->ReadKeyValuesHandle(params[1], &err, false);
+	if (!kv)
+	{
+		return pContext->ThrowNativeError("Invalid KeyValues handle %x (error: %d)", params[1], err);
+	}
+
+	KeyValueSnapshotBuilder builder;
+	bridge->WalkKeyValues(kv, &builder);
+
+	KeyValueSnapshot *snapshot = builder.Finish();
+	if (!snapshot)
+		return BAD_HANDLE;
+
+	return CreateKeyValueSnapshotHandle(pContext->GetIdentity(), snapshot);
+}
+
+static cell_t KeyValuesSnapshot_FromFile(IPluginContext *pContext, const cell_t *params)
+{
+	char *file;
+	pContext->LocalToString(params[1], &file);
+
+	char path[PLATFORM_MAX_PATH];
+	g_pSM->BuildPath(Path_Game, path, sizeof(path), "%s", file);
+
+	KeyValueSnapshotBuilder builder;
+	if (textparsers->ParseFile_SMC(path, &builder, NULL) != SMCError_Okay)
+		return BAD_HANDLE;
+
+	KeyValueSnapshot *snapshot = builder.Finish();
+	if (!snapshot)
+		return BAD_HANDLE;
+
+	return CreateKeyValueSnapshotHandle(pContext->GetIdentity(), snapshot);
+}
+
+static cell_t KeyValuesSnapshot_HasKey(IPluginContext *pContext, const cell_t *params)
+{
+	KeyValueSnapshot *snapshot = ReadSnapshot(pContext, params[1]);
+	if (!snapshot)
+		return 0;
+
+	char *path;
+	pContext->LocalToString(params[2], &path);
+
+	return snapshot->Find(path) != KeyValueSnapshot::kInvalidNode ? 1 : 0;
+}
+
+static cell_t KeyValuesSnapshot_IsSection(IPluginContext *pContext, const cell_t *params)
+{
+	KeyValueSnapshot *snapshot = ReadSnapshot(pContext, params[1]);
+	if (!snapshot)
+		return 0;
+
+	char *path;
+	pContext->LocalToString(params[2], &path);
+
+	uint32_t node = snapshot->Find(path);
+	return (node != KeyValueSnapshot::kInvalidNode && snapshot->IsSection(node)) ? 1 : 0;
+}
+
+static cell_t KeyValuesSnapshot_GetString(IPluginContext *pContext, const cell_t *params)
+{
+	KeyValueSnapshot *snapshot = ReadSnapshot(pContext, params[1]);
+	if (!snapshot)
+		return 0;
+
+	const char *value = FindValue(pContext, snapshot, params[2]);
+	if (!value)
+	{
+		char *defvalue;
+		pContext->LocalToString(params[5], &defvalue);
+		pContext->StringToLocalUTF8(params[3], params[4], defvalue, NULL);
+		return 0;
+	}
+
+	pContext->StringToLocalUTF8(params[3], params[4], value, NULL);
+	return 1;
+}
+
+static cell_t KeyValuesSnapshot_GetNum(IPluginContext *pContext, const cell_t *params)
+{
+	KeyValueSnapshot *snapshot = ReadSnapshot(pContext, params[1]);
+	if (!snapshot)
+		return 0;
+
+	const char *value = FindValue(pContext, snapshot, params[2]);
+	if (!value)
+		return params[3];
+
+	return atoi(value);
+}
+
+static cell_t KeyValuesSnapshot_GetFloat(IPluginContext *pContext, const cell_t *params)
+{
+	KeyValueSnapshot *snapshot = ReadSnapshot(pContext, params[1]);
+	if (!snapshot)
+		return 0;
+
+	const char *value = FindValue(pContext, snapshot, params[2]);
+	if (!value)
+		return params[3];
+
+	return sp_ftoc((float)atof(value));
+}
+
+static cell_t KeyValuesSnapshot_ExportToStringMap(IPluginContext *pContext, const cell_t *params)
+{
+	KeyValueSnapshot *snapshot = ReadSnapshot(pContext, params[1]);
+	if (!snapshot)
+		return 0;
+
+	char *path;
+	pContext->LocalToString(params[2], &path);
+
+	uint32_t node = snapshot->Find(path);
+	if (node == KeyValueSnapshot::kInvalidNode || !snapshot->IsSection(node))
+		return 0;
+
+	StringPairList pairs;
+	CollectPairs(snapshot, node, std::string(), params[4] != 0, pairs);
+
+	return SetStringMapStrings(pContext, params[3], pairs, params[5] != 0);
+}
+
+static cell_t KeyValuesSnapshot_Size_get(IPluginContext *pContext, const cell_t *params)
+{
+	KeyValueSnapshot *snapshot = ReadSnapshot(pContext, params[1]);
+	if (!snapshot)
+		return 0;
+
+	return (cell_t)snapshot->size();
+}
+
+REGISTER_NATIVES(keyValueSnapshotNatives)
+{
+	{"KeyValuesSnapshot.KeyValuesSnapshot",     KeyValuesSnapshot_Ctor},
+	{"KeyValuesSnapshot.FromFile",              KeyValuesSnapshot_FromFile},
+	{"KeyValuesSnapshot.HasKey",                KeyValuesSnapshot_HasKey},
+	{"KeyValuesSnapshot.IsSection",             KeyValuesSnapshot_IsSection},
+	{"KeyValuesSnapshot.GetString",             KeyValuesSnapshot_GetString},
+	{"KeyValuesSnapshot.GetNum",                KeyValuesSnapshot_GetNum},
+	{"KeyValuesSnapshot.GetFloat",              KeyValuesSnapshot_GetFloat},
+	{"KeyValuesSnapshot.ExportToStringMap",     KeyValuesSnapshot_ExportToStringMap},
+	{"KeyValuesSnapshot.Size.get",              KeyValuesSnapshot_Size_get},
+	{NULL,                                      NULL},
+};
@@ -0,0 +1,414 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#include <algorithm>
+#include <string>
+
+#include "common_logic.h"
+#include <IHandleSys.h>
+#include <IPluginSys.h>
+#include <ITextParsers.h>
+#include <ISourceMod.h>
+#include "CellArray.h"
+#include "KeyValueSnapshot.h"
+#include "WorkerJobs.h"
+#include "sm_crc32.h"
+#include "smn_adt_trie.h"
+
+enum SortOrder
+{
+	Sort_Ascending = 0,
+	Sort_Descending = 1,
+	Sort_Random = 2,
+};
+
+enum SortType
+{
+	Sort_Integer = 0,
+	Sort_Float,
+	Sort_String,
+};
+
+/* Jobs call back into the plugin that submitted them. The function is looked
+ * up by id on the game thread, after the job finished, so nothing that belongs
+ * to the plugin is ever touched from a worker.
+ */
+class PawnWorkerJob : public IWorkerJob
+{
+public:
+	PawnWorkerJob(IPluginContext *pContext, funcid_t callback, cell_t data)
+		: callback_(callback), data_(data)
+	{
+		IPlugin *pPlugin = pluginsys->FindPluginByContext(pContext->GetContext());
+		owner_ = pPlugin->GetMyHandle();
+		ident_ = pContext->GetIdentity();
+	}
+
+	void RunThinkPart(int id) override
+	{
+		Handle_t result = CreateResult();
+
+		IPlugin *pPlugin = pluginsys->PluginFromHandle(owner_, NULL);
+		IPluginFunction *pFunction = pPlugin ? pPlugin->GetBaseContext()->GetFunctionById(callback_) : NULL;
+		if (!pFunction)
+		{
+			if (result != BAD_HANDLE)
+			{
+				HandleSecurity sec(ident_, g_pCoreIdent);
+				handlesys->FreeHandle(result, &sec);
+			}
+			return;
+		}
+
+		pFunction->PushCell(id);
+		pFunction->PushCell(result);
+		pFunction->PushCell(data_);
+		pFunction->Execute(NULL);
+	}
+
+protected:
+	/* Wraps the job's result into a handle owned by the plugin. */
+	virtual Handle_t CreateResult() =0;
+
+protected:
+	IdentityToken_t *ident_;
+	Handle_t owner_;
+	funcid_t callback_;
+	cell_t data_;
+};
+
+class ArrayResultJob : public PawnWorkerJob
+{
+public:
+	ArrayResultJob(IPluginContext *pContext, funcid_t callback, cell_t data, ICellArray *input)
+		: PawnWorkerJob(pContext, callback, data), input_(input), output_(NULL)
+	{
+	}
+	~ArrayResultJob()
+	{
+		delete input_;
+		delete output_;
+	}
+
+protected:
+	Handle_t CreateResult() override
+	{
+		if (!output_)
+			return BAD_HANDLE;
+
+		Handle_t hndl = handlesys->CreateHandle(htCellArray, output_, ident_, g_pCoreIdent, NULL);
+		if (hndl != BAD_HANDLE)
+			output_ = NULL;
+		return hndl;
+	}
+
+protected:
+	ICellArray *input_;
+	ICellArray *output_;
+};
+
+class SortArrayJob : public ArrayResultJob
+{
+public:
+	SortArrayJob(IPluginContext *pContext, funcid_t callback, cell_t data, ICellArray *input, int order, int type)
+		: ArrayResultJob(pContext, callback, data, input), order_(order), type_(type)
+	{
+	}
+
+	void RunThreadPart() override
+	{
+		size_t count = input_->size();
+		std::vector<size_t> order(count);
+		for (size_t i = 0; i < count; i++)
+			order[i] = i;
+
+		ICellArray *input = input_;
+		int type = type_;
+		size_t maxbytes = input_->blocksize() * sizeof(cell_t);
+		auto less = [input, type, maxbytes](size_t a, size_t b) -> bool {
+			cell_t *ea = input->at(a);
+			cell_t *eb = input->at(b);
+			switch (type)
+			{
+			case Sort_Float:
+				return sp_ctof(ea[0]) < sp_ctof(eb[0]);
+			case Sort_String:
+				return strncmp((const char *)ea, (const char *)eb, maxbytes) < 0;
+			default:
+				return ea[0] < eb[0];
+			}
+		};
+
+		if (order_ == Sort_Descending)
+			std::stable_sort(order.begin(), order.end(), [&less](size_t a, size_t b) { return less(b, a); });
+		else
+			std::stable_sort(order.begin(), order.end(), less);
+
+		size_t blocksize = input_->blocksize();
+		output_ = CellArray::New(blocksize);
+		if (!output_->resize(count))
+		{
+			delete output_;
+			output_ = NULL;
+			return;
+		}
+		for (size_t i = 0; i < count; i++)
+			memcpy(output_->at(i), input_->at(order[i]), blocksize * sizeof(cell_t));
+	}
+
+private:
+	int order_;
+	int type_;
+};
+
+class HashStringsJob : public ArrayResultJob
+{
+public:
+	HashStringsJob(IPluginContext *pContext, funcid_t callback, cell_t data, ICellArray *input)
+		: ArrayResultJob(pContext, callback, data, input)
+	{
+	}
+
+	void RunThreadPart() override
+	{
+		size_t count = input_->size();
+		size_t maxbytes = input_->blocksize() * sizeof(cell_t);
+
+		output_ = CellArray::New(1);
+		if (!output_->resize(count))
+		{
+			delete output_;
+			output_ = NULL;
+			return;
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			const char *str = (const char *)input_->at(i);
+			size_t len = strnlen(str, maxbytes);
+			*output_->at(i) = (cell_t)UTIL_CRC32(str, len);
+		}
+	}
+};
+
+class ParseConfigJob :
+	public PawnWorkerJob,
+	public ITextListener_SMC
+{
+public:
+	ParseConfigJob(IPluginContext *pContext, funcid_t callback, cell_t data, const char *path)
+		: PawnWorkerJob(pContext, callback, data), path_(path), ok_(false)
+	{
+	}
+
+	void RunThreadPart() override
+	{
+		SMCStates states;
+		ok_ = (textparsers->ParseFile_SMC(path_.c_str(), this, &states) == SMCError_Okay);
+	}
+
+public: //ITextListener_SMC
+	SMCResult ReadSMC_NewSection(const SMCStates *states, const char *name) override
+	{
+		sections_.push_back(prefix_.size());
+		prefix_ += name;
+		prefix_ += '/';
+		return SMCResult_Continue;
+	}
+	SMCResult ReadSMC_KeyValue(const SMCStates *states, const char *key, const char *value) override
+	{
+		pairs_.emplace_back(prefix_ + key, value);
+		return SMCResult_Continue;
+	}
+	SMCResult ReadSMC_LeavingSection(const SMCStates *states) override
+	{
+		if (!sections_.empty())
+		{
+			prefix_.resize(sections_.back());
+			sections_.pop_back();
+		}
+		return SMCResult_Continue;
+	}
+
+protected:
+	Handle_t CreateResult() override
+	{
+		if (!ok_)
+			return BAD_HANDLE;
+		return CreateStringMapFromPairs(ident_, pairs_);
+	}
+
+private:
+	std::string path_;
+	std::string prefix_;
+	std::vector<size_t> sections_;
+	StringPairList pairs_;
+	bool ok_;
+};
+
+class CompileKeyValuesJob : public PawnWorkerJob
+{
+public:
+	CompileKeyValuesJob(IPluginContext *pContext, funcid_t callback, cell_t data, const char *path)
+		: PawnWorkerJob(pContext, callback, data), path_(path)
+	{
+	}
+
+	void RunThreadPart() override
+	{
+		KeyValueSnapshotBuilder builder;
+		if (textparsers->ParseFile_SMC(path_.c_str(), &builder, NULL) == SMCError_Okay)
+			snapshot_.reset(builder.Finish());
+	}
+
+protected:
+	Handle_t CreateResult() override
+	{
+		if (!snapshot_)
+			return BAD_HANDLE;
+		return CreateKeyValueSnapshotHandle(ident_, snapshot_.release());
+	}
+
+private:
+	std::string path_;
+	std::unique_ptr<KeyValueSnapshot> snapshot_;
+};
+
+static ICellArray *CopyInputArray(IPluginContext *pContext, Handle_t hndl)
+{
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), g_pCoreIdent);
+	ICellArray *array;
+
+	if ((err = handlesys->ReadHandle(hndl, htCellArray, &sec, (void **)&array))
+		!= HandleError_None)
+	{
+		pContext->ReportError("Invalid Handle %x (error: %d)", hndl, err);
+		return NULL;
+	}
+
+	ICellArray *copy = array->clone();
+	if (!copy)
+	{
+		pContext->ReportError("Failed to copy array. Out of memory.");
+		return NULL;
+	}
+	return copy;
+}
+
+static bool CheckCallback(IPluginContext *pContext, funcid_t callback)
+{
+	IPlugin *pPlugin = pluginsys->FindPluginByContext(pContext->GetContext());
+	if (!pPlugin->GetBaseContext()->GetFunctionById(callback))
+	{
+		pContext->ReportError("Invalid function id (%X)", callback);
+		return false;
+	}
+	return true;
+}
+
+static cell_t SortArrayAsync(IPluginContext *pContext, const cell_t *params)
+{
+	if (params[2] != Sort_Ascending && params[2] != Sort_Descending)
+	{
+		return pContext->ThrowNativeError("Invalid sort order: %d", params[2]);
+	}
+	if (params[3] < Sort_Integer || params[3] > Sort_String)
+	{
+		return pContext->ThrowNativeError("Invalid sort type: %d", params[3]);
+	}
+	if (!CheckCallback(pContext, params[4]))
+		return 0;
+
+	ICellArray *copy = CopyInputArray(pContext, params[1]);
+	if (!copy)
+		return 0;
+
+	SortArrayJob *job = new SortArrayJob(pContext, params[4], params[5], copy, params[2], params[3]);
+	return g_WorkerJobs.Submit(pContext->GetIdentity(), job);
+}
+
+static cell_t HashStringsAsync(IPluginContext *pContext, const cell_t *params)
+{
+	if (!CheckCallback(pContext, params[2]))
+		return 0;
+
+	ICellArray *copy = CopyInputArray(pContext, params[1]);
+	if (!copy)
+		return 0;
+
+	HashStringsJob *job = new HashStringsJob(pContext, params[2], params[3], copy);
+	return g_WorkerJobs.Submit(pContext->GetIdentity(), job);
+}
+
+static cell_t ParseConfigAsync(IPluginContext *pContext, const cell_t *params)
+{
+	if (!CheckCallback(pContext, params[2]))
+		return 0;
+
+	char *file;
+	pContext->LocalToString(params[1], &file);
+
+	char path[PLATFORM_MAX_PATH];
+	g_pSM->BuildPath(Path_Game, path, sizeof(path), "%s", file);
+
+	ParseConfigJob *job = new ParseConfigJob(pContext, params[2], params[3], path);
+	return g_WorkerJobs.Submit(pContext->GetIdentity(), job);
+}
+
+static cell_t CompileKeyValuesAsync(IPluginContext *pContext, const cell_t *params)
+{
+	if (!CheckCallback(pContext, params[2]))
+		return 0;
+
+	char *file;
+	pContext->LocalToString(params[1], &file);
+
+	char path[PLATFORM_MAX_PATH];
+	g_pSM->BuildPath(Path_Game, path, sizeof(path), "%s", file);
+
+	CompileKeyValuesJob *job = new CompileKeyValuesJob(pContext, params[2], params[3], path);
+	return g_WorkerJobs.Submit(pContext->GetIdentity(), job);
+}
+
+static cell_t CancelWorkerJob(IPluginContext *pContext, const cell_t *params)
+{
+	return g_WorkerJobs.Cancel(params[1], pContext->GetIdentity()) ? 1 : 0;
+}
+
+REGISTER_NATIVES(workerJobNatives)
+{
+	{"SortArrayAsync",          SortArrayAsync},
+	{"HashStringsAsync",        HashStringsAsync},
+	{"ParseConfigAsync",        ParseConfigAsync},
+	{"CompileKeyValuesAsync",   CompileKeyValuesAsync},
+	{"CancelWorkerJob",         CancelWorkerJob},
+	{NULL,                      NULL},
+};
@@ -49,7 +49,7 @@ IDatabase *g_FormatEscapeDatabase = NULL;
 #define CHECK_ARGS(x) \
 	if ((arg+x) > args) { \
 		pCtx->ThrowNativeErrorEx(SP_ERROR_PARAM, "String formatted incorrectly - parameter %d (total %d)", arg, args); \
-		return 0; \
+		return FormatSpec_Error; \
 	}
 
 inline void ReorderTranslationParams(const Translation *pTrans, cell_t *params)
@@ -62,92 +62,116 @@ inline void ReorderTranslationParams(const Translation *pTrans, cell_t *params)
 	memcpy(params, new_params, pTrans->fmt_count * sizeof(cell_t));
 }
 
-size_t Translate(char *buffer,
-				 size_t maxlen,
-				 IPluginContext *pCtx,
-				 const char *key,
-				 cell_t target,
-				 const cell_t *params,
-				 int *arg,
-				 bool *error)
+bool GetTranslationLanguage(IPluginContext *pCtx, cell_t target, int arg, unsigned int *langid)
 {
-	unsigned int langid;
-	*error = false;
-	Translation pTrans;
-	IPlugin *pl = scripts->FindPluginByContext(pCtx->GetContext());
-	unsigned int max_params = 0;
-	IPhraseCollection *pPhrases;
-
-	pPhrases = pl->GetPhrases();
-
-try_serverlang:
 	if (target == SOURCEMOD_SERVER_LANGUAGE)
 	{
-		langid = g_Translator.GetServerLanguage();
- 	}
+		*langid = g_Translator.GetServerLanguage();
+	}
 	else if ((target >= 1) && (target <= bridge->MaxClients()))
 	{
-		langid = g_Translator.GetClientLanguage(target);
+		*langid = g_Translator.GetClientLanguage(target);
 	}
 	else
 	{
-		pCtx->ThrowNativeErrorEx(SP_ERROR_PARAM, "Translation failed: invalid client index %d (arg %d)", target, *arg);
-		goto error_out;
+		pCtx->ThrowNativeErrorEx(SP_ERROR_PARAM, "Translation failed: invalid client index %d (arg %d)", target, arg);
+		return false;
+	}
+	return true;
+}
+
+bool FindTranslationWithFallback(IPluginContext *pCtx,
+								 IPhraseCollection *pPhrases,
+								 const char *key,
+								 unsigned int langid,
+								 int arg,
+								 Translation *pTrans)
+{
+	if (pPhrases->FindTranslation(key, langid, pTrans) == Trans_Okay)
+	{
+		return true;
 	}
 
-	if (pPhrases->FindTranslation(key, langid, &pTrans) != Trans_Okay)
+	/* Fall back to the server's language, then to English. */
+	unsigned int serverlang = g_Translator.GetServerLanguage();
+	if (langid != serverlang)
 	{
-		if (target != SOURCEMOD_SERVER_LANGUAGE && langid != g_Translator.GetServerLanguage())
-		{
-			target = SOURCEMOD_SERVER_LANGUAGE;
-			goto try_serverlang;
-		}
-		else if (langid != SOURCEMOD_LANGUAGE_ENGLISH)
-		{
-			if (pPhrases->FindTranslation(key, SOURCEMOD_LANGUAGE_ENGLISH, &pTrans) != Trans_Okay)
-			{
-				pCtx->ThrowNativeErrorEx(SP_ERROR_PARAM, "Language phrase \"%s\" not found (arg %d)", key, *arg);
-				goto error_out;
-			}
-		}
-		else
+		langid = serverlang;
+		if (pPhrases->FindTranslation(key, langid, pTrans) == Trans_Okay)
 		{
-			pCtx->ThrowNativeErrorEx(SP_ERROR_PARAM, "Language phrase \"%s\" not found (arg %d)", key, *arg);
-			goto error_out;
+			return true;
 		}
 	}
 
-	max_params = pTrans.fmt_count;
+	if (langid != SOURCEMOD_LANGUAGE_ENGLISH
+		&& pPhrases->FindTranslation(key, SOURCEMOD_LANGUAGE_ENGLISH, pTrans) == Trans_Okay)
+	{
+		return true;
+	}
+
+	pCtx->ThrowNativeErrorEx(SP_ERROR_PARAM, "Language phrase \"%s\" not found (arg %d)", key, arg);
+	return false;
+}
+
+bool PrepareTranslationParams(IPluginContext *pCtx,
+							  const Translation *pTrans,
+							  const cell_t *params,
+							  int arg,
+							  cell_t *new_params)
+{
+	unsigned int max_params = pTrans->fmt_count;
 
-	if (max_params)
+	/* Check if we're going to over the limit */
+	if (arg + (max_params - 1) > (size_t)params[0])
 	{
-		cell_t new_params[MAX_TRANSLATE_PARAMS];
+		pCtx->ThrowNativeErrorEx(SP_ERROR_PARAMS_MAX, 
+			"Translation string formatted incorrectly - missing at least %d parameters (arg %d)", 
+			((arg + (max_params - 1)) - params[0]), arg);
+		return false;
+	}
 
-		/* Check if we're going to over the limit */
-		if ((*arg) + (max_params - 1) > (size_t)params[0])
-		{
-			pCtx->ThrowNativeErrorEx(SP_ERROR_PARAMS_MAX, 
-				"Translation string formatted incorrectly - missing at least %d parameters (arg %d)", 
-				((*arg + (max_params - 1)) - params[0]), *arg);
-			goto error_out;
-		}
+	/* If we need to re-order the parameters, do so with a temporary array.
+	 * Otherwise, we could run into trouble with continual formats, a la ShowActivity().
+	 */
+	memcpy(new_params, params, sizeof(cell_t) * (params[0] + 1));
+	ReorderTranslationParams(pTrans, &new_params[arg]);
+	return true;
+}
+
+size_t Translate(char *buffer,
+				 size_t maxlen,
+				 IPluginContext *pCtx,
+				 const char *key,
+				 cell_t target,
+				 const cell_t *params,
+				 int *arg,
+				 bool *error)
+{
+	unsigned int langid;
+	Translation pTrans;
+	IPlugin *pl = scripts->FindPluginByContext(pCtx->GetContext());
 
-		/* If we need to re-order the parameters, do so with a temporary array.
-		 * Otherwise, we could run into trouble with continual formats, a la ShowActivity().
-		 */
-		memcpy(new_params, params, sizeof(cell_t) * (params[0] + 1));
-		ReorderTranslationParams(&pTrans, &new_params[*arg]);
+	*error = false;
 
-		return atcprintf(buffer, maxlen, pTrans.szPhrase, pCtx, new_params, arg);
+	if (!GetTranslationLanguage(pCtx, target, *arg, &langid)
+		|| !FindTranslationWithFallback(pCtx, pl->GetPhrases(), key, langid, *arg, &pTrans))
+	{
+		*error = true;
+		return 0;
 	}
-	else
+
+	if (pTrans.fmt_count)
 	{
-		return atcprintf(buffer, maxlen, pTrans.szPhrase, pCtx, params, arg);
+		cell_t new_params[MAX_TRANSLATE_PARAMS];
+		if (!PrepareTranslationParams(pCtx, &pTrans, params, *arg, new_params))
+		{
+			*error = true;
+			return 0;
+		}
+		return atcprintf(buffer, maxlen, pTrans.szPhrase, pCtx, new_params, arg);
 	}
-	
-error_out:
-	*error = true;
-	return 0;
+
+	return atcprintf(buffer, maxlen, pTrans.szPhrase, pCtx, params, arg);
 }
 
 bool AddString(char **buf_p, size_t &maxlen, const char *string, int width, int prec, int flags)
@@ -1013,256 +1037,335 @@ done:
 	return true;
 }
 
-size_t atcprintf(char *buffer, size_t maxlen, const char *format, IPluginContext *pCtx, const cell_t *params, int *param)
+const char *ParseFormatSpec(const char *fmt, FormatSpec *spec)
 {
-	if (!buffer || !maxlen)
-	{
-		return 0;
-	}
-
-	int arg;
-	int args = params[0];
-	char *buf_p;
 	char ch;
-	int flags;
-	int width;
-	int prec;
 	int n;
-	char sign;
-	const char *fmt;
-	size_t llen = maxlen - 1;
 
-	buf_p = buffer;
-	arg = *param;
-	fmt = format;
+	spec->flags = 0;
+	spec->width = 0;
+	spec->prec = -1;
 
-	while (true)
+rflag:
+	ch = *fmt++;
+reswitch:
+	switch(ch)
 	{
-		// run through the format string until we hit a '%' or '\0'
-		for (ch = *fmt; llen && ((ch = *fmt) != '\0') && (ch != '%'); fmt++)
+	case '-':
 		{
-			*buf_p++ = ch;
-			llen--;
+			spec->flags |= LADJUST;
+			goto rflag;
 		}
-		if ((ch == '\0') || (llen <= 0))
+	case '!':
 		{
-			goto done;
+			spec->flags |= NOESCAPE;
+			goto rflag;
 		}
-
-		// skip over the '%'
-		fmt++;
-
-		// reset formatting state
-		flags = 0;
-		width = 0;
-		prec = -1;
-		sign = '\0';
-
-rflag:
-		ch = *fmt++;
-reswitch:
-		switch(ch)
+	case '.':
 		{
-		case '-':
-			{
-				flags |= LADJUST;
-				goto rflag;
-			}
-		case '!':
-			{
-				flags |= NOESCAPE;
-				goto rflag;
-			}
-		case '.':
+			n = 0;
+			while(is_digit((ch = *fmt++)))
 			{
-				n = 0;
-				while(is_digit((ch = *fmt++)))
-				{
-					n = 10 * n + (ch - '0');
-				}
-				prec = (n < 0) ? -1 : n;
-				goto reswitch;
+				n = 10 * n + (ch - '0');
 			}
-		case '0':
+			spec->prec = (n < 0) ? -1 : n;
+			goto reswitch;
+		}
+	case '0':
+		{
+			spec->flags |= ZEROPAD;
+			goto rflag;
+		}
+	case '1':
+	case '2':
+	case '3':
+	case '4':
+	case '5':
+	case '6':
+	case '7':
+	case '8':
+	case '9':
+		{
+			n = 0;
+			do
 			{
-				flags |= ZEROPAD;
-				goto rflag;
-			}
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
+				n = 10 * n + (ch - '0');
+				ch = *fmt++;
+			} while(is_digit(ch));
+			spec->width = n;
+			goto reswitch;
+		}
+	}
+
+	spec->ch = ch;
+	return fmt;
+}
+
+bool IsRenderedFormatSpec(char ch)
+{
+	switch (ch)
+	{
+	case 'c':
+	case 'b':
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'f':
+	case 'L':
+	case 'N':
+	case 's':
+	case 'T':
+	case 't':
+	case 'X':
+	case 'x':
+		return true;
+	}
+	return false;
+}
+
+FormatSpecResult RenderFormatSpec(const FormatSpec &spec,
+								  char *&buf_p,
+								  size_t &llen,
+								  IPluginContext *pCtx,
+								  const cell_t *params,
+								  int &arg)
+{
+	int args = params[0];
+	int flags = spec.flags;
+	int width = spec.width;
+	int prec = spec.prec;
+
+	switch (spec.ch)
+	{
+	case 'c':
+		{
+			CHECK_ARGS(0);
+			if (!llen)
 			{
-				n = 0;
-				do
-				{
-					n = 10 * n + (ch - '0');
-					ch = *fmt++;
-				} while(is_digit(ch));
-				width = n;
-				goto reswitch;
+				return FormatSpec_Full;
 			}
-		case 'c':
+			char *c;
+			pCtx->LocalToString(params[arg], &c);
+			*buf_p++ = *c;
+			llen--;
+			arg++;
+			break;
+		}
+	case 'b':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+			AddBinary(&buf_p, llen, *value, width, flags);
+			arg++;
+			break;
+		}
+	case 'd':
+	case 'i':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+			AddInt(&buf_p, llen, static_cast<int>(*value), width, flags);
+			arg++;
+			break;
+		}
+	case 'u':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+			AddUInt(&buf_p, llen, static_cast<unsigned int>(*value), width, flags);
+			arg++;
+			break;
+		}
+	case 'f':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+			AddFloat(&buf_p, llen, sp_ctof(*value), width, prec, flags);
+			arg++;
+			break;
+		}
+	case 'L':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+			char buffer[255];
+			if (*value)
 			{
-				CHECK_ARGS(0);
-				if (!llen)
+				const char *name;
+				const char *auth;
+				int userid;
+				if (!bridge->DescribePlayer(*value, &name, &auth, &userid))
 				{
-					goto done;
+					pCtx->ThrowNativeError("Client index %d is invalid (arg %d)", *value, arg);
+					return FormatSpec_Error;
 				}
-				char *c;
-				pCtx->LocalToString(params[arg], &c);
-				*buf_p++ = *c;
-				llen--;
-				arg++;
-				break;
-			}
-		case 'b':
-			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-				AddBinary(&buf_p, llen, *value, width, flags);
-				arg++;
-				break;
+				
+				ke::SafeSprintf(buffer, sizeof(buffer), "%s<%d><%s><>", name, userid, auth);
 			}
-		case 'd':
-		case 'i':
+			else
 			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-				AddInt(&buf_p, llen, static_cast<int>(*value), width, flags);
-				arg++;
-				break;
-			}
-		case 'u':
-			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-				AddUInt(&buf_p, llen, static_cast<unsigned int>(*value), width, flags);
-				arg++;
-				break;
+				ke::SafeStrcpy(buffer, sizeof(buffer), "Console<0><Console><Console>");
 			}
-		case 'f':
+			if (!AddString(&buf_p, llen, buffer, width, prec, flags))
 			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-				AddFloat(&buf_p, llen, sp_ctof(*value), width, prec, flags);
-				arg++;
-				break;
+				pCtx->ThrowNativeError("Escaped string would be truncated (arg %d)", arg);
+				return FormatSpec_Error;
 			}
-		case 'L':
-			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-				char buffer[255];
-				if (*value)
-				{
-					const char *name;
-					const char *auth;
-					int userid;
-					if (!bridge->DescribePlayer(*value, &name, &auth, &userid))
-						return pCtx->ThrowNativeError("Client index %d is invalid (arg %d)", *value, arg);
-					
-					ke::SafeSprintf(buffer, sizeof(buffer), "%s<%d><%s><>", name, userid, auth);
-				}
-				else
+			arg++;
+			break;
+		}
+	case 'N':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+
+			const char *name = "Console";
+			if (*value) {
+				if (!bridge->DescribePlayer(*value, &name, nullptr, nullptr))
 				{
-					ke::SafeStrcpy(buffer, sizeof(buffer), "Console<0><Console><Console>");
+					pCtx->ThrowNativeError("Client index %d is invalid (arg %d)", *value, arg);
+					return FormatSpec_Error;
 				}
-				if (!AddString(&buf_p, llen, buffer, width, prec, flags))
-					return pCtx->ThrowNativeError("Escaped string would be truncated (arg %d)", arg);
-				arg++;
-				break;
 			}
-		case 'N':
+			if (!AddString(&buf_p, llen, name, width, prec, flags))
 			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-
-				const char *name = "Console";
-				if (*value) {
-					if (!bridge->DescribePlayer(*value, &name, nullptr, nullptr))
-						return pCtx->ThrowNativeError("Client index %d is invalid (arg %d)", *value, arg);
-				}
-				if (!AddString(&buf_p, llen, name, width, prec, flags))
-					return pCtx->ThrowNativeError("Escaped string would be truncated (arg %d)", arg);
-				arg++;
-				break;
+				pCtx->ThrowNativeError("Escaped string would be truncated (arg %d)", arg);
+				return FormatSpec_Error;
 			}
-		case 's':
+			arg++;
+			break;
+		}
+	case 's':
+		{
+			CHECK_ARGS(0);
+			char *str;
+			pCtx->LocalToString(params[arg], &str);
+			if (!AddString(&buf_p, llen, str, width, prec, flags))
 			{
-				CHECK_ARGS(0);
-				char *str;
-				pCtx->LocalToString(params[arg], &str);
-				if (!AddString(&buf_p, llen, str, width, prec, flags))
-					return pCtx->ThrowNativeError("Escaped string would be truncated (arg %d)", arg);
-				arg++;
-				break;
+				pCtx->ThrowNativeError("Escaped string would be truncated (arg %d)", arg);
+				return FormatSpec_Error;
 			}
-		case 'T':
+			arg++;
+			break;
+		}
+	case 'T':
+		{
+			CHECK_ARGS(1);
+			char *key;
+			bool error;
+			size_t res;
+			cell_t *target;
+			pCtx->LocalToString(params[arg++], &key);
+			pCtx->LocalToPhysAddr(params[arg++], &target);
+			res = Translate(buf_p, llen + 1, pCtx, key, *target, params, &arg, &error);
+			if (error)
 			{
-				CHECK_ARGS(1);
-				char *key;
-				bool error;
-				size_t res;
-				cell_t *target;
-				pCtx->LocalToString(params[arg++], &key);
-				pCtx->LocalToPhysAddr(params[arg++], &target);
-				res = Translate(buf_p, llen + 1, pCtx, key, *target, params, &arg, &error);
-				if (error)
-				{
-					return 0;
-				}
-				buf_p += res;
-				llen -= res;
-				break;
+				return FormatSpec_Error;
 			}
-		case 't':
+			buf_p += res;
+			llen -= res;
+			break;
+		}
+	case 't':
+		{
+			CHECK_ARGS(0);
+			char *key;
+			bool error;
+			size_t res;
+			cell_t target = bridge->GetGlobalTarget();
+			pCtx->LocalToString(params[arg++], &key);
+			res = Translate(buf_p, llen + 1, pCtx, key, target, params, &arg, &error);
+			if (error)
 			{
-				CHECK_ARGS(0);
-				char *key;
-				bool error;
-				size_t res;
-				cell_t target = bridge->GetGlobalTarget();
-				pCtx->LocalToString(params[arg++], &key);
-				res = Translate(buf_p, llen + 1, pCtx, key, target, params, &arg, &error);
-				if (error)
-				{
-					return 0;
-				}
-				buf_p += res;
-				llen -= res;
-				break;
+				return FormatSpec_Error;
 			}
-		case 'X':
+			buf_p += res;
+			llen -= res;
+			break;
+		}
+	case 'X':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+			flags |= UPPERDIGITS;
+			AddHex(&buf_p, llen, static_cast<unsigned int>(*value), width, flags);
+			arg++;
+			break;
+		}
+	case 'x':
+		{
+			CHECK_ARGS(0);
+			cell_t *value;
+			pCtx->LocalToPhysAddr(params[arg], &value);
+			AddHex(&buf_p, llen, static_cast<unsigned int>(*value), width, flags);
+			arg++;
+			break;
+		}
+	}
+
+	return FormatSpec_Continue;
+}
+
+size_t atcprintf(char *buffer, size_t maxlen, const char *format, IPluginContext *pCtx, const cell_t *params, int *param)
+{
+	if (!buffer || !maxlen)
+	{
+		return 0;
+	}
+
+	int arg;
+	char *buf_p;
+	char ch;
+	FormatSpec spec;
+	const char *fmt;
+	size_t llen = maxlen - 1;
+
+	buf_p = buffer;
+	arg = *param;
+	fmt = format;
+
+	while (true)
+	{
+		// run through the format string until we hit a '%' or '\0'
+		for (ch = *fmt; llen && ((ch = *fmt) != '\0') && (ch != '%'); fmt++)
+		{
+			*buf_p++ = ch;
+			llen--;
+		}
+		if ((ch == '\0') || (llen <= 0))
+		{
+			goto done;
+		}
+
+		// skip over the '%'
+		fmt++;
+
+		fmt = ParseFormatSpec(fmt, &spec);
+		ch = spec.ch;
+
+		if (IsRenderedFormatSpec(ch))
+		{
+			FormatSpecResult res = RenderFormatSpec(spec, buf_p, llen, pCtx, params, arg);
+			if (res == FormatSpec_Error)
 			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-				flags |= UPPERDIGITS;
-				AddHex(&buf_p, llen, static_cast<unsigned int>(*value), width, flags);
-				arg++;
-				break;
+				return 0;
 			}
-		case 'x':
+			if (res == FormatSpec_Full)
 			{
-				CHECK_ARGS(0);
-				cell_t *value;
-				pCtx->LocalToPhysAddr(params[arg], &value);
-				AddHex(&buf_p, llen, static_cast<unsigned int>(*value), width, flags);
-				arg++;
-				break;
+				goto done;
 			}
+			continue;
+		}
+
+		switch(ch)
+		{
 		case '%':
 			{
 				if (!llen)
@@ -32,6 +32,7 @@
 namespace SourceMod {
 class IDatabase;
 class IPhraseCollection;
+struct Translation;
 }
 
 // "AMX Templated Cell Printf", originally. SourceMod doesn't have cell-strings
@@ -58,6 +59,59 @@ bool gnprintf(char *buffer,
               size_t *pOutLength,
               const char **pFailPhrase);
 
+// A single parsed conversion, i.e. everything between a '%' and the
+// conversion character (inclusive).
+struct FormatSpec
+{
+  char ch;
+  int flags;
+  int width;
+  int prec;
+};
+
+enum FormatSpecResult
+{
+  FormatSpec_Continue,    // Rendered; keep going.
+  FormatSpec_Full,        // The buffer filled up; stop.
+  FormatSpec_Error        // A native error was thrown.
+};
+
+// Parses the flags, width, precision and conversion character following a
+// '%'. Returns a pointer just past the conversion character.
+const char *ParseFormatSpec(const char *fmt, FormatSpec *spec);
+
+// Returns whether RenderFormatSpec handles the given conversion character.
+// Anything else is copied through literally by atcprintf.
+bool IsRenderedFormatSpec(char ch);
+
+// Renders one conversion that consumes script arguments, advancing buf_p, llen
+// and arg. This is the body of atcprintf's conversion switch, shared with
+// FormatTemplate.
+FormatSpecResult RenderFormatSpec(const FormatSpec &spec,
+                                  char *&buf_p,
+                                  size_t &llen,
+                                  SourcePawn::IPluginContext *pCtx,
+                                  const cell_t *params,
+                                  int &arg);
+
+// Translation helpers used by %t/%T. Each throws a native error on the
+// context and returns false on failure.
+bool GetTranslationLanguage(SourcePawn::IPluginContext *pCtx,
+                            cell_t target,
+                            int arg,
+                            unsigned int *langid);
+bool FindTranslationWithFallback(SourcePawn::IPluginContext *pCtx,
+                                 SourceMod::IPhraseCollection *pPhrases,
+                                 const char *key,
+                                 unsigned int langid,
+                                 int arg,
+                                 SourceMod::Translation *pTrans);
+bool PrepareTranslationParams(SourcePawn::IPluginContext *pCtx,
+                              const SourceMod::Translation *pTrans,
+                              const cell_t *params,
+                              int arg,
+                              cell_t *new_params);
+
 extern SourceMod::IDatabase *g_FormatEscapeDatabase;
 
 #endif // _include_sourcemod_core_logic_sprintf_h_
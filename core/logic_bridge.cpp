@@ -44,6 +44,7 @@
 #include "CoreConfig.h"
 #include "ConCmdManager.h"
 #include "IDBDriver.h"
+#include <ITextParsers.h>
 #include "provider.h"
 #include "sm_convar.h"
 #include <amtl/os/am-shared-library.h>
@@ -285,6 +286,28 @@ static void keyvalues_to_dbinfo(KeyValues *kv, DatabaseInfo *out)
 	out->user = kv->GetString("user", "");
 }
 
+/* Replays a KeyValues tree as SMC parse events, so logic can consume it
+ * without linking against tier1.
+ */
+static void walk_keyvalues_r(KeyValues *kv, ITextListener_SMC *listener, SMCStates *states)
+{
+	listener->ReadSMC_NewSection(states, kv->GetName());
+	for (KeyValues *sub = kv->GetFirstSubKey(); sub != NULL; sub = sub->GetNextKey())
+	{
+		if (sub->GetDataType() == KeyValues::TYPE_NONE)
+			walk_keyvalues_r(sub, listener, states);
+		else
+			listener->ReadSMC_KeyValue(states, sub->GetName(), sub->GetString());
+	}
+	listener->ReadSMC_LeavingSection(states);
+}
+
+static void walk_keyvalues(KeyValues *kv, ITextListener_SMC *listener)
+{
+	SMCStates states = {0, 0};
+	walk_keyvalues_r(kv, listener, &states);
+}
+
 static int get_activity_flags()
 {
 	return sm_show_activity.GetInt();
@@ -410,6 +433,7 @@ CoreProviderImpl::CoreProviderImpl()
 	this->AreConfigsExecuted = SM_AreConfigsExecuted;
 	this->ExecuteConfigs = SM_ExecuteForPlugin;
 	this->GetDBInfoFromKeyValues = keyvalues_to_dbinfo;
+	this->WalkKeyValues = walk_keyvalues;
 	this->GetActivityFlags = get_activity_flags;
 	this->GetImmunityMode = get_immunity_mode;
 	this->UpdateAdminCmdFlags = update_admin_cmd_flags;
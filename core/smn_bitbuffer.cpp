@@ -40,6 +40,7 @@
 #include "smn_usermsgs.h"
 #include "sourcemod.h"
 #include "logic_bridge.h"
+#include <vector>
 
 static cell_t smn_BfWriteBool(IPluginContext *pCtx, const cell_t *params)
 {
@@ -681,6 +682,251 @@ static cell_t smn_BfGetNumBytesLeft(IPluginContext *pCtx, const cell_t *params)
 	return pBitBuf->GetNumBitsLeft() >> 3;
 }
 
+static cell_t smn_BfWriteBytes(IPluginContext *pCtx, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	bf_write *pBitBuf;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_WrBitBufType, &sec, (void **)&pBitBuf))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid bit buffer handle %x (error %d)", hndl, herr);
+	}
+
+	cell_t *values;
+	int count = params[3];
+	pCtx->LocalToPhysAddr(params[2], &values);
+
+	if (count < 0 || count > pBitBuf->GetNumBitsLeft() / 8)
+	{
+		return pCtx->ThrowNativeError("Cannot write %d bytes, only %d bits left", count, pBitBuf->GetNumBitsLeft());
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		pBitBuf->WriteByte(values[i]);
+	}
+
+	return 1;
+}
+
+static cell_t smn_BfWriteShorts(IPluginContext *pCtx, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	bf_write *pBitBuf;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_WrBitBufType, &sec, (void **)&pBitBuf))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid bit buffer handle %x (error %d)", hndl, herr);
+	}
+
+	cell_t *values;
+	int count = params[3];
+	pCtx->LocalToPhysAddr(params[2], &values);
+
+	if (count < 0 || count > pBitBuf->GetNumBitsLeft() / 16)
+	{
+		return pCtx->ThrowNativeError("Cannot write %d shorts, only %d bits left", count, pBitBuf->GetNumBitsLeft());
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		pBitBuf->WriteShort(values[i]);
+	}
+
+	return 1;
+}
+
+static cell_t smn_BfWriteFloats(IPluginContext *pCtx, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	bf_write *pBitBuf;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_WrBitBufType, &sec, (void **)&pBitBuf))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid bit buffer handle %x (error %d)", hndl, herr);
+	}
+
+	cell_t *values;
+	int count = params[3];
+	pCtx->LocalToPhysAddr(params[2], &values);
+
+	if (count < 0 || count > pBitBuf->GetNumBitsLeft() / 32)
+	{
+		return pCtx->ThrowNativeError("Cannot write %d floats, only %d bits left", count, pBitBuf->GetNumBitsLeft());
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		pBitBuf->WriteFloat(sp_ctof(values[i]));
+	}
+
+	return 1;
+}
+
+static cell_t smn_BfWriteStrings(IPluginContext *pCtx, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	bf_write *pBitBuf;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_WrBitBufType, &sec, (void **)&pBitBuf))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid bit buffer handle %x (error %d)", hndl, herr);
+	}
+
+	cell_t *array;
+	int count = params[3];
+	pCtx->LocalToPhysAddr(params[2], &array);
+
+	if (count < 0)
+	{
+		return pCtx->ThrowNativeError("Invalid string count %d", count);
+	}
+
+	/* Size everything up first so a message is never left half written. */
+	std::vector<const char *> strings(count);
+	size_t bytes = 0;
+	for (int i = 0; i < count; i++)
+	{
+		strings[i] = GetArrayString(pCtx, array, i);
+		bytes += strlen(strings[i]) + 1;
+	}
+
+	if (bytes > (size_t)(pBitBuf->GetNumBitsLeft() / 8))
+	{
+		return pCtx->ThrowNativeError("Cannot write %d strings (%d bytes), only %d bits left", count, (int)bytes, pBitBuf->GetNumBitsLeft());
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		pBitBuf->WriteString(strings[i]);
+	}
+
+	return 1;
+}
+
+static cell_t smn_BfReadBytes(IPluginContext *pCtx, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	bf_read *pBitBuf;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_RdBitBufType, &sec, (void **)&pBitBuf))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid bit buffer handle %x (error %d)", hndl, herr);
+	}
+
+	cell_t *values;
+	int count = params[3];
+	pCtx->LocalToPhysAddr(params[2], &values);
+
+	if (count < 0 || count > pBitBuf->GetNumBitsLeft() / 8)
+	{
+		return pCtx->ThrowNativeError("Cannot read %d bytes, only %d bits left", count, pBitBuf->GetNumBitsLeft());
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		values[i] = pBitBuf->ReadByte();
+	}
+
+	return 1;
+}
+
+static cell_t smn_BfReadShorts(IPluginContext *pCtx, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	bf_read *pBitBuf;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_RdBitBufType, &sec, (void **)&pBitBuf))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid bit buffer handle %x (error %d)", hndl, herr);
+	}
+
+	cell_t *values;
+	int count = params[3];
+	pCtx->LocalToPhysAddr(params[2], &values);
+
+	if (count < 0 || count > pBitBuf->GetNumBitsLeft() / 16)
+	{
+		return pCtx->ThrowNativeError("Cannot read %d shorts, only %d bits left", count, pBitBuf->GetNumBitsLeft());
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		values[i] = pBitBuf->ReadShort();
+	}
+
+	return 1;
+}
+
+static cell_t smn_BfReadFloats(IPluginContext *pCtx, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	bf_read *pBitBuf;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_RdBitBufType, &sec, (void **)&pBitBuf))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid bit buffer handle %x (error %d)", hndl, herr);
+	}
+
+	cell_t *values;
+	int count = params[3];
+	pCtx->LocalToPhysAddr(params[2], &values);
+
+	if (count < 0 || count > pBitBuf->GetNumBitsLeft() / 32)
+	{
+		return pCtx->ThrowNativeError("Cannot read %d floats, only %d bits left", count, pBitBuf->GetNumBitsLeft());
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		values[i] = sp_ftoc(pBitBuf->ReadFloat());
+	}
+
+	return 1;
+}
+
 REGISTER_NATIVES(bitbufnatives)
 {
 	{"BfWriteBool",				smn_BfWriteBool},
@@ -728,6 +974,10 @@ REGISTER_NATIVES(bitbufnatives)
 	{"BfWrite.WriteVecCoord",	smn_BfWriteVecCoord},
 	{"BfWrite.WriteVecNormal",	smn_BfWriteVecNormal},
 	{"BfWrite.WriteAngles",		smn_BfWriteAngles},
+	{"BfWrite.WriteBytes",		smn_BfWriteBytes},
+	{"BfWrite.WriteShorts",		smn_BfWriteShorts},
+	{"BfWrite.WriteFloats",		smn_BfWriteFloats},
+	{"BfWrite.WriteStrings",	smn_BfWriteStrings},
 
 	{"BfRead.ReadBool",			smn_BfReadBool},
 	{"BfRead.ReadByte",			smn_BfReadByte},
@@ -743,6 +993,9 @@ REGISTER_NATIVES(bitbufnatives)
 	{"BfRead.ReadVecCoord",		smn_BfReadVecCoord},
 	{"BfRead.ReadVecNormal",	smn_BfReadVecNormal},
 	{"BfRead.ReadAngles",		smn_BfReadAngles},
+	{"BfRead.ReadBytes",		smn_BfReadBytes},
+	{"BfRead.ReadShorts",		smn_BfReadShorts},
+	{"BfRead.ReadFloats",		smn_BfReadFloats},
 	{"BfRead.BytesLeft.get",	smn_BfGetNumBytesLeft},
 
 	{NULL,						NULL}
@@ -413,6 +413,93 @@ static cell_t PrintHintText(IPluginContext *pContext, const cell_t *params)
 	return 1;
 }
 
+/* Text destinations used by the broadcast natives, besides HUD_PRINT*. */
+#define BROADCAST_HINT		-1
+
+/**
+ * Formats the message once per distinct language among in-game clients and
+ * sends each version in a single user message to everyone speaking it,
+ * rather than formatting and sending once per client.
+ */
+static cell_t BroadcastText(IPluginContext *pContext, const cell_t *params, int dest)
+{
+	cell_t clients[SM_MAXPLAYERS];
+	unsigned int langs[SM_MAXPLAYERS];
+	bool sent[SM_MAXPLAYERS];
+	int total = 0;
+
+	int maxClients = g_Players.GetMaxClients();
+	for (int i = 1; i <= maxClients; i++)
+	{
+		CPlayer *pPlayer = g_Players.GetPlayerByIndex(i);
+		if (!pPlayer->IsInGame())
+		{
+			continue;
+		}
+		clients[total] = i;
+		langs[total] = pPlayer->GetLanguageId();
+		sent[total] = false;
+		total++;
+	}
+
+	cell_t group[SM_MAXPLAYERS];
+	char buffer[254];
+	int messages = 0;
+	for (int i = 0; i < total; i++)
+	{
+		if (sent[i])
+		{
+			continue;
+		}
+
+		int count = 0;
+		for (int j = i; j < total; j++)
+		{
+			if (!sent[j] && langs[j] == langs[i])
+			{
+				group[count++] = clients[j];
+				sent[j] = true;
+			}
+		}
+
+		/* Any client in the group formats the same; %t only looks at the language. */
+		g_SourceMod.SetGlobalTarget(clients[i]);
+
+		{
+			DetectExceptions eh(pContext);
+			g_SourceMod.FormatString(buffer, sizeof(buffer), pContext, params, 1);
+			if (eh.HasException())
+				return 0;
+		}
+
+		bool ok = (dest == BROADCAST_HINT)
+			? g_HL2.HintTextMsg(group, count, buffer)
+			: g_HL2.TextMsg(group, count, dest, buffer);
+		if (!ok)
+		{
+			return pContext->ThrowNativeError("Could not send a usermessage");
+		}
+		messages++;
+	}
+
+	return messages;
+}
+
+static cell_t PrintToChatAll(IPluginContext *pContext, const cell_t *params)
+{
+	return BroadcastText(pContext, params, HUD_PRINTTALK);
+}
+
+static cell_t PrintCenterTextAll(IPluginContext *pContext, const cell_t *params)
+{
+	return BroadcastText(pContext, params, HUD_PRINTCENTER);
+}
+
+static cell_t PrintHintTextToAll(IPluginContext *pContext, const cell_t *params)
+{
+	return BroadcastText(pContext, params, BROADCAST_HINT);
+}
+
 static cell_t ShowVGUIPanel(IPluginContext *pContext, const cell_t *params)
 {
 	HandleError herr;
@@ -636,6 +723,9 @@ REGISTER_NATIVES(halflifeNatives)
 	{"PrintToChat",				PrintToChat},
 	{"PrintCenterText",			PrintCenterText},
 	{"PrintHintText",			PrintHintText},
+	{"PrintToChatAll",			PrintToChatAll},
+	{"PrintCenterTextAll",		PrintCenterTextAll},
+	{"PrintHintTextToAll",		PrintHintTextToAll},
 	{"ShowVGUIPanel",			ShowVGUIPanel},
 	{"IsPlayerAlive",			smn_IsPlayerAlive},
 	{"GuessSDKVersion",			GuessSDKVersion},
@@ -34,6 +34,7 @@
 #include "UserMessagePBHelpers.h"
 #include "smn_usermsgs.h"
 #include <IHandleSys.h>
+#include <vector>
 
 // Assumes pbuf message handle is param 1, gets message as msg
 #define GET_MSG_FROM_HANDLE_OR_ERR()                  \
@@ -824,6 +825,107 @@ static cell_t smn_PbAddMessage(IPluginContext *pCtx, const cell_t *params)
 	return outHndl;
 }
 
+// Assumes the value count is param 4, gets as count
+#define GET_VALUE_COUNT_OR_ERR()                                          \
+	int count = params[4];                                                \
+	if (count < 0)                                                        \
+	{                                                                     \
+		return pCtx->ThrowNativeError("Invalid value count %d", count);   \
+	}
+
+static cell_t smn_PbAddInts(IPluginContext *pCtx, const cell_t *params)
+{
+	GET_MSG_FROM_HANDLE_OR_ERR();
+	GET_FIELD_NAME_OR_ERR();
+	GET_VALUE_COUNT_OR_ERR();
+
+	cell_t *values;
+	pCtx->LocalToPhysAddr(params[3], &values);
+
+	if (!msg->AddInt32OrUnsignedOrEnumArray(strField, values, count))
+	{
+		return pCtx->ThrowNativeError("Invalid field \"%s\" for message \"%s\"", strField, msg->GetProtobufMessage()->GetTypeName().c_str());
+	}
+
+	return 1;
+}
+
+static cell_t smn_PbAddFloats(IPluginContext *pCtx, const cell_t *params)
+{
+	GET_MSG_FROM_HANDLE_OR_ERR();
+	GET_FIELD_NAME_OR_ERR();
+	GET_VALUE_COUNT_OR_ERR();
+
+	cell_t *values;
+	pCtx->LocalToPhysAddr(params[3], &values);
+
+	if (!msg->AddFloatOrDoubleArray(strField, reinterpret_cast<float *>(values), count))
+	{
+		return pCtx->ThrowNativeError("Invalid field \"%s\" for message \"%s\"", strField, msg->GetProtobufMessage()->GetTypeName().c_str());
+	}
+
+	return 1;
+}
+
+static cell_t smn_PbAddStrings(IPluginContext *pCtx, const cell_t *params)
+{
+	GET_MSG_FROM_HANDLE_OR_ERR();
+	GET_FIELD_NAME_OR_ERR();
+	GET_VALUE_COUNT_OR_ERR();
+
+	cell_t *array;
+	pCtx->LocalToPhysAddr(params[3], &array);
+
+	std::vector<const char *> values(count);
+	for (int i = 0; i < count; i++)
+	{
+		values[i] = GetArrayString(pCtx, array, i);
+	}
+
+	if (!msg->AddStringArray(strField, values.data(), count))
+	{
+		return pCtx->ThrowNativeError("Invalid field \"%s\" for message \"%s\"", strField, msg->GetProtobufMessage()->GetTypeName().c_str());
+	}
+
+	return 1;
+}
+
+static cell_t smn_PbReadRepeatedInts(IPluginContext *pCtx, const cell_t *params)
+{
+	GET_MSG_FROM_HANDLE_OR_ERR();
+	GET_FIELD_NAME_OR_ERR();
+	GET_VALUE_COUNT_OR_ERR();
+
+	cell_t *values;
+	pCtx->LocalToPhysAddr(params[3], &values);
+
+	int copied;
+	if (!msg->GetRepeatedInt32OrUnsignedOrEnumArray(strField, params[5], values, count, &copied))
+	{
+		return pCtx->ThrowNativeError("Invalid field \"%s\"[%d] for message \"%s\"", strField, params[5], msg->GetProtobufMessage()->GetTypeName().c_str());
+	}
+
+	return copied;
+}
+
+static cell_t smn_PbReadRepeatedFloats(IPluginContext *pCtx, const cell_t *params)
+{
+	GET_MSG_FROM_HANDLE_OR_ERR();
+	GET_FIELD_NAME_OR_ERR();
+	GET_VALUE_COUNT_OR_ERR();
+
+	cell_t *values;
+	pCtx->LocalToPhysAddr(params[3], &values);
+
+	int copied;
+	if (!msg->GetRepeatedFloatOrDoubleArray(strField, params[5], reinterpret_cast<float *>(values), count, &copied))
+	{
+		return pCtx->ThrowNativeError("Invalid field \"%s\"[%d] for message \"%s\"", strField, params[5], msg->GetProtobufMessage()->GetTypeName().c_str());
+	}
+
+	return copied;
+}
+
 REGISTER_NATIVES(protobufnatives)
 {
 	{"PbReadInt",					smn_PbReadInt},
@@ -890,6 +992,11 @@ REGISTER_NATIVES(protobufnatives)
 	{"Protobuf.ReadMessage",				smn_PbReadMessage},
 	{"Protobuf.ReadRepeatedMessage",		smn_PbReadRepeatedMessage},
 	{"Protobuf.AddMessage",					smn_PbAddMessage},
+	{"Protobuf.AddInts",					smn_PbAddInts},
+	{"Protobuf.AddFloats",					smn_PbAddFloats},
+	{"Protobuf.AddStrings",					smn_PbAddStrings},
+	{"Protobuf.ReadRepeatedInts",			smn_PbReadRepeatedInts},
+	{"Protobuf.ReadRepeatedFloats",			smn_PbReadRepeatedFloats},
 
 	{NULL,							NULL}
 };
@@ -134,6 +134,14 @@ void UsrMessageNatives::OnHandleDestroy(HandleType_t type, void *object)
 bool UsrMessageNatives::GetHandleApproxSize(HandleType_t type, void *object, unsigned int *pSize)
 {
 #ifdef USE_PROTOBUF_USERMESSAGES
+	SMProtobufMessage *msg = (SMProtobufMessage *)object;
+	if (msg->IsTemplate())
+	{
+		// Templates live for a while, so report what they really hold
+		*pSize = msg->GetProtobufMessage()->SpaceUsed() + sizeof(SMProtobufMessage);
+		return true;
+	}
+
 	// Different messages have different sizes, but this works as an approximate
 	*pSize = sizeof(protobuf::Message) + sizeof(SMProtobufMessage);
 #else
@@ -549,6 +557,98 @@ static cell_t smn_EndMessage(IPluginContext *pCtx, const cell_t *params)
 	return 1;
 }
 
+static cell_t smn_CreateUserMessageTemplate(IPluginContext *pCtx, const cell_t *params)
+{
+#ifndef USE_PROTOBUF_USERMESSAGES
+	return pCtx->ThrowNativeError("Message templates require protobuf usermessages");
+#else
+	char *msgname;
+	int msgid;
+
+	pCtx->LocalToString(params[1], &msgname);
+
+	if ((msgid=g_UserMsgs.GetMessageIndex(msgname)) == INVALID_MESSAGE_ID)
+	{
+		return pCtx->ThrowNativeError("Invalid message name: \"%s\"", msgname);
+	}
+
+	protobuf::Message *msg = g_UserMsgs.NewProtobufMessage(msgid);
+	if (!msg)
+	{
+		return pCtx->ThrowNativeError("Message \"%s\" has no protobuf type", msgname);
+	}
+
+	SMProtobufMessage *pTemplate = new SMProtobufMessage(msg, msgid);
+	Handle_t hndl = handlesys->CreateHandle(g_ProtobufType, pTemplate, pCtx->GetIdentity(), g_pCoreIdent, NULL);
+	if (hndl == BAD_HANDLE)
+	{
+		delete pTemplate;
+	}
+
+	return hndl;
+#endif
+}
+
+static cell_t smn_SendUserMessageTemplate(IPluginContext *pCtx, const cell_t *params)
+{
+#ifndef USE_PROTOBUF_USERMESSAGES
+	return pCtx->ThrowNativeError("Message templates require protobuf usermessages");
+#else
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	HandleError herr;
+	HandleSecurity sec;
+	SMProtobufMessage *msg;
+	cell_t *cl_array;
+	unsigned int numClients;
+	int client;
+	CPlayer *pPlayer = NULL;
+
+	sec.pOwner = NULL;
+	sec.pIdentity = g_pCoreIdent;
+
+	if ((herr=handlesys->ReadHandle(hndl, g_ProtobufType, &sec, (void **)&msg))
+		!= HandleError_None)
+	{
+		return pCtx->ThrowNativeError("Invalid protobuf message handle %x (error %d)", hndl, herr);
+	}
+
+	if (!msg->IsTemplate())
+	{
+		return pCtx->ThrowNativeError("Protobuf handle %x is not a message template", hndl);
+	}
+
+	if (g_IsMsgInExec)
+	{
+		return pCtx->ThrowNativeError("Unable to send a message template, there is already a message in progress");
+	}
+
+	pCtx->LocalToPhysAddr(params[2], &cl_array);
+
+	numClients = params[3];
+
+	/* Client validation */
+	for (unsigned int i = 0; i < numClients; i++)
+	{
+		client = cl_array[i];
+		pPlayer = g_Players.GetPlayerByIndex(client);
+
+		if (!pPlayer)
+		{
+			return pCtx->ThrowNativeError("Client index %d is invalid", client);
+		} else if (!pPlayer->IsConnected()) {
+			return pCtx->ThrowNativeError("Client %d is not connected", client);
+		}
+	}
+
+	if (!g_UserMsgs.SendProtobufMessage(msg->GetTemplateId(), *msg->GetProtobufMessage(), cl_array, numClients, params[4]))
+	{
+		return pCtx->ThrowNativeError("Unable to send a message template while in hook");
+	}
+
+	return 1;
+#endif
+}
+
 static cell_t smn_HookUserMessage(IPluginContext *pCtx, const cell_t *params)
 {
 	IPluginFunction *pHook, *pNotify;
@@ -621,6 +721,8 @@ REGISTER_NATIVES(usrmsgnatives)
 	{"StartMessage",				smn_StartMessage},
 	{"StartMessageEx",				smn_StartMessageEx},
 	{"EndMessage",					smn_EndMessage},
+	{"CreateUserMessageTemplate",	smn_CreateUserMessageTemplate},
+	{"SendUserMessageTemplate",		smn_SendUserMessageTemplate},
 	{"HookUserMessage",				smn_HookUserMessage},
 	{"UnhookUserMessage",			smn_UnhookUserMessage},
 	{NULL,							NULL}
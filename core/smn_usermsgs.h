@@ -70,4 +70,18 @@ extern HandleType_t g_WrBitBufType;
 extern HandleType_t g_RdBitBufType;
 extern HandleType_t g_ProtobufType;
 
+/* Returns string number i of a plugin's char[][] array. */
+inline char *GetArrayString(IPluginContext *pCtx, cell_t *array, int i)
+{
+	if (!pCtx->GetRuntime()->UsesDirectArrays())
+	{
+		/* Old runtimes store each entry as a byte offset from the entry itself. */
+		return (char *)&array[i] + array[i];
+	}
+
+	char *str;
+	pCtx->LocalToString(array[i], &str);
+	return str;
+}
+
 #endif //_INCLUDE_SOURCEMOD_CMSGLISTENERWRAPPER_H_
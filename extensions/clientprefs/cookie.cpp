@@ -32,9 +32,22 @@
 #include "cookie.h"
 #include "menus.h"
 #include "query.h"
+#include <algorithm>
 
 CookieManager g_CookieManager;
 
+/* Authorizations arriving within this window share one select, which keeps a
+ * full server reconnecting after a map change from queueing a query each.
+ */
+static const std::chrono::milliseconds kLoadBatchWindow(250);
+static const size_t kMaxLoadBatch = 32;
+
+/* Values of a disconnected client are reused when it comes back within this
+ * many seconds, which covers a map change without trusting stale data for long.
+ */
+static const time_t kCachedValuesLifetime = 300;
+static const size_t kMaxCachedClients = 256;
+
 CookieManager::CookieManager()
 {
 	for (int i=0; i<=SM_MAXPLAYERS; i++)
@@ -58,6 +71,9 @@ void CookieManager::Unload()
 			OnClientDisconnecting(i);
 	}
 
+	pendingLoads.clear();
+	valueCache.clear();
+
 	/* Find all cookies and delete them */
 	for (size_t iter = 0; iter < cookieList.size(); ++iter)
 		delete cookieList[iter];
@@ -157,15 +173,138 @@ void CookieManager::OnClientAuthorized(int client, const char *authstring)
 	statsPending[client] = true;
 
 	g_ClientPrefs.AttemptReconnection();
-	
-	TQueryOp *op = new TQueryOp(Query_SelectData, player->GetSerial());
-	UTIL_strncpy(op->m_params.steamId, GetPlayerCompatAuthId(player), MAX_NAME_LENGTH);
 
-	g_ClientPrefs.AddQueryToQueue(op);
+	if (pendingLoads.empty())
+	{
+		firstPendingLoad = std::chrono::steady_clock::now();
+	}
+
+	PendingLoad load;
+	load.serial = player->GetSerial();
+	UTIL_strncpy(load.steamId, GetPlayerCompatAuthId(player), MAX_NAME_LENGTH);
+	pendingLoads.push_back(load);
+}
+
+void CookieManager::RunFrame()
+{
+	if (pendingLoads.empty())
+	{
+		return;
+	}
+
+	/* Clients coming back from a map change are answered from memory. The
+	 * forward runs after the list is settled, since it can disconnect people.
+	 */
+	std::vector<PendingLoad> served;
+	for (size_t iter = 0; iter < pendingLoads.size(); ++iter)
+	{
+		int client = playerhelpers->GetClientFromSerial(pendingLoads[iter].serial);
+		if (client != 0 && !LoadCachedValues(client, pendingLoads[iter].steamId))
+		{
+			continue;
+		}
+
+		if (client != 0)
+		{
+			served.push_back(pendingLoads[iter]);
+		}
+
+		pendingLoads.erase(pendingLoads.begin() + iter);
+		iter--;
+	}
+
+	if (pendingLoads.size() >= kMaxLoadBatch
+		|| std::chrono::steady_clock::now() - firstPendingLoad >= kLoadBatchWindow)
+	{
+		SendPendingLoads();
+	}
+
+	for (size_t iter = 0; iter < served.size(); ++iter)
+	{
+		int client = playerhelpers->GetClientFromSerial(served[iter].serial);
+		if (client != 0)
+		{
+			FinishClientLoad(client);
+		}
+	}
+}
+
+void CookieManager::SendPendingLoads()
+{
+	while (!pendingLoads.empty())
+	{
+		size_t count = std::min(pendingLoads.size(), kMaxLoadBatch);
+
+		TQueryOp *op = new TQueryOp(Query_SelectData, 0);
+		op->m_params.clients.assign(pendingLoads.begin(), pendingLoads.begin() + count);
+		pendingLoads.erase(pendingLoads.begin(), pendingLoads.begin() + count);
+
+		g_ClientPrefs.AddQueryToQueue(op);
+	}
+}
+
+void CookieManager::InvalidateCachedValues(const char *steamId)
+{
+	valueCache.erase(steamId);
+}
+
+bool CookieManager::LoadCachedValues(int client, const char *steamId)
+{
+	auto iter = valueCache.find(steamId);
+	if (iter == valueCache.end())
+	{
+		return false;
+	}
+
+	if (time(NULL) - iter->second.stored > kCachedValuesLifetime)
+	{
+		valueCache.erase(iter);
+		return false;
+	}
+
+	std::vector<CachedValue> &values = iter->second.values;
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		AddClientData(client, values[i].cookie, values[i].value, values[i].timestamp);
+	}
+
+	valueCache.erase(iter);
+	return true;
+}
+
+void CookieManager::StoreCachedValues(int client, const char *steamId)
+{
+	if (valueCache.size() >= kMaxCachedClients && valueCache.find(steamId) == valueCache.end())
+	{
+		auto oldest = valueCache.begin();
+		for (auto iter = valueCache.begin(); iter != valueCache.end(); ++iter)
+		{
+			if (iter->second.stored < oldest->second.stored)
+				oldest = iter;
+		}
+		valueCache.erase(oldest);
+	}
+
+	CachedClient &cached = valueCache[steamId];
+	cached.stored = time(NULL);
+	cached.values.clear();
+
+	std::vector<CookieData *> &clientvec = clientData[client];
+	for (size_t iter = 0; iter < clientvec.size(); ++iter)
+	{
+		CachedValue value;
+		value.cookie = clientvec[iter]->parent;
+		UTIL_strncpy(value.value, clientvec[iter]->value, sizeof(value.value));
+		value.timestamp = clientvec[iter]->timestamp;
+		cached.values.push_back(value);
+	}
 }
 
 void CookieManager::OnClientDisconnecting(int client)
 {
+	/* Only a complete set of values is worth remembering */
+	bool loaded = statsLoaded[client];
+
 	connected[client] = false;
 	statsLoaded[client] = false;
 	statsPending[client] = false;
@@ -183,6 +322,20 @@ void CookieManager::OnClientDisconnecting(int client)
 	{
 		pAuth = GetPlayerCompatAuthId(player);
 		g_ClientPrefs.ClearQueryCache(player->GetSerial());
+
+		for (size_t iter = 0; iter < pendingLoads.size(); ++iter)
+		{
+			if (pendingLoads[iter].serial == player->GetSerial())
+			{
+				pendingLoads.erase(pendingLoads.begin() + iter);
+				break;
+			}
+		}
+
+		if (loaded && pAuth != NULL)
+		{
+			StoreCachedValues(client, pAuth);
+		}
 	}
 
 	std::vector<CookieData *> &clientvec = clientData[client];
@@ -212,16 +365,19 @@ void CookieManager::OnClientDisconnecting(int client)
 	clientvec.clear();
 }
 
-void CookieManager::ClientConnectCallback(int serial, IQuery *data)
+void CookieManager::ClientConnectCallback(const std::vector<PendingLoad> &clients, IQuery *data)
 {
-	int client;
-
-	/* Check validity of client */
-	if ((client = playerhelpers->GetClientFromSerial(serial)) == 0)
+	/* Resolve serials up front; a zero index means the client has left */
+	std::vector<int> indexes(clients.size());
+	for (size_t i = 0; i < clients.size(); ++i)
 	{
-		return;
+		int client = playerhelpers->GetClientFromSerial(clients[i].serial);
+		indexes[i] = client;
+		if (client != 0)
+		{
+			statsPending[client] = false;
+		}
 	}
-	statsPending[client] = false;
 	
 	IResultSet *results;
 	/* Check validity of results */
@@ -230,42 +386,72 @@ void CookieManager::ClientConnectCallback(int serial, IQuery *data)
 		return;
 	}
 
-	CookieData *pData;
 	IResultRow *row;
 	unsigned int timestamp;
 	CookieAccess access;
 	
 	while (results->MoreRows() && ((row = results->FetchRow()) != NULL))
 	{
+		const char *player = "";
+		row->GetString(0, &player, NULL);
+
 		const char *name = "";
-		row->GetString(0, &name, NULL);
+		row->GetString(1, &name, NULL);
 		
 		const char *value = "";
-		row->GetString(1, &value, NULL);
-
-		pData = new CookieData(value);
-		pData->changed = false;
+		row->GetString(2, &value, NULL);
 
-		pData->timestamp = (row->GetInt(4, (int *)&timestamp) == DBVal_Data) ? timestamp : 0;
+		time_t stamp = (row->GetInt(5, (int *)&timestamp) == DBVal_Data) ? timestamp : 0;
 
-		Cookie *parent = FindCookie(name);
+		Cookie *parent = NULL;
 
-		if (parent == NULL)
+		/* Fan the row out to every client with this auth id */
+		for (size_t i = 0; i < clients.size(); ++i)
 		{
-			const char *desc = "";
-			row->GetString(2, &desc, NULL);
+			if (indexes[i] == 0 || strcmp(clients[i].steamId, player) != 0)
+			{
+				continue;
+			}
+
+			if (parent == NULL && (parent = FindCookie(name)) == NULL)
+			{
+				const char *desc = "";
+				row->GetString(3, &desc, NULL);
 
-			access = CookieAccess_Public;
-			row->GetInt(3, (int *)&access);
+				access = CookieAccess_Public;
+				row->GetInt(4, (int *)&access);
 
-			parent = CreateCookie(name, desc, access);
+				parent = CreateCookie(name, desc, access);
+			}
+
+			AddClientData(indexes[i], parent, value, stamp);
 		}
+	}
 
-		pData->parent = parent;
-		parent->data[client] = pData;
-		clientData[client].push_back(pData);
+	for (size_t i = 0; i < clients.size(); ++i)
+	{
+		/* A forward may have kicked someone further down the list */
+		if (indexes[i] != 0 && playerhelpers->GetClientFromSerial(clients[i].serial) == indexes[i])
+		{
+			FinishClientLoad(indexes[i]);
+		}
 	}
+}
 
+void CookieManager::AddClientData(int client, Cookie *parent, const char *value, time_t timestamp)
+{
+	CookieData *pData = new CookieData(value);
+	pData->changed = false;
+	pData->timestamp = timestamp;
+	pData->parent = parent;
+
+	parent->data[client] = pData;
+	clientData[client].push_back(pData);
+}
+
+void CookieManager::FinishClientLoad(int client)
+{
+	statsPending[client] = false;
 	statsLoaded[client] = true;
 
 	cookieDataLoadedForward->PushCell(client);
@@ -35,6 +35,9 @@
 #include "extension.h"
 #include "am-vector.h"
 #include <sm_namehashset.h>
+#include <chrono>
+#include <string>
+#include <unordered_map>
 
 #define MAX_NAME_LENGTH 30
 #define MAX_DESC_LENGTH 255
@@ -102,6 +105,27 @@ struct Cookie
 	}
 };
 
+/* A client waiting for its cookies to be loaded */
+struct PendingLoad
+{
+	int serial;
+	char steamId[MAX_NAME_LENGTH];
+};
+
+/* Cookie values kept for a client after it disconnected */
+struct CachedValue
+{
+	Cookie *cookie;
+	char value[MAX_VALUE_LENGTH+1];
+	time_t timestamp;
+};
+
+struct CachedClient
+{
+	std::vector<CachedValue> values;
+	time_t stored;
+};
+
 class CookieManager : public IClientListener, public IPluginsListener
 {
 public:
@@ -117,7 +141,7 @@ public:
 
 	void Unload();
 
-	void ClientConnectCallback(int serial, IQuery *data);
+	void ClientConnectCallback(const std::vector<PendingLoad> &clients, IQuery *data);
 	void InsertCookieCallback(Cookie *pCookie, int dbId);
 	void SelectIdCallback(Cookie *pCookie, IQuery *data);
 
@@ -130,6 +154,15 @@ public:
 	
 	bool AreClientCookiesPending(int client);
 
+	/**
+	 * Serves pending loads from the value cache and sends one select for
+	 * the rest once the batching window has passed. Called every frame.
+	 */
+	void RunFrame();
+
+	/* Drops cached values for an auth id whose cookies were written directly. */
+	void InvalidateCachedValues(const char *steamId);
+
 public:
 	IForward *cookieDataLoadedForward;
 	std::vector<Cookie *> cookieList;
@@ -139,6 +172,19 @@ private:
 	NameHashSet<Cookie *> cookieFinder;
 	std::vector<CookieData *> clientData[SM_MAXPLAYERS+1];
 
+	void AddClientData(int client, Cookie *parent, const char *value, time_t timestamp);
+	void FinishClientLoad(int client);
+	bool LoadCachedValues(int client, const char *steamId);
+	void StoreCachedValues(int client, const char *steamId);
+	void SendPendingLoads();
+
+	/* Authorized clients whose select has not been sent yet */
+	std::vector<PendingLoad> pendingLoads;
+	std::chrono::steady_clock::time_point firstPendingLoad;
+
+	/* Values of recently disconnected clients, keyed by auth id */
+	std::unordered_map<std::string, CachedClient> valueCache;
+
 	bool connected[SM_MAXPLAYERS+1];
 	bool statsLoaded[SM_MAXPLAYERS+1];
 	bool statsPending[SM_MAXPLAYERS+1];
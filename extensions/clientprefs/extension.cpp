@@ -50,6 +50,11 @@ HandleType_t g_CookieIterator = 0;
 CookieIteratorHandler g_CookieIteratorHandler;
 DbDriver g_DriverType;
 
+static void FrameHook(bool simulating)
+{
+	g_CookieManager.RunFrame();
+}
+
 bool ClientPrefs::SDK_OnLoad(char *error, size_t maxlength, bool late)
 {
 	DBInfo = dbi->FindDatabaseConf("clientprefs");
@@ -111,6 +116,7 @@ bool ClientPrefs::SDK_OnLoad(char *error, size_t maxlength, bool late)
 	g_CookieManager.clientMenu->SetDefaultTitle("Client Settings:");
 
 	plsys->AddPluginsListener(&g_CookieManager);
+	g_pSM->AddGameFrameHook(&FrameHook);
 
 	phrases = translator->CreatePhraseCollection();
 	phrases->AddPhraseFile("clientprefs.phrases");
@@ -149,6 +155,7 @@ void ClientPrefs::SDK_OnDependenciesDropped()
 {
 	// At this point, we're guaranteed that DBI has flushed the worker thread
 	// for us, so no cookies should have outstanding queries.
+	g_pSM->RemoveGameFrameHook(&FrameHook);
 	g_CookieManager.Unload();
 
 	handlesys->RemoveType(g_CookieType, myself->GetIdentity());
@@ -444,7 +451,21 @@ void ClientPrefs::ClearQueryCache(int serial)
 	for (size_t iter = 0; iter < cachedQueries.size(); ++iter)
 	{
 		TQueryOp *op = cachedQueries[iter];
-		if (op && op->PullQueryType() == Query_SelectData && op->PullQuerySerial() == serial)
+		if (!op || op->PullQueryType() != Query_SelectData)
+			continue;
+
+		/* Selects are batched, so only drop the op once nobody is left in it */
+		std::vector<PendingLoad> &clients = op->m_params.clients;
+		for (size_t i = 0; i < clients.size(); ++i)
+		{
+			if (clients[i].serial == serial)
+			{
+				clients.erase(clients.begin() + i);
+				break;
+			}
+		}
+
+		if (clients.empty())
  		{
 			op->Destroy();
 			cachedQueries.erase(cachedQueries.begin() + iter);
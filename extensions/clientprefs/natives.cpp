@@ -149,6 +149,9 @@ cell_t SetAuthIdCookie(IPluginContext *pContext, const cell_t *params)
 	payload->changed = true;
 	payload->timestamp = time(NULL);
 
+	// a reconnecting client must not pick up values from before this write
+	g_CookieManager.InvalidateCachedValues(steamID);
+
 	// edit database table
 	TQueryOp *op = new TQueryOp(Query_InsertData, pCookie);
 	// limit player auth length which doubles for cookie name length
@@ -45,7 +45,7 @@ void TQueryOp::RunThinkPart()
 
 		case Query_SelectData:
 		{
-			g_CookieManager.ClientConnectCallback(m_serial, m_pResult);
+			g_CookieManager.ClientConnectCallback(m_params.clients, m_pResult);
 			break;
 		}
 
@@ -203,19 +203,27 @@ bool TQueryOp::BindParamsAndRun()
 		{
 			char safe_str[128];
 
-			m_database->QuoteString(m_params.steamId, safe_str, sizeof(safe_str), &ignore);
-
-			g_pSM->Format(query,
-				sizeof(query),
-				"SELECT sm_cookies.name, sm_cookie_cache.value, sm_cookies.description, \
-						sm_cookies.access, sm_cookie_cache.timestamp 	\
+			/* One select for the whole batch; rows are matched back by player */
+			std::string select = "SELECT sm_cookie_cache.player, sm_cookies.name, sm_cookie_cache.value, \
+						sm_cookies.description, sm_cookies.access, sm_cookie_cache.timestamp \
 				FROM sm_cookies				\
 				JOIN sm_cookie_cache		\
 				ON sm_cookies.id = sm_cookie_cache.cookie_id \
-				WHERE player = '%s'",
-				safe_str);
+				WHERE player IN (";
 
-			m_pResult = m_database->DoQuery(query);
+			for (size_t i = 0; i < m_params.clients.size(); i++)
+			{
+				m_database->QuoteString(m_params.clients[i].steamId, safe_str, sizeof(safe_str), &ignore);
+
+				if (i != 0)
+					select += ", ";
+				select += "'";
+				select += safe_str;
+				select += "'";
+			}
+			select += ")";
+
+			m_pResult = m_database->DoQuery(select.c_str());
 
 			return (m_pResult != NULL);
 		}
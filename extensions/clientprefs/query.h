@@ -63,6 +63,9 @@ struct ParamData
 
 	int cookieId;
 	CookieData *data;
+
+	/* Clients whose cookies are fetched by a SelectData query */
+	std::vector<PendingLoad> clients;
 };
 
 class TQueryOp : public IDBThreadOperation
@@ -0,0 +1,427 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod Sample Extension
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#include "asynchttp.h"
+#include <string.h>
+#include <chrono>
+
+/* Requests started but not yet handed back to their owner. */
+static const size_t kMaxRequests = 256;
+
+/* Transfers the thread runs at the same time; the rest wait in line. */
+static const long kMaxConcurrentTransfers = 4;
+
+/* Idle connections the multi handle keeps open for reuse. */
+static const long kMaxCachedConnections = 8;
+
+/* Responses larger than this are dropped rather than buffered. */
+static const size_t kMaxResponseSize = 16 * 1024 * 1024;
+
+/* The bundled libcurl has no curl_multi_wait(), so the thread polls sockets
+ * with select(). Cap each wait so new and cancelled requests are noticed
+ * quickly.
+ */
+static const long kMaxPollMs = 10;
+
+AsyncHttpEngine g_AsyncHttp;
+
+AsyncWebRequest::AsyncWebRequest(const char *url)
+	: url(url),
+	  headers(NULL),
+	  isPost(false),
+	  timeout(0),
+	  handler(NULL),
+	  userdata(NULL),
+	  cancelled(false),
+	  easy(NULL),
+	  result(CURLE_OK),
+	  statusCode(0),
+	  tooLarge(false)
+{
+	errorBuffer[0] = '\0';
+}
+
+AsyncWebRequest::~AsyncWebRequest()
+{
+	curl_slist_free_all(headers);
+}
+
+bool AsyncWebRequest::AddHeader(const char *header)
+{
+	curl_slist *list = curl_slist_append(headers, header);
+	if (list == NULL)
+	{
+		return false;
+	}
+
+	headers = list;
+	return true;
+}
+
+void AsyncWebRequest::SetPostData(const void *data, size_t length)
+{
+	postData.assign((const char *)data, length);
+	isPost = true;
+}
+
+void AsyncWebRequest::SetTimeout(unsigned int seconds)
+{
+	timeout = seconds;
+}
+
+void AsyncWebRequest::Cancel()
+{
+	cancelled = true;
+}
+
+bool AsyncWebRequest::Succeeded()
+{
+	return result == CURLE_OK && !tooLarge;
+}
+
+int AsyncWebRequest::GetStatusCode()
+{
+	return (int)statusCode;
+}
+
+const char *AsyncWebRequest::GetBody(size_t *length)
+{
+	if (length)
+	{
+		*length = body.size();
+	}
+	return body.c_str();
+}
+
+const char *AsyncWebRequest::LastErrorMessage()
+{
+	if (tooLarge)
+	{
+		return "Response is too large";
+	}
+	if (errorBuffer[0] != '\0')
+	{
+		return errorBuffer;
+	}
+	return curl_easy_strerror(result);
+}
+
+size_t AsyncWebRequest::OnWrite(void *ptr, size_t size, size_t nmemb, void *stream)
+{
+	AsyncWebRequest *request = (AsyncWebRequest *)stream;
+	size_t total = size * nmemb;
+
+	/* Returning a short count makes curl abort the transfer. */
+	if (request->body.size() + total > kMaxResponseSize)
+	{
+		request->tooLarge = true;
+		return 0;
+	}
+
+	request->body.append((const char *)ptr, total);
+	return total;
+}
+
+AsyncHttpEngine::AsyncHttpEngine()
+	: m_InFlight(0),
+	  m_Pending(kMaxRequests),
+	  m_Done(kMaxRequests),
+	  m_Terminate(false),
+	  m_Multi(NULL)
+{
+}
+
+bool AsyncHttpEngine::Start(AsyncWebRequest *request, IAsyncTransferHandler *handler, void *userdata)
+{
+	if (m_InFlight >= kMaxRequests)
+	{
+		return false;
+	}
+
+	if (!m_Thread)
+	{
+		m_Terminate = false;
+		m_Thread.reset(new std::thread([this]() -> void {
+			ThreadMain();
+		}));
+	}
+
+	request->handler = handler;
+	request->userdata = userdata;
+	request->cancelled = false;
+	m_InFlight++;
+
+	m_Pending.TryPush(request);
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Wake.notify_one();
+	}
+	return true;
+}
+
+void AsyncHttpEngine::RunFrame()
+{
+	if (!m_InFlight)
+	{
+		return;
+	}
+
+	m_Done.Drain([this](AsyncWebRequest *request) -> void {
+		m_InFlight--;
+		if (request->cancelled)
+		{
+			delete request;
+			return;
+		}
+		request->handler->OnAsyncTransferComplete(request, request->userdata);
+	});
+}
+
+void AsyncHttpEngine::Shutdown()
+{
+	if (m_Thread)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Lock);
+			m_Terminate = true;
+			m_Wake.notify_one();
+		}
+		m_Thread->join();
+		m_Thread.reset();
+	}
+
+	/* Nothing is delivered anymore; owners are going away with us. */
+	auto discard = [](AsyncWebRequest *request) -> void {
+		delete request;
+	};
+	m_Pending.Drain(discard);
+	m_Done.Drain(discard);
+	m_InFlight = 0;
+}
+
+void AsyncHttpEngine::ThreadMain()
+{
+	m_Multi = curl_multi_init();
+	curl_multi_setopt(m_Multi, CURLMOPT_MAXCONNECTS, kMaxCachedConnections);
+
+	while (!m_Terminate)
+	{
+		AsyncWebRequest *request;
+		while ((long)m_Active.size() < kMaxConcurrentTransfers && m_Pending.TryPop(&request))
+		{
+			if (request->cancelled)
+			{
+				Finish(request, CURLE_ABORTED_BY_CALLBACK);
+				continue;
+			}
+			Activate(request);
+		}
+
+		for (size_t i = 0; i < m_Active.size(); )
+		{
+			request = m_Active[i];
+			if (!request->cancelled)
+			{
+				i++;
+				continue;
+			}
+			Detach(request);
+			Finish(request, CURLE_ABORTED_BY_CALLBACK);
+		}
+
+		if (m_Active.empty())
+		{
+			std::unique_lock<std::mutex> lock(m_Lock);
+			m_Wake.wait(lock, [this]() -> bool {
+				return m_Terminate || !m_Pending.empty();
+			});
+			continue;
+		}
+
+		int running;
+		while (curl_multi_perform(m_Multi, &running) == CURLM_CALL_MULTI_PERFORM)
+		{
+		}
+
+		CURLMsg *msg;
+		int left;
+		while ((msg = curl_multi_info_read(m_Multi, &left)) != NULL)
+		{
+			if (msg->msg != CURLMSG_DONE)
+			{
+				continue;
+			}
+
+			/* The message does not survive removing its handle. */
+			CURLcode code = msg->data.result;
+			char *priv;
+			curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &priv);
+
+			request = (AsyncWebRequest *)priv;
+			Detach(request);
+			Finish(request, code);
+		}
+
+		if (!m_Active.empty())
+		{
+			WaitForActivity();
+		}
+	}
+
+	while (!m_Active.empty())
+	{
+		AsyncWebRequest *request = m_Active.back();
+		Detach(request);
+		Finish(request, CURLE_ABORTED_BY_CALLBACK);
+	}
+
+	for (size_t i = 0; i < m_FreeHandles.size(); i++)
+	{
+		curl_easy_cleanup(m_FreeHandles[i]);
+	}
+	m_FreeHandles.clear();
+
+	curl_multi_cleanup(m_Multi);
+	m_Multi = NULL;
+}
+
+void AsyncHttpEngine::Activate(AsyncWebRequest *request)
+{
+	CURL *easy;
+	if (!m_FreeHandles.empty())
+	{
+		easy = m_FreeHandles.back();
+		m_FreeHandles.pop_back();
+	}
+	else if ((easy = curl_easy_init()) == NULL)
+	{
+		Finish(request, CURLE_FAILED_INIT);
+		return;
+	}
+
+	request->easy = easy;
+	curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, request->errorBuffer);
+	curl_easy_setopt(easy, CURLOPT_NOPROGRESS, 1);
+	curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1);
+	curl_easy_setopt(easy, CURLOPT_PRIVATE, request);
+	curl_easy_setopt(easy, CURLOPT_URL, request->url.c_str());
+	curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1);
+	curl_easy_setopt(easy, CURLOPT_MAXREDIRS, 5);
+	curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, AsyncWebRequest::OnWrite);
+	curl_easy_setopt(easy, CURLOPT_WRITEDATA, request);
+	curl_easy_setopt(easy, CURLOPT_TIMEOUT, (long)request->timeout);
+	if (request->headers)
+	{
+		curl_easy_setopt(easy, CURLOPT_HTTPHEADER, request->headers);
+	}
+	if (request->isPost)
+	{
+		curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request->postData.c_str());
+		curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, (long)request->postData.size());
+	}
+
+	if (curl_multi_add_handle(m_Multi, easy) != CURLM_OK)
+	{
+		Finish(request, CURLE_FAILED_INIT);
+		return;
+	}
+
+	m_Active.push_back(request);
+}
+
+void AsyncHttpEngine::Detach(AsyncWebRequest *request)
+{
+	for (size_t i = 0; i < m_Active.size(); i++)
+	{
+		if (m_Active[i] == request)
+		{
+			m_Active[i] = m_Active.back();
+			m_Active.pop_back();
+			break;
+		}
+	}
+	curl_multi_remove_handle(m_Multi, request->easy);
+}
+
+void AsyncHttpEngine::Finish(AsyncWebRequest *request, CURLcode code)
+{
+	request->result = code;
+
+	if (request->easy)
+	{
+		if (code == CURLE_OK)
+		{
+			curl_easy_getinfo(request->easy, CURLINFO_RESPONSE_CODE, &request->statusCode);
+		}
+
+		/* Reset drops every option pointing into the request. Open
+		 * connections stay in the multi handle's cache for the next transfer.
+		 */
+		curl_easy_reset(request->easy);
+		m_FreeHandles.push_back(request->easy);
+		request->easy = NULL;
+	}
+
+	m_Done.TryPush(request);
+}
+
+void AsyncHttpEngine::WaitForActivity()
+{
+	fd_set readfds, writefds, errorfds;
+	int maxfd = -1;
+	long timeout_ms = -1;
+
+	FD_ZERO(&readfds);
+	FD_ZERO(&writefds);
+	FD_ZERO(&errorfds);
+	curl_multi_fdset(m_Multi, &readfds, &writefds, &errorfds, &maxfd);
+	curl_multi_timeout(m_Multi, &timeout_ms);
+
+	if (timeout_ms < 0 || timeout_ms > kMaxPollMs)
+	{
+		timeout_ms = kMaxPollMs;
+	}
+
+	/* No sockets yet (name resolution, say), or curl wants to run now. */
+	if (maxfd == -1)
+	{
+		if (timeout_ms > 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+		}
+		return;
+	}
+
+	struct timeval tv;
+	tv.tv_sec = timeout_ms / 1000;
+	tv.tv_usec = (timeout_ms % 1000) * 1000;
+	select(maxfd + 1, &readfds, &writefds, &errorfds, &tv);
+}
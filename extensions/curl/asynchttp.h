@@ -0,0 +1,128 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod Sample Extension
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#ifndef _INCLUDE_SOURCEMOD_ASYNCHTTP_H_
+#define _INCLUDE_SOURCEMOD_ASYNCHTTP_H_
+
+#include <IWebternet.h>
+#include <curl/curl.h>
+#include <sm_ringbuffer.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace SourceMod;
+
+class AsyncWebRequest : public IAsyncWebRequest
+{
+	friend class AsyncHttpEngine;
+public:
+	explicit AsyncWebRequest(const char *url);
+	~AsyncWebRequest();
+public:
+	bool AddHeader(const char *header);
+	void SetPostData(const void *data, size_t length);
+	void SetTimeout(unsigned int seconds);
+	void Cancel();
+	bool Succeeded();
+	int GetStatusCode();
+	const char *GetBody(size_t *length);
+	const char *LastErrorMessage();
+private:
+	static size_t OnWrite(void *ptr, size_t size, size_t nmemb, void *stream);
+private:
+	std::string url;
+	curl_slist *headers;
+	std::string postData;
+	bool isPost;
+	unsigned int timeout;
+
+	/* Set by the game thread when the request is started. */
+	IAsyncTransferHandler *handler;
+	void *userdata;
+	std::atomic<bool> cancelled;
+
+	/* Filled in by the transfer thread. */
+	CURL *easy;
+	CURLcode result;
+	long statusCode;
+	bool tooLarge;
+	std::string body;
+	char errorBuffer[CURL_ERROR_SIZE];
+};
+
+/**
+ * Runs every asynchronous request on one thread through a single multi
+ * handle, so connections to the same host are kept alive between requests.
+ * Requests are handed over through lock-free rings and completions are
+ * delivered from a game frame hook.
+ */
+class AsyncHttpEngine
+{
+public:
+	AsyncHttpEngine();
+public:
+	bool Start(AsyncWebRequest *request, IAsyncTransferHandler *handler, void *userdata);
+	void RunFrame();
+	void Shutdown();
+private:
+	void ThreadMain();
+	void Activate(AsyncWebRequest *request);
+	void Finish(AsyncWebRequest *request, CURLcode code);
+	void Detach(AsyncWebRequest *request);
+	void WaitForActivity();
+private:
+	/* Game thread only */
+	size_t m_InFlight;
+	std::unique_ptr<std::thread> m_Thread;
+
+	/* Requests waiting for a transfer slot, and finished requests. Both
+	 * rings have room for every request that can be in flight.
+	 */
+	RingBuffer<AsyncWebRequest *> m_Pending;
+	RingBuffer<AsyncWebRequest *> m_Done;
+	std::mutex m_Lock;
+	std::condition_variable m_Wake;
+	std::atomic<bool> m_Terminate;
+
+	/* Transfer thread only */
+	CURLM *m_Multi;
+	std::vector<AsyncWebRequest *> m_Active;
+	std::vector<CURL *> m_FreeHandles;
+};
+
+extern AsyncHttpEngine g_AsyncHttp;
+
+#endif /* _INCLUDE_SOURCEMOD_ASYNCHTTP_H_ */
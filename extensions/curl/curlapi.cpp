@@ -1,4 +1,5 @@
 #include "curlapi.h"
+#include "asynchttp.h"
 
 Webternet g_webternet;
 
@@ -206,3 +207,15 @@ IWebForm *Webternet::CreateForm()
 {
 	return new WebForm();
 }
+
+IAsyncWebRequest *Webternet::CreateAsyncRequest(const char *url)
+{
+	return new AsyncWebRequest(url);
+}
+
+bool Webternet::StartAsyncRequest(IAsyncWebRequest *request,
+	IAsyncTransferHandler *handler,
+	void *userdata)
+{
+	return g_AsyncHttp.Start(static_cast<AsyncWebRequest *>(request), handler, userdata);
+}
@@ -83,6 +83,10 @@ public:
 public:
 	IWebTransfer *CreateSession();
 	IWebForm *CreateForm();
+	IAsyncWebRequest *CreateAsyncRequest(const char *url);
+	bool StartAsyncRequest(IAsyncWebRequest *request,
+		IAsyncTransferHandler *handler,
+		void *userdata);
 };
 
 extern Webternet g_webternet;
@@ -35,6 +35,7 @@
 #include <sm_platform.h>
 #include <curl/curl.h>
 #include "curlapi.h"
+#include "asynchttp.h"
 
 /**
  * @file extension.cpp
@@ -45,6 +46,11 @@ CurlExt curl_ext;		/**< Global singleton for extension's main interface */
 
 SMEXT_LINK(&curl_ext);
 
+static void OnGameFrame(bool simulating)
+{
+	g_AsyncHttp.RunFrame();
+}
+
 bool CurlExt::SDK_OnLoad(char *error, size_t maxlength, bool late)
 {
 	long flags;
@@ -68,11 +74,22 @@ bool CurlExt::SDK_OnLoad(char *error, size_t maxlength, bool late)
 		return false;
 	}
 
+	if (!RegisterHTTPNatives(error, maxlength))
+	{
+		return false;
+	}
+
+	smutils->AddGameFrameHook(&OnGameFrame);
+
 	return true;
 }
 
 void CurlExt::SDK_OnUnload()
 {
+	/* Closing the handles cancels plugin requests before the thread stops. */
+	UnregisterHTTPNatives();
+	smutils->RemoveGameFrameHook(&OnGameFrame);
+	g_AsyncHttp.Shutdown();
 	curl_global_cleanup();
 }
 
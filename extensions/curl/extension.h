@@ -118,6 +118,9 @@ public:
 #endif
 };
 
+bool RegisterHTTPNatives(char *error, size_t maxlength);
+void UnregisterHTTPNatives();
+
 size_t UTIL_Format(char *buffer, size_t maxlength, const char *fmt, ...);
 size_t UTIL_FormatArgs(char *buffer, size_t maxlength, const char *fmt, va_list ap);
 
@@ -0,0 +1,368 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod Sample Extension
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+#include "extension.h"
+#include "asynchttp.h"
+#include <string>
+
+/**
+ * @file httpnatives.cpp
+ * @brief Plugin natives for asynchronous HTTP requests.
+ */
+
+class HTTPRequest : public IAsyncTransferHandler
+{
+public:
+	enum State
+	{
+		State_Unsent,
+		State_Sending,
+		State_Done,
+	};
+public:
+	HTTPRequest(AsyncWebRequest *request, IdentityToken_t *owner)
+		: request(request), owner(owner), handle(BAD_HANDLE),
+		  callback(NULL), data(0), state(State_Unsent), timeout(0)
+	{
+	}
+public:
+	void OnAsyncTransferComplete(IAsyncWebRequest *request, void *userdata);
+public:
+	AsyncWebRequest *request;
+	IdentityToken_t *owner;
+	Handle_t handle;
+	IPluginFunction *callback;
+	cell_t data;
+	State state;
+	unsigned int timeout;
+};
+
+class HTTPRequestHandler : public IHandleTypeDispatch
+{
+public:
+	void OnHandleDestroy(HandleType_t type, void *object)
+	{
+		HTTPRequest *http = (HTTPRequest *)object;
+
+		/* A request in flight belongs to the engine until it comes back. */
+		if (http->state == HTTPRequest::State_Sending)
+		{
+			http->request->Cancel();
+		}
+		else
+		{
+			delete http->request;
+		}
+		delete http;
+	}
+
+	bool GetHandleApproxSize(HandleType_t type, void *object, unsigned int *pSize)
+	{
+		HTTPRequest *http = (HTTPRequest *)object;
+		size_t length = 0;
+		if (http->state == HTTPRequest::State_Done)
+		{
+			http->request->GetBody(&length);
+		}
+		*pSize = (unsigned int)(sizeof(HTTPRequest) + sizeof(AsyncWebRequest) + length);
+		return true;
+	}
+};
+
+static HTTPRequestHandler s_HTTPRequestHandler;
+static HandleType_t s_HTTPRequestType = 0;
+
+void HTTPRequest::OnAsyncTransferComplete(IAsyncWebRequest *request, void *userdata)
+{
+	state = State_Done;
+
+	/* The callback may delete the handle, and us with it. */
+	Handle_t hndl = handle;
+	HandleSecurity sec(owner, myself->GetIdentity());
+
+	callback->PushCell(hndl);
+	callback->PushCell(request->Succeeded() ? 1 : 0);
+	callback->PushCell(request->GetStatusCode());
+	callback->PushCell(data);
+	callback->Execute(NULL);
+
+	handlesys->FreeHandle(hndl, &sec);
+}
+
+static HTTPRequest *ReadHTTPRequest(IPluginContext *pContext, Handle_t hndl)
+{
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	HandleError err;
+	HTTPRequest *http;
+
+	if ((err = handlesys->ReadHandle(hndl, s_HTTPRequestType, &sec, (void **)&http))
+		!= HandleError_None)
+	{
+		pContext->ThrowNativeError("Invalid HTTPRequest handle %x (error %d)", hndl, err);
+		return NULL;
+	}
+	return http;
+}
+
+static HTTPRequest *ReadUnsentRequest(IPluginContext *pContext, Handle_t hndl)
+{
+	HTTPRequest *http = ReadHTTPRequest(pContext, hndl);
+	if (http && http->state != HTTPRequest::State_Unsent)
+	{
+		pContext->ThrowNativeError("HTTPRequest has already been sent");
+		return NULL;
+	}
+	return http;
+}
+
+static cell_t HTTPRequest_Ctor(IPluginContext *pContext, const cell_t *params)
+{
+	char *url;
+	pContext->LocalToString(params[1], &url);
+	if (url[0] == '\0')
+	{
+		return pContext->ThrowNativeError("URL cannot be empty");
+	}
+
+	HTTPRequest *http = new HTTPRequest(new AsyncWebRequest(url), pContext->GetIdentity());
+
+	HandleError err;
+	Handle_t hndl = handlesys->CreateHandle(s_HTTPRequestType,
+		http,
+		pContext->GetIdentity(),
+		myself->GetIdentity(),
+		&err);
+	if (hndl == BAD_HANDLE)
+	{
+		delete http->request;
+		delete http;
+		return pContext->ThrowNativeError("Could not create HTTPRequest handle (error %d)", err);
+	}
+
+	http->handle = hndl;
+	return hndl;
+}
+
+static cell_t HTTPRequest_SetHeader(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadUnsentRequest(pContext, params[1]);
+	if (!http)
+	{
+		return 0;
+	}
+
+	char *name, *value;
+	pContext->LocalToString(params[2], &name);
+	pContext->LocalToString(params[3], &value);
+
+	std::string header(name);
+	header.append(": ");
+	header.append(value);
+	return http->request->AddHeader(header.c_str()) ? 1 : 0;
+}
+
+static cell_t HTTPRequest_SetBody(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadUnsentRequest(pContext, params[1]);
+	if (!http)
+	{
+		return 0;
+	}
+
+	char *body;
+	pContext->LocalToString(params[2], &body);
+	http->request->SetPostData(body, strlen(body));
+	return 0;
+}
+
+static cell_t HTTPRequest_Timeout_get(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadHTTPRequest(pContext, params[1]);
+	if (!http)
+	{
+		return 0;
+	}
+
+	return (cell_t)http->timeout;
+}
+
+static cell_t HTTPRequest_Timeout_set(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadUnsentRequest(pContext, params[1]);
+	if (!http)
+	{
+		return 0;
+	}
+
+	if (params[2] < 0)
+	{
+		return pContext->ThrowNativeError("Invalid timeout: %d", params[2]);
+	}
+
+	http->timeout = (unsigned int)params[2];
+	http->request->SetTimeout(http->timeout);
+	return 0;
+}
+
+static cell_t HTTPRequest_Send(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadUnsentRequest(pContext, params[1]);
+	if (!http)
+	{
+		return 0;
+	}
+
+	/* The callback must not outlive its plugin, so only the owner may send. */
+	if (http->owner != pContext->GetIdentity())
+	{
+		return pContext->ThrowNativeError("HTTPRequest can only be sent by the plugin that created it");
+	}
+
+	IPluginFunction *callback = pContext->GetFunctionById(params[2]);
+	if (!callback)
+	{
+		return pContext->ThrowNativeError("Invalid function id (%X)", params[2]);
+	}
+
+	http->callback = callback;
+	http->data = params[3];
+	if (!g_AsyncHttp.Start(http->request, http, NULL))
+	{
+		return 0;
+	}
+
+	http->state = HTTPRequest::State_Sending;
+	return 1;
+}
+
+static cell_t HTTPRequest_Status_get(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadHTTPRequest(pContext, params[1]);
+	if (!http || http->state != HTTPRequest::State_Done)
+	{
+		return 0;
+	}
+
+	return http->request->GetStatusCode();
+}
+
+static cell_t HTTPRequest_BodyLength_get(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadHTTPRequest(pContext, params[1]);
+	if (!http || http->state != HTTPRequest::State_Done)
+	{
+		return 0;
+	}
+
+	size_t length;
+	http->request->GetBody(&length);
+	return (cell_t)length;
+}
+
+static cell_t HTTPRequest_GetBody(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadHTTPRequest(pContext, params[1]);
+	if (!http)
+	{
+		return 0;
+	}
+
+	const char *body = "";
+	if (http->state == HTTPRequest::State_Done)
+	{
+		body = http->request->GetBody(NULL);
+	}
+
+	size_t written;
+	pContext->StringToLocalUTF8(params[2], params[3], body, &written);
+	return (cell_t)written;
+}
+
+static cell_t HTTPRequest_GetError(IPluginContext *pContext, const cell_t *params)
+{
+	HTTPRequest *http = ReadHTTPRequest(pContext, params[1]);
+	if (!http)
+	{
+		return 0;
+	}
+
+	const char *error = "";
+	if (http->state == HTTPRequest::State_Done && !http->request->Succeeded())
+	{
+		error = http->request->LastErrorMessage();
+	}
+
+	pContext->StringToLocal(params[2], params[3], error);
+	return 0;
+}
+
+sp_nativeinfo_t http_natives[] =
+{
+	{"HTTPRequest.HTTPRequest",         HTTPRequest_Ctor},
+	{"HTTPRequest.SetHeader",           HTTPRequest_SetHeader},
+	{"HTTPRequest.SetBody",             HTTPRequest_SetBody},
+	{"HTTPRequest.Timeout.get",         HTTPRequest_Timeout_get},
+	{"HTTPRequest.Timeout.set",         HTTPRequest_Timeout_set},
+	{"HTTPRequest.Send",                HTTPRequest_Send},
+	{"HTTPRequest.Status.get",          HTTPRequest_Status_get},
+	{"HTTPRequest.BodyLength.get",      HTTPRequest_BodyLength_get},
+	{"HTTPRequest.GetBody",             HTTPRequest_GetBody},
+	{"HTTPRequest.GetError",            HTTPRequest_GetError},
+	{NULL,                              NULL},
+};
+
+bool RegisterHTTPNatives(char *error, size_t maxlength)
+{
+	s_HTTPRequestType = handlesys->CreateType("HTTPRequest",
+		&s_HTTPRequestHandler,
+		0,
+		NULL,
+		NULL,
+		myself->GetIdentity(),
+		NULL);
+	if (s_HTTPRequestType == 0)
+	{
+		smutils->Format(error, maxlength, "Could not create HTTPRequest handle type");
+		return false;
+	}
+
+	sharesys->AddNatives(myself, http_natives);
+	return true;
+}
+
+void UnregisterHTTPNatives()
+{
+	if (s_HTTPRequestType != 0)
+	{
+		handlesys->RemoveType(s_HTTPRequestType, myself->GetIdentity());
+		s_HTTPRequestType = 0;
+	}
+}
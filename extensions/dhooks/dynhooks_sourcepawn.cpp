@@ -140,7 +140,7 @@ bool RemoveDetourPluginHook(HookType_t hookType, CHook *pDetour, IPluginFunction
 		if (pWrapper->plugin_callback == pCallback)
 		{
 			bRemoved = true;
-			delete pWrapper;
+			pWrapper->Remove();
 			wrappers->erase(wrappers->begin() + i);
 		}
 	}
@@ -177,7 +177,7 @@ void RemoveAllCallbacksForContext(HookType_t hookType, DetourMap *map, IPluginCo
 			if (pWrapper->plugin_callback->GetParentRuntime()->GetDefaultContext() != pContext)
 				continue;
 
-			delete pWrapper;
+			pWrapper->Remove();
 			wrappers->erase(wrappers->begin() + i);
 		}
 
@@ -214,7 +214,7 @@ void CleanupDetours(HookType_t hookType, DetourMap *map)
 		for (int i = wrappers->size() - 1; i >= 0; i--)
 		{
 			pWrapper = wrappers->at(i);
-			delete pWrapper;
+			pWrapper->Remove();
 		}
 
 		// Unhook the function
@@ -348,16 +348,19 @@ ReturnAction_t HandleDetour(HookType_t hookType, CHook* pDetour)
 	// List of all callbacks.
 	PluginCallbackList *wrappers = r->value;
 
-	HookReturnStruct *returnStruct = NULL;
-	Handle_t rHndl = BAD_HANDLE;
-
-	HookParamsStruct *paramStruct = NULL;
-	Handle_t pHndl = BAD_HANDLE;
-
 	int argNum = pDetour->m_pCallingConvention->m_vecArgTypes.size();
 	// Keep a copy of the last return value if some plugin wants to override or supercede the function.
+	// Return values fit into the stack buffer unless the function returns a large object by value.
 	ReturnAction_t finalRet = ReturnAction_Ignored;
-	std::unique_ptr<uint8_t[]> finalRetBuf = std::make_unique<uint8_t[]>(pDetour->m_pCallingConvention->m_returnType.size);
+	size_t returnSize = pDetour->m_pCallingConvention->m_returnType.size;
+	uint8_t finalRetStackBuf[16] = {0};
+	std::unique_ptr<uint8_t[]> finalRetHeapBuf;
+	uint8_t *finalRetBuf = finalRetStackBuf;
+	if (returnSize > sizeof(finalRetStackBuf))
+	{
+		finalRetHeapBuf = std::make_unique<uint8_t[]>(returnSize);
+		finalRetBuf = finalRetHeapBuf.get();
+	}
 
 	// Call all the plugin functions..
 	for (size_t i = 0; i < wrappers->size(); i++)
@@ -365,6 +368,12 @@ ReturnAction_t HandleDetour(HookType_t hookType, CHook* pDetour)
 		CDynamicHooksSourcePawn *pWrapper = wrappers->at(i);
 		IPluginFunction *pCallback = pWrapper->plugin_callback;
 
+		HookReturnStruct *returnStruct = NULL;
+		Handle_t rHndl = BAD_HANDLE;
+
+		HookParamsStruct *paramStruct = NULL;
+		Handle_t pHndl = BAD_HANDLE;
+
 		// Create a seperate buffer for changed return values for this plugin.
 		// We update the finalRet above if the tempRet is higher than the previous ones in the callback list.
 		ReturnAction_t tempRet = ReturnAction_Ignored;
@@ -380,49 +389,36 @@ ReturnAction_t HandleDetour(HookType_t hookType, CHook* pDetour)
 			pCallback->PushCell(thisAddr);
 		}
 
-		// Create the structure for plugins to change/get the return value if the function returns something.
+		pWrapper->EnterCallback();
+
+		// Fill the structure for plugins to change/get the return value if the function returns something.
 		if (pWrapper->returnType != ReturnType_Void)
 		{
-			// Create a handle for the return value to pass to the plugin callback.
-			returnStruct = pWrapper->GetReturnStruct();
 			HandleError err;
-			rHndl = handlesys->CreateHandle(g_HookReturnHandle, returnStruct, pCallback->GetParentRuntime()->GetDefaultContext()->GetIdentity(), myself->GetIdentity(), &err);
-			if (!rHndl)
+			returnStruct = pWrapper->GetReturnStruct(&rHndl, &err);
+			if (!returnStruct)
 			{
+				pWrapper->LeaveCallback();
 				pCallback->Cancel();
 				pCallback->GetParentRuntime()->GetDefaultContext()->BlamePluginError(pCallback, "Error creating ReturnHandle in preparation to call hook callback. (error %d)", err);
 
-				if (returnStruct)
-					delete returnStruct;
-
 				// Don't call more callbacks. They will probably fail too.
 				break;
 			}
 			pCallback->PushCell(rHndl);
 		}
 
-		// Create the structure for plugins to access the function arguments if it has some.
+		// Fill the structure for plugins to access the function arguments if it has some.
 		if (argNum > 0)
 		{
-			paramStruct = pWrapper->GetParamStruct();
 			HandleError err;
-			pHndl = handlesys->CreateHandle(g_HookParamsHandle, paramStruct, pCallback->GetParentRuntime()->GetDefaultContext()->GetIdentity(), myself->GetIdentity(), &err);
-			if (!pHndl)
+			paramStruct = pWrapper->GetParamStruct(&pHndl, &err);
+			if (!paramStruct)
 			{
+				pWrapper->LeaveCallback();
 				pCallback->Cancel();
 				pCallback->GetParentRuntime()->GetDefaultContext()->BlamePluginError(pCallback, "Error creating ThisHandle in preparation to call hook callback. (error %d)", err);
 
-				// Don't leak our own handles here! Free the return struct if we fail during the argument marshalling.
-				if (rHndl)
-				{
-					HandleSecurity sec(pCallback->GetParentRuntime()->GetDefaultContext()->GetIdentity(), myself->GetIdentity());
-					handlesys->FreeHandle(rHndl, &sec);
-					rHndl = BAD_HANDLE;
-				}
-
-				if (paramStruct)
-					delete paramStruct;
-
 				// Don't call more callbacks. They will probably fail too.
 				break;
 			}
@@ -493,26 +489,19 @@ ReturnAction_t HandleDetour(HookType_t hookType, CHook* pDetour)
 		{
 			// Copy the action and return value.
 			finalRet = tempRet;
-			memcpy(finalRetBuf.get(), &tempRetBuf, pDetour->m_pCallingConvention->m_returnType.size);
+			memcpy(finalRetBuf, &tempRetBuf, returnSize);
 		}
 
-		// Free the handles again.
-		HandleSecurity sec(pCallback->GetParentRuntime()->GetDefaultContext()->GetIdentity(), myself->GetIdentity());
-		if (returnStruct)
-		{
-			handlesys->FreeHandle(rHndl, &sec);
-		}
-		if (paramStruct)
-		{
-			handlesys->FreeHandle(pHndl, &sec);
-		}
+		// The structures and handles stay allocated for the next call.
+		// This deletes the wrapper if the callback removed its hook, so don't touch it afterwards.
+		pWrapper->LeaveCallback();
 	}
 
 	// If we want to use our own return value, write it back.
 	if (finalRet >= ReturnAction_Override)
 	{
 		void* pPtr = pDetour->m_pCallingConvention->GetReturnPtr(pDetour->m_pRegisters);
-		memcpy(pPtr, finalRetBuf.get(), pDetour->m_pCallingConvention->m_returnType.size);
+		memcpy(pPtr, finalRetBuf, returnSize);
 		pDetour->m_pCallingConvention->ReturnPtrChanged(pDetour->m_pRegisters, pPtr);
 	}
 
@@ -532,109 +521,171 @@ CDynamicHooksSourcePawn::CDynamicHooksSourcePawn(HookSetup *setup, CHook *pDetou
 	this->hookType = setup->hookType;
 	this->m_pDetour = pDetour;
 	this->callConv = setup->callConv;
+	this->m_depth = 0;
+	this->m_removed = false;
 }
 
-HookReturnStruct *CDynamicHooksSourcePawn::GetReturnStruct()
+CDynamicHooksSourcePawn::~CDynamicHooksSourcePawn()
 {
-	// Create buffers to store the return value of the function.
-	HookReturnStruct *res = new HookReturnStruct();
-	res->isChanged = false;
-	res->type = this->returnType;
-	res->orgResult = NULL;
-	res->newResult = NULL;
+	// Freeing the handles deletes the structures too.
+	HandleSecurity sec(myself->GetIdentity(), myself->GetIdentity());
+	for (size_t i = 0; i < m_storage.size(); i++)
+	{
+		if (m_storage[i]->returnHandle != BAD_HANDLE)
+			handlesys->FreeHandle(m_storage[i]->returnHandle, &sec);
+		if (m_storage[i]->paramsHandle != BAD_HANDLE)
+			handlesys->FreeHandle(m_storage[i]->paramsHandle, &sec);
+	}
+}
 
-	// Copy the actual function's return value too for post hooks.
-	if (this->post)
+void CDynamicHooksSourcePawn::EnterCallback()
+{
+	if (m_depth == m_storage.size())
+		m_storage.push_back(std::make_unique<CallbackStorage>());
+	m_depth++;
+}
+
+void CDynamicHooksSourcePawn::LeaveCallback()
+{
+	m_depth--;
+	if (m_depth == 0 && m_removed)
+		delete this;
+}
+
+void CDynamicHooksSourcePawn::Remove()
+{
+	if (m_depth > 0)
+		m_removed = true;
+	else
+		delete this;
+}
+
+CDynamicHooksSourcePawn::CallbackStorage *CDynamicHooksSourcePawn::GetStorage()
+{
+	return m_storage[m_depth - 1].get();
+}
+
+HookReturnStruct *CDynamicHooksSourcePawn::GetReturnStruct(Handle_t *pHndl, HandleError *err)
+{
+	CallbackStorage *storage = GetStorage();
+	HookReturnStruct *res = storage->returnStruct;
+
+	// Create buffers to store the return value of the function the first time
+	// this nesting level is used. The handle is owned by us, so plugins can't
+	// close it from under us.
+	if (!res)
 	{
+		res = new HookReturnStruct();
+		res->type = this->returnType;
+		res->orgResult = NULL;
+		res->newResult = NULL;
+
 		switch (this->returnType)
 		{
 		case ReturnType_String:
 			res->orgResult = malloc(sizeof(string_t));
 			res->newResult = malloc(sizeof(string_t));
-			*(string_t *)res->orgResult = m_pDetour->GetReturnValue<string_t>();
 			break;
 		case ReturnType_Int:
 			res->orgResult = malloc(sizeof(int));
 			res->newResult = malloc(sizeof(int));
-			*(int *)res->orgResult = m_pDetour->GetReturnValue<int>();
 			break;
 		case ReturnType_Bool:
 			res->orgResult = malloc(sizeof(bool));
 			res->newResult = malloc(sizeof(bool));
-			*(bool *)res->orgResult = m_pDetour->GetReturnValue<bool>();
 			break;
 		case ReturnType_Float:
 			res->orgResult = malloc(sizeof(float));
 			res->newResult = malloc(sizeof(float));
-			*(float *)res->orgResult = m_pDetour->GetReturnValue<float>();
 			break;
 		case ReturnType_Vector:
-		{
 			res->orgResult = malloc(sizeof(SDKVector));
 			res->newResult = malloc(sizeof(SDKVector));
-			SDKVector vec = m_pDetour->GetReturnValue<SDKVector>();
-			*(SDKVector *)res->orgResult = vec;
 			break;
-		}
 		default:
-			res->orgResult = m_pDetour->GetReturnValue<void *>();
 			break;
 		}
+
+		storage->returnHandle = handlesys->CreateHandle(g_HookReturnHandle, res, myself->GetIdentity(), myself->GetIdentity(), err);
+		if (!storage->returnHandle)
+		{
+			delete res;
+			return NULL;
+		}
+		storage->returnStruct = res;
 	}
+
+	res->isChanged = false;
+	*pHndl = storage->returnHandle;
+
+	// Copy the actual function's return value too for post hooks.
 	// Pre hooks don't have access to the return value yet - duh.
-	// Just create the buffers for overridden values.
-	// TODO: Strip orgResult malloc.
-	else
+	switch (this->returnType)
 	{
-		switch (this->returnType)
-		{
-		case ReturnType_String:
-			res->orgResult = malloc(sizeof(string_t));
-			res->newResult = malloc(sizeof(string_t));
-			*(string_t *)res->orgResult = NULL_STRING;
-			break;
-		case ReturnType_Vector:
-			res->orgResult = malloc(sizeof(SDKVector));
-			res->newResult = malloc(sizeof(SDKVector));
-			*(SDKVector *)res->orgResult = SDKVector();
-			break;
-		case ReturnType_Int:
-			res->orgResult = malloc(sizeof(int));
-			res->newResult = malloc(sizeof(int));
-			*(int *)res->orgResult = 0;
-			break;
-		case ReturnType_Bool:
-			res->orgResult = malloc(sizeof(bool));
-			res->newResult = malloc(sizeof(bool));
-			*(bool *)res->orgResult = false;
-			break;
-		case ReturnType_Float:
-			res->orgResult = malloc(sizeof(float));
-			res->newResult = malloc(sizeof(float));
-			*(float *)res->orgResult = 0.0;
-			break;
-		}
+	case ReturnType_String:
+		*(string_t *)res->orgResult = this->post ? m_pDetour->GetReturnValue<string_t>() : NULL_STRING;
+		break;
+	case ReturnType_Int:
+		*(int *)res->orgResult = this->post ? m_pDetour->GetReturnValue<int>() : 0;
+		break;
+	case ReturnType_Bool:
+		*(bool *)res->orgResult = this->post ? m_pDetour->GetReturnValue<bool>() : false;
+		break;
+	case ReturnType_Float:
+		*(float *)res->orgResult = this->post ? m_pDetour->GetReturnValue<float>() : 0.0f;
+		break;
+	case ReturnType_Vector:
+		*(SDKVector *)res->orgResult = this->post ? m_pDetour->GetReturnValue<SDKVector>() : SDKVector();
+		break;
+	default:
+		// Pointer types store the value itself and are replaced, not written to.
+		res->orgResult = this->post ? m_pDetour->GetReturnValue<void *>() : NULL;
+		res->newResult = NULL;
+		break;
 	}
 
 	return res;
 }
 
-HookParamsStruct *CDynamicHooksSourcePawn::GetParamStruct()
+HookParamsStruct *CDynamicHooksSourcePawn::GetParamStruct(Handle_t *pHndl, HandleError *err)
 {
-	// Save argument values of detoured function.
-	HookParamsStruct *params = new HookParamsStruct();
-	params->dg = this;
-	
+	CallbackStorage *storage = GetStorage();
+	HookParamsStruct *params = storage->paramStruct;
+
 	ICallingConvention* callingConvention = m_pDetour->m_pCallingConvention;
 	size_t stackSize = callingConvention->GetArgStackSize();
 	size_t paramsSize = stackSize + callingConvention->GetArgRegisterSize();
 	std::vector<DataTypeSized_t> &argTypes = callingConvention->m_vecArgTypes;
 	size_t numArgs = argTypes.size();
 
-	// Create space for original parameters and changes plugins might do.
-	params->orgParams = (void **)malloc(paramsSize);
-	params->newParams = (void **)malloc(paramsSize);
-	params->isChanged = (bool *)malloc(numArgs * sizeof(bool));
+	// Create space for original parameters and changes plugins might do the
+	// first time this nesting level is used.
+	if (!params)
+	{
+		params = new HookParamsStruct();
+		params->dg = this;
+		params->orgParams = (void **)malloc(paramsSize);
+		params->newParams = (void **)malloc(paramsSize);
+		params->isChanged = (bool *)malloc(numArgs * sizeof(bool));
+
+		storage->paramsHandle = handlesys->CreateHandle(g_HookParamsHandle, params, myself->GetIdentity(), myself->GetIdentity(), err);
+		if (!storage->paramsHandle)
+		{
+			delete params;
+			return NULL;
+		}
+		storage->paramStruct = params;
+		storage->paramsSize = paramsSize;
+	}
+	else if (paramsSize > storage->paramsSize)
+	{
+		// Register sizes are only known once the detour is set up.
+		params->orgParams = (void **)realloc(params->orgParams, paramsSize);
+		params->newParams = (void **)realloc(params->newParams, paramsSize);
+		storage->paramsSize = paramsSize;
+	}
+
+	*pHndl = storage->paramsHandle;
 
 	// Save old stack parameters.
 	if (stackSize > 0)
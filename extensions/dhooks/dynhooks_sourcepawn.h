@@ -35,6 +35,8 @@
 #include "manager.h"
 #include "vhook.h"
 #include <am-hashmap.h>
+#include <memory>
+#include <vector>
 
 class CDynamicHooksSourcePawn;
 typedef ke::HashMap<IPluginFunction *, CDynamicHooksSourcePawn *, ke::PointerPolicy<IPluginFunction>> CallbackMap;
@@ -52,11 +54,39 @@ extern DetourMap g_pPostDetours;
 class CDynamicHooksSourcePawn : public DHooksInfo {
 public:
 	CDynamicHooksSourcePawn(HookSetup *setup, CHook *pDetour, IPluginFunction *pCallback, bool post);
+	~CDynamicHooksSourcePawn();
 
-	HookReturnStruct *GetReturnStruct();
-	HookParamsStruct *GetParamStruct();
+	// The return and param structures and their handles are allocated once and
+	// reused for every call. The plugin callback can call the detoured function
+	// again, so there is one set per nesting level. Each EnterCallback() must be
+	// paired with a LeaveCallback().
+	void EnterCallback();
+	void LeaveCallback();
+
+	// Deletes the wrapper. A plugin callback can remove its own hook while
+	// HandleDetour still uses the wrapper, so then the delete is deferred
+	// until the outermost LeaveCallback().
+	void Remove();
+
+	HookReturnStruct *GetReturnStruct(Handle_t *pHndl, HandleError *err);
+	HookParamsStruct *GetParamStruct(Handle_t *pHndl, HandleError *err);
 	void UpdateParamsFromStruct(HookParamsStruct *params);
 
+private:
+	struct CallbackStorage
+	{
+		HookReturnStruct *returnStruct = nullptr;
+		Handle_t returnHandle = BAD_HANDLE;
+		HookParamsStruct *paramStruct = nullptr;
+		Handle_t paramsHandle = BAD_HANDLE;
+		size_t paramsSize = 0;
+	};
+	CallbackStorage *GetStorage();
+
+	std::vector<std::unique_ptr<CallbackStorage>> m_storage;
+	size_t m_depth;
+	bool m_removed;
+
 public:
 	CHook *m_pDetour;
 	CallingConvention callConv;
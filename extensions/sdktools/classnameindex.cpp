@@ -0,0 +1,287 @@
+/**
+* vim: set ts=4 :
+* =============================================================================
+* SourceMod SDKTools Extension
+* Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, AlliedModders LLC gives you permission to link the
+* code of this program (as well as its derivative works) to "Half-Life 2," the
+* "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, AlliedModders LLC grants
+* this exception to all derivative works.  AlliedModders LLC defines further
+* exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+* or <http://www.sourcemod.net/license.php>.
+*
+* Version: $Id$
+*/
+
+#include "classnameindex.h"
+#include <algorithm>
+#include <ctype.h>
+
+ClassnameIndex g_ClassnameIndex;
+
+static void LowerName(const char *name, std::string &out)
+{
+	out.clear();
+	for (; *name; name++)
+	{
+		out.push_back((char)tolower((unsigned char)*name));
+	}
+}
+
+static bool MatchesName(const std::string &classname, const std::string &name, bool prefix)
+{
+	if (prefix)
+	{
+		return classname.compare(0, name.size(), name) == 0;
+	}
+	return classname == name;
+}
+
+ClassnameIndex::ClassnameIndex()
+	: m_pSDKHooks(NULL)
+{
+}
+
+void ClassnameIndex::Attach(ISDKHooks *sdkhooks)
+{
+#if SOURCE_ENGINE >= SE_ORANGEBOX
+	if (m_pSDKHooks || !sdkhooks)
+	{
+		return;
+	}
+
+	m_pSDKHooks = sdkhooks;
+	m_pSDKHooks->AddEntityListener(this);
+	Seed();
+#endif
+}
+
+void ClassnameIndex::Detach()
+{
+	if (!m_pSDKHooks)
+	{
+		return;
+	}
+
+	m_pSDKHooks->RemoveEntityListener(this);
+	m_pSDKHooks = NULL;
+	Clear();
+}
+
+void ClassnameIndex::Clear()
+{
+	m_Classes.clear();
+	m_Entities.clear();
+	m_Recent.clear();
+}
+
+void ClassnameIndex::Seed()
+{
+	Clear();
+
+#if SOURCE_ENGINE >= SE_ORANGEBOX
+	/* Anything spawned before we started listening has to be picked up by
+	 * hand, e.g. when SDKHooks is loaded mid-map.
+	 */
+	if (!g_SdkTools.HasAnyLevelInited())
+	{
+		return;
+	}
+
+	CBaseEntity *pEntity = (CBaseEntity *)servertools->FirstEntity();
+	while (pEntity)
+	{
+		Add(pEntity, gamehelpers->GetEntityClassname(pEntity));
+		pEntity = (CBaseEntity *)servertools->NextEntity(pEntity);
+	}
+#endif
+}
+
+void ClassnameIndex::OnEntityCreated(CBaseEntity *pEntity, const char *classname)
+{
+	Add(pEntity, classname);
+	m_Recent.insert(pEntity);
+}
+
+void ClassnameIndex::OnEntityDestroyed(CBaseEntity *pEntity)
+{
+	Remove(pEntity);
+	m_Entities.erase(pEntity);
+	m_Recent.erase(pEntity);
+}
+
+void ClassnameIndex::Refile(CBaseEntity *pEntity)
+{
+	const char *classname = gamehelpers->GetEntityClassname(pEntity);
+
+	auto iter = m_Entities.find(pEntity);
+	if (iter != m_Entities.end() && classname
+		&& strcasecmp(classname, iter->second.cls->first.c_str()) == 0)
+	{
+		return;
+	}
+
+	Add(pEntity, classname);
+}
+
+void ClassnameIndex::Add(CBaseEntity *pEntity, const char *classname)
+{
+	/* The pointer may be reused if a destroy notification was missed. */
+	Remove(pEntity);
+
+	if (!classname || !classname[0])
+	{
+		m_Entities.erase(pEntity);
+		return;
+	}
+
+	cell_t ref = gamehelpers->EntityToBCompatRef(pEntity);
+	int index = gamehelpers->ReferenceToIndex(ref);
+	if (index < 0)
+	{
+		m_Entities.erase(pEntity);
+		return;
+	}
+
+	std::string name;
+	LowerName(classname, name);
+
+	/* Class entries are never erased, so the iterator stays valid. */
+	ClassMap::iterator cls = m_Classes.emplace(name, EntitySet()).first;
+	cls->second[index] = ref;
+
+	IndexedEntity &entry = m_Entities[pEntity];
+	entry.cls = cls;
+	entry.index = index;
+}
+
+void ClassnameIndex::Remove(CBaseEntity *pEntity)
+{
+	auto iter = m_Entities.find(pEntity);
+	if (iter == m_Entities.end())
+	{
+		return;
+	}
+
+	/* Only drop the slot if another entity hasn't taken the index since. */
+	EntitySet &entities = iter->second.cls->second;
+	EntitySet::iterator slot = entities.find(iter->second.index);
+	if (slot != entities.end() && gamehelpers->ReferenceToEntity(slot->second) == pEntity)
+	{
+		entities.erase(slot);
+	}
+}
+
+void ClassnameIndex::Collect(const std::string &name, bool prefix, std::vector<CBaseEntity *> &renamed,
+	std::vector<std::pair<int, cell_t> > &found)
+{
+	ClassMap::iterator iter = prefix ? m_Classes.lower_bound(name) : m_Classes.find(name);
+	for (; iter != m_Classes.end() && MatchesName(iter->first, name, prefix); iter++)
+	{
+		EntitySet::iterator ent = iter->second.begin();
+		while (ent != iter->second.end())
+		{
+			CBaseEntity *pEntity = gamehelpers->ReferenceToEntity(ent->second);
+			if (!pEntity)
+			{
+				ent++;
+				continue;
+			}
+
+			const char *classname = gamehelpers->GetEntityClassname(pEntity);
+			if (!classname || strcasecmp(classname, iter->first.c_str()) != 0)
+			{
+				/* Either the entity was renamed, or the slot is left over
+				 * from an entity whose destruction we never saw and the
+				 * index now belongs to something else.
+				 */
+				auto entry = m_Entities.find(pEntity);
+				if (entry != m_Entities.end() && entry->second.cls == iter)
+				{
+					renamed.push_back(pEntity);
+					ent++;
+				}
+				else
+				{
+					ent = iter->second.erase(ent);
+				}
+				continue;
+			}
+
+			found.push_back(std::make_pair(ent->first, ent->second));
+			ent++;
+		}
+
+		if (!prefix)
+		{
+			break;
+		}
+	}
+}
+
+void ClassnameIndex::Find(const char *pattern, std::vector<cell_t> &results)
+{
+	std::string name;
+	LowerName(pattern, name);
+
+	bool prefix = false;
+	if (!name.empty() && name[name.size() - 1] == '*')
+	{
+		name.erase(name.size() - 1);
+		prefix = true;
+	}
+
+	/* Entities usually get their final classname from keyvalues while they
+	 * spawn, after the create notification. Catch up on those first so they
+	 * are found under the new name.
+	 */
+	for (auto iter = m_Recent.begin(); iter != m_Recent.end(); iter++)
+	{
+		Refile(*iter);
+	}
+	m_Recent.clear();
+
+	std::vector<CBaseEntity *> renamed;
+	std::vector<std::pair<int, cell_t> > found;
+	Collect(name, prefix, renamed, found);
+
+	/* A few entities change classname after they are created. Refile them
+	 * under their current name and keep the ones that now match.
+	 */
+	for (size_t i = 0; i < renamed.size(); i++)
+	{
+		Add(renamed[i], gamehelpers->GetEntityClassname(renamed[i]));
+
+		auto iter = m_Entities.find(renamed[i]);
+		if (iter != m_Entities.end() && MatchesName(iter->second.cls->first, name, prefix))
+		{
+			found.push_back(std::make_pair(iter->second.index, iter->second.cls->second[iter->second.index]));
+		}
+	}
+
+	if (prefix || !renamed.empty())
+	{
+		std::sort(found.begin(), found.end());
+	}
+
+	for (size_t i = 0; i < found.size(); i++)
+	{
+		results.push_back(found[i].second);
+	}
+}
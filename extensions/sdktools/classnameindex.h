@@ -0,0 +1,102 @@
+/**
+* vim: set ts=4 :
+* =============================================================================
+* SourceMod SDKTools Extension
+* Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, AlliedModders LLC gives you permission to link the
+* code of this program (as well as its derivative works) to "Half-Life 2," the
+* "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, AlliedModders LLC grants
+* this exception to all derivative works.  AlliedModders LLC defines further
+* exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+* or <http://www.sourcemod.net/license.php>.
+*
+* Version: $Id$
+*/
+
+#ifndef _INCLUDE_SDKTOOLS_CLASSNAMEINDEX_H_
+#define _INCLUDE_SDKTOOLS_CLASSNAMEINDEX_H_
+
+#include "extension.h"
+#include <ISDKHooks.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Keeps every live entity filed under its lowercased classname, so plugins
+ * can fetch all entities of a class without walking the entity list. The
+ * index is fed by SDKHooks' entity listener and is only available while
+ * SDKHooks is loaded; callers fall back to a linear walk otherwise.
+ */
+class ClassnameIndex : public ISMEntityListener
+{
+	/* entity index -> entity reference, ordered like the entity list */
+	typedef std::map<int, cell_t> EntitySet;
+	typedef std::map<std::string, EntitySet> ClassMap;
+
+	struct IndexedEntity
+	{
+		ClassMap::iterator cls;
+		int index;
+	};
+public:
+	ClassnameIndex();
+public:
+	void Attach(ISDKHooks *sdkhooks);
+	void Detach();
+	void Clear();
+	bool IsAvailable() const
+	{
+		return m_pSDKHooks != NULL;
+	}
+
+	/**
+	 * Appends the references of every live entity whose classname matches
+	 * the pattern, in entity index order. Matching is case-insensitive and
+	 * a trailing '*' matches any suffix.
+	 */
+	void Find(const char *pattern, std::vector<cell_t> &results);
+
+	/**
+	 * Files the entity under its current classname if it has changed since
+	 * the entity was indexed.
+	 */
+	void Refile(CBaseEntity *pEntity);
+public: //ISMEntityListener
+	void OnEntityCreated(CBaseEntity *pEntity, const char *classname) override;
+	void OnEntityDestroyed(CBaseEntity *pEntity) override;
+private:
+	void Add(CBaseEntity *pEntity, const char *classname);
+	void Remove(CBaseEntity *pEntity);
+	void Seed();
+	void Collect(const std::string &name, bool prefix, std::vector<CBaseEntity *> &renamed,
+		std::vector<std::pair<int, cell_t> > &found);
+private:
+	ISDKHooks *m_pSDKHooks;
+	ClassMap m_Classes;
+	std::unordered_map<CBaseEntity *, IndexedEntity> m_Entities;
+	/* Created since the last lookup; their classname may still change while they spawn. */
+	std::unordered_set<CBaseEntity *> m_Recent;
+};
+
+extern ClassnameIndex g_ClassnameIndex;
+
+#endif //_INCLUDE_SDKTOOLS_CLASSNAMEINDEX_H_
@@ -45,6 +45,7 @@
 #include <ISDKTools.h>
 #include "clientnatives.h"
 #include "teamnatives.h"
+#include "classnameindex.h"
 #include "filesystem.h"
 #include "am-string.h"
 
@@ -70,6 +71,7 @@ IEngineSound *engsound = NULL;
 INetworkStringTableContainer *netstringtables = NULL;
 IServerPluginHelpers *pluginhelpers = NULL;
 IBinTools *g_pBinTools = NULL;
+ISDKHooks *g_pSDKHooks = NULL;
 IGameConfig *g_pGameConf = NULL;
 IGameHelpers *g_pGameHelpers = NULL;
 IServerGameClients *serverClients = NULL;
@@ -92,6 +94,7 @@ SourceHook::CallClass<IVEngineServer> *enginePatch = NULL;
 SourceHook::CallClass<IEngineSound> *enginesoundPatch = NULL;
 HandleType_t g_CallHandle = 0;
 HandleType_t g_TraceHandle = 0;
+HandleType_t g_TETemplateHandle = 0;
 ISDKTools *g_pSDKTools;
 
 SMEXT_LINK(&g_SdkTools);
@@ -169,6 +172,17 @@ bool SDKTools::SDK_OnLoad(char *error, size_t maxlength, bool late)
 		return false;
 	}
 
+	g_TETemplateHandle = handlesys->CreateType("TETemplate", this, 0, NULL, NULL, myself->GetIdentity(), &err);
+	if (g_TETemplateHandle == 0)
+	{
+		handlesys->RemoveType(g_CallHandle, myself->GetIdentity());
+		handlesys->RemoveType(g_TraceHandle, myself->GetIdentity());
+		g_CallHandle = 0;
+		g_TraceHandle = 0;
+		ke::SafeSprintf(error, maxlength, "Could not create tetemplate handle type (err: %d)", err);
+		return false;
+	}
+
 #if SOURCE_ENGINE >= SE_ORANGEBOX
 	g_pCVar = icvar;
 #endif
@@ -233,6 +247,11 @@ void SDKTools::OnHandleDestroy(HandleType_t type, void *object)
 		trace_t *tr = (trace_t *)object;
 		delete tr;
 	}
+	else if (type == g_TETemplateHandle)
+	{
+		TETemplate *tmpl = (TETemplate *)object;
+		delete tmpl;
+	}
 }
 
 void SDKTools::SDK_OnUnload()
@@ -265,6 +284,7 @@ void SDKTools::SDK_OnUnload()
 	s_SoundHooks.Shutdown();
 	g_Hooks.Shutdown();
 	g_OutputManager.Shutdown();
+	g_ClassnameIndex.Detach();
 	VoiceShutdown();
 
 	forwards->ReleaseForward(m_OnClientSpeaking);
@@ -305,6 +325,14 @@ void SDKTools::SDK_OnUnload()
 			g_pSM->LogError(myself, "Could not remove trace handle (type=%x, err=%d)", g_TraceHandle, err);
 		}
 	}
+
+	if (g_TETemplateHandle != 0)
+	{
+		if ((err = handlesys->RemoveType(g_TETemplateHandle, myself->GetIdentity())) != true)
+		{
+			g_pSM->LogError(myself, "Could not remove tetemplate handle (type=%x, err=%d)", g_TETemplateHandle, err);
+		}
+	}
 }
 
 bool SDKTools::SDK_OnMetamodLoad(ISmmAPI *ismm, char *error, size_t maxlen, bool late)
@@ -352,6 +380,10 @@ bool SDKTools::SDK_OnMetamodUnload(char *error, size_t maxlen)
 
 void SDKTools::SDK_OnAllLoaded()
 {
+	/* Optional: only used to keep the classname index up to date. */
+	SM_GET_LATE_IFACE(SDKHOOKS, g_pSDKHooks);
+	g_ClassnameIndex.Attach(g_pSDKHooks);
+
 	SM_GET_LATE_IFACE(BINTOOLS, g_pBinTools);
 
 	if (!g_pBinTools)
@@ -374,6 +406,13 @@ void SDKTools::OnCoreMapStart(edict_t *pEdictList, int edictCount, int clientMax
 	InitTeamNatives();
 	GetResourceEntity();
 	g_Hooks.OnMapStart();
+
+	/* SDKHooks may have been loaded after us. */
+	if (!g_pSDKHooks)
+	{
+		SM_GET_LATE_IFACE(SDKHOOKS, g_pSDKHooks);
+		g_ClassnameIndex.Attach(g_pSDKHooks);
+	}
 }
 
 bool SDKTools::QueryRunning(char *error, size_t maxlength)
@@ -390,11 +429,23 @@ bool SDKTools::QueryInterfaceDrop(SMInterface *pInterface)
 		return false;
 	}
 
+	if (g_pSDKHooks && pInterface == g_pSDKHooks)
+	{
+		return true;
+	}
+
 	return IExtensionInterface::QueryInterfaceDrop(pInterface);
 }
 
 void SDKTools::NotifyInterfaceDrop(SMInterface *pInterface)
 {
+	if (g_pSDKHooks && pInterface == g_pSDKHooks)
+	{
+		g_ClassnameIndex.Detach();
+		g_pSDKHooks = NULL;
+		return;
+	}
+
 	SourceHook::List<ValveCall *>::iterator iter;
 	for (iter = g_RegCalls.begin();
 		iter != g_RegCalls.end();
@@ -453,6 +504,9 @@ bool SDKTools::LevelInit(char const *pMapName, char const *pMapEntities, char co
 void SDKTools::LevelShutdown()
 {
 	ClearValveGlobals();
+	g_ClassnameIndex.Clear();
+	GameRulesNativesLevelShutdown();
+	ClearTeamNatives();
 }
 
 bool SDKTools::ProcessCommandTarget(cmd_target_info_t *info)
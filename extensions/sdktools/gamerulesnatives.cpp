@@ -35,11 +35,46 @@
 
 const char *g_szGameRulesProxy;
 
+/* Props resolved on the gamerules proxy this map, including misses, so the
+ * per-tick natives don't go through core's server class lookup every time.
+ */
+struct GameRulesProp
+{
+	bool found;
+	sm_sendprop_info_t info;
+};
+
+static StringHashMap<GameRulesProp> s_GameRulesProps;
+static cell_t s_ProxyEntRef = -1;
+
 void GameRulesNativesInit()
 {
 	g_szGameRulesProxy = g_pGameConf->GetKeyValue("GameRulesProxy");
 }
 
+void GameRulesNativesLevelShutdown()
+{
+	s_GameRulesProps.clear();
+	s_ProxyEntRef = -1;
+}
+
+static bool FindGameRulesPropInfo(const char *prop, sm_sendprop_info_t *info)
+{
+	GameRulesProp *cached;
+	if (!s_GameRulesProps.retrieve(prop, &cached))
+	{
+		GameRulesProp entry;
+		entry.found = gamehelpers->FindSendPropInfo(g_szGameRulesProxy, prop, &entry.info);
+		s_GameRulesProps.insert(prop, entry);
+
+		*info = entry.info;
+		return entry.found;
+	}
+
+	*info = cached->info;
+	return cached->found;
+}
+
 static CBaseEntity *FindEntityByNetClass(int start, const char *classname)
 {
 	int maxEntities = gpGlobals->maxEntities;
@@ -70,13 +105,13 @@ static CBaseEntity *FindEntityByNetClass(int start, const char *classname)
 
 static CBaseEntity* GetGameRulesProxyEnt()
 {
-	static cell_t proxyEntRef = -1;
+	/* The reference goes stale by itself if the proxy is deleted. */
 	CBaseEntity *pProxy;
-	if (proxyEntRef == -1 || (pProxy = gamehelpers->ReferenceToEntity(proxyEntRef)) == NULL)
+	if (s_ProxyEntRef == -1 || (pProxy = gamehelpers->ReferenceToEntity(s_ProxyEntRef)) == NULL)
 	{
 		pProxy = FindEntityByNetClass(playerhelpers->GetMaxClients(), g_szGameRulesProxy);
 		if (pProxy)
-			proxyEntRef = gamehelpers->EntityToReference(pProxy);
+			s_ProxyEntRef = gamehelpers->EntityToReference(pProxy);
 	}
 	
 	return pProxy;
@@ -96,7 +131,7 @@ enum PropFieldType
 #define FIND_PROP_SEND(type, type_name) \
 	sm_sendprop_info_t info;\
 	SendProp *pProp; \
-	if (!gamehelpers->FindSendPropInfo(g_szGameRulesProxy, prop, &info)) \
+	if (!FindGameRulesPropInfo(prop, &info)) \
 	{ \
 		return pContext->ThrowNativeError("Property \"%s\" not found on the gamerules proxy", prop); \
 	} \
@@ -192,6 +227,40 @@ enum PropFieldType
 			type); \
 	}
 
+static cell_t ReadIntProp(intptr_t addr, int bit_count, bool is_unsigned)
+{
+	if (bit_count >= 17)
+	{
+		return *(int32_t *)addr;
+	}
+	else if (bit_count >= 9)
+	{
+		if (is_unsigned)
+		{
+			return *(uint16_t *)addr;
+		}
+		else
+		{
+			return *(int16_t *)addr;
+		}
+	}
+	else if (bit_count >= 2)
+	{
+		if (is_unsigned)
+		{
+			return *(uint8_t *)addr;
+		}
+		else
+		{
+			return *(int8_t *)addr;
+		}
+	}
+	else
+	{
+		return *(bool *)addr ? 1 : 0;
+	}
+}
+
 static cell_t GameRules_GetProp(IPluginContext *pContext, const cell_t *params)
 {
 	char *prop;
@@ -227,38 +296,7 @@ static cell_t GameRules_GetProp(IPluginContext *pContext, const cell_t *params)
 		bit_count = params[2] * 8;
 	}
 
-	if (bit_count >= 17)
-	{
-		return *(int32_t *)((intptr_t)pGameRules + offset);
-	}
-	else if (bit_count >= 9)
-	{
-		if (is_unsigned)
-		{
-			return *(uint16_t *)((intptr_t)pGameRules + offset);
-		}
-		else
-		{
-			return *(int16_t *)((intptr_t)pGameRules + offset);
-		}
-	}
-	else if (bit_count >= 2)
-	{
-		if (is_unsigned)
-		{
-			return *(uint8_t *)((intptr_t)pGameRules + offset);
-		}
-		else
-		{
-			return *(int8_t *)((intptr_t)pGameRules + offset);
-		}
-	}
-	else
-	{
-		return *(bool *)((intptr_t)pGameRules + offset) ? 1 : 0;
-	}
-
-	return -1;
+	return ReadIntProp((intptr_t)pGameRules + offset, bit_count, is_unsigned);
 }
 
 static cell_t GameRules_SetProp(IPluginContext *pContext, const cell_t *params)
@@ -653,6 +691,170 @@ static cell_t GameRules_SetPropString(IPluginContext *pContext, const cell_t *pa
 	return len;
 }
 
+/* Resolves one entry of a GameRules_GetProps list. Errors are reported on the
+ * context; the caller just has to bail out.
+ */
+static bool ReadGameRulesProp(IPluginContext *pContext, void *pGameRules, const char *prop, int element, cell_t *result)
+{
+	sm_sendprop_info_t info;
+	if (!FindGameRulesPropInfo(prop, &info))
+	{
+		pContext->ThrowNativeError("Property \"%s\" not found on the gamerules proxy", prop);
+		return false;
+	}
+
+	SendProp *pProp = info.prop;
+	int offset = info.actual_offset;
+
+	switch (pProp->GetType())
+	{
+	case DPT_Int:
+	case DPT_Float:
+		{
+			if (element != 0)
+			{
+				pContext->ThrowNativeError("SendProp %s is not an array. Element %d is invalid.", prop, element);
+				return false;
+			}
+			break;
+		}
+	case DPT_Array:
+		{
+			int elementCount = pProp->GetNumElements();
+			int elementStride = pProp->GetElementStride();
+			if (element < 0 || element >= elementCount)
+			{
+				pContext->ThrowNativeError("Element %d is out of bounds (Prop %s has %d elements).", element, prop, elementCount);
+				return false;
+			}
+
+			pProp = pProp->GetArrayProp();
+			if (!pProp)
+			{
+				pContext->ThrowNativeError("Error looking up ArrayProp for prop %s", prop);
+				return false;
+			}
+
+			offset += pProp->GetOffset() + (elementStride * element);
+			break;
+		}
+	case DPT_DataTable:
+		{
+			SendTable *pTable = pProp->GetDataTable();
+			if (!pTable)
+			{
+				pContext->ThrowNativeError("Error looking up DataTable for prop %s", prop);
+				return false;
+			}
+
+			int elementCount = pTable->GetNumProps();
+			if (element < 0 || element >= elementCount)
+			{
+				pContext->ThrowNativeError("Element %d is out of bounds (Prop %s has %d elements).", element, prop, elementCount);
+				return false;
+			}
+
+			pProp = pTable->GetProp(element);
+			offset += pProp->GetOffset();
+			break;
+		}
+	default:
+		break;
+	}
+
+	intptr_t addr = (intptr_t)pGameRules + offset;
+
+	if (pProp->GetType() == DPT_Float)
+	{
+		*result = sp_ftoc(*(float *)addr);
+		return true;
+	}
+
+	if (pProp->GetType() != DPT_Int)
+	{
+		pContext->ThrowNativeError("SendProp %s is not an integer or float (%d)", prop, pProp->GetType());
+		return false;
+	}
+
+	int bit_count = pProp->m_nBits;
+
+#if SOURCE_ENGINE == SE_CSS || SOURCE_ENGINE == SE_HL2DM || SOURCE_ENGINE == SE_DODS || SOURCE_ENGINE == SE_TF2 \
+	|| SOURCE_ENGINE == SE_SDK2013 || SOURCE_ENGINE == SE_BMS || SOURCE_ENGINE == SE_CSGO || SOURCE_ENGINE == SE_BLADE \
+	|| SOURCE_ENGINE == SE_PVKII || SOURCE_ENGINE == SE_MCV
+	if (pProp->GetFlags() & SPROP_VARINT)
+	{
+		bit_count = sizeof(int) * 8;
+	}
+#endif
+
+	if (bit_count < 1)
+	{
+		bit_count = sizeof(int) * 8;
+	}
+
+	*result = ReadIntProp(addr, bit_count, (pProp->GetFlags() & SPROP_UNSIGNED) == SPROP_UNSIGNED);
+	return true;
+}
+
+static cell_t GameRules_GetProps(IPluginContext *pContext, const cell_t *params)
+{
+	void *pGameRules = GameRules();
+
+	if (!pGameRules || !g_szGameRulesProxy || !strcmp(g_szGameRulesProxy, ""))
+		return pContext->ThrowNativeError("Gamerules lookup failed.");
+
+	char *props;
+	cell_t *values;
+	pContext->LocalToString(params[1], &props);
+	pContext->LocalToPhysAddr(params[2], &values);
+	int maxvalues = params[3];
+
+	int count = 0;
+	const char *pos = props;
+	while (true)
+	{
+		while (*pos == ',' || *pos == ' ' || *pos == '\t')
+			pos++;
+
+		if (*pos == '\0')
+			break;
+
+		const char *start = pos;
+		while (*pos != '\0' && *pos != ',' && *pos != ' ' && *pos != '\t')
+			pos++;
+
+		if (count >= maxvalues)
+		{
+			return pContext->ThrowNativeError("More properties than values (%d)", maxvalues);
+		}
+
+		/* Copy the name out so it can be terminated and split from "[element]". */
+		char name[128];
+		size_t len = pos - start;
+		if (len >= sizeof(name))
+		{
+			return pContext->ThrowNativeError("Property name is too long (max %d characters)", (int)sizeof(name) - 1);
+		}
+		memcpy(name, start, len);
+		name[len] = '\0';
+
+		int element = 0;
+		char *bracket = strchr(name, '[');
+		if (bracket)
+		{
+			element = atoi(bracket + 1);
+			*bracket = '\0';
+		}
+
+		if (!ReadGameRulesProp(pContext, pGameRules, name, element, &values[count]))
+			return 0;
+
+		count++;
+	}
+
+	return count;
+}
+
 sp_nativeinfo_t g_GameRulesNatives[] = 
 {
 	{"GameRules_GetProp",			GameRules_GetProp},
@@ -665,6 +867,7 @@ sp_nativeinfo_t g_GameRulesNatives[] =
 	{"GameRules_SetPropVector",		GameRules_SetPropVector},
 	{"GameRules_GetPropString",		GameRules_GetPropString},
 	{"GameRules_SetPropString",		GameRules_SetPropString},
+	{"GameRules_GetProps",			GameRules_GetProps},
 	{NULL,							NULL},
 };
 
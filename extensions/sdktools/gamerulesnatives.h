@@ -38,6 +38,7 @@
  */
 
 void GameRulesNativesInit();
+void GameRulesNativesLevelShutdown();
 
 extern sp_nativeinfo_t g_GameRulesNatives[];
 
@@ -37,12 +37,20 @@ struct TeamInfo
 {
 	const char *ClassName;
 	CBaseEntity *pEnt;
+	cell_t ref;
+	SendProp *pPlayerArray;
 };
 
 const char *m_iScore;
 
 SourceHook::CVector<TeamInfo> g_Teams;
 
+/* Offsets on the team entities, resolved once per map. Zero means the game
+ * doesn't have the prop.
+ */
+static int g_teamname_offset = -1;
+static int g_score_offset = -1;
+
 void InitTeamNatives()
 {
 	g_Teams.clear();
@@ -79,24 +87,55 @@ void InitTeamNatives()
 				}
 				g_Teams[TeamIndex].ClassName = pClass->GetName();
 				g_Teams[TeamIndex].pEnt = pEntity;
+				g_Teams[TeamIndex].ref = gamehelpers->EntityToReference(pEntity);
+				g_Teams[TeamIndex].pPlayerArray = g_pGameHelpers->FindInSendTable(pClass->GetName(), "\"player_array\"");
 			}
 		}
 	}
 }
 
+void ClearTeamNatives()
+{
+	g_Teams.clear();
+	g_teamname_offset = -1;
+	g_score_offset = -1;
+}
+
+/* Team entities normally live for the whole map. If one was deleted anyway,
+ * look them up again once instead of handing out a dangling pointer.
+ */
+static CBaseEntity *GetTeamEnt(int team)
+{
+	if (team < 0 || team >= (int)g_Teams.size() || !g_Teams[team].ClassName)
+		return NULL;
+
+	if (gamehelpers->ReferenceToEntity(g_Teams[team].ref) == g_Teams[team].pEnt)
+		return g_Teams[team].pEnt;
+
+	InitTeamNatives();
+
+	if (team >= (int)g_Teams.size() || !g_Teams[team].ClassName)
+		return NULL;
+
+	return g_Teams[team].pEnt;
+}
+
 static cell_t GetTeamCount(IPluginContext *pContext, const cell_t *params)
 {
 	return g_Teams.size();
 }
 
-static int g_teamname_offset = -1;
-
 const char *tools_GetTeamName(int team)
 {
 	if (size_t(team) >= g_Teams.size())
 		return NULL;
 	if (g_teamname_offset == 0)
 		return NULL;
+
+	CBaseEntity *pTeam = GetTeamEnt(team);
+	if (pTeam == NULL)
+		return NULL;
+
 	if (g_teamname_offset == -1)
 	{
 		SendProp *prop = g_pGameHelpers->FindInSendTable(g_Teams[team].ClassName, "m_szTeamname");
@@ -108,13 +147,13 @@ const char *tools_GetTeamName(int team)
 		g_teamname_offset = prop->GetOffset();
 	}
 
-	return (const char *)((unsigned char *)g_Teams[team].pEnt + g_teamname_offset);
+	return (const char *)((unsigned char *)pTeam + g_teamname_offset);
 }
 
 static cell_t GetTeamName(IPluginContext *pContext, const cell_t *params)
 {
 	int teamindex = params[1];
-	if (teamindex >= (int)g_Teams.size() || !g_Teams[teamindex].ClassName)
+	if (GetTeamEnt(teamindex) == NULL)
 		return pContext->ThrowNativeError("Team index %d is invalid", teamindex);
 
 	if (g_teamname_offset == 0)
@@ -129,12 +168,16 @@ static cell_t GetTeamName(IPluginContext *pContext, const cell_t *params)
 	return 1;
 }
 
-static cell_t GetTeamScore(IPluginContext *pContext, const cell_t *params)
+static int GetScoreOffset(IPluginContext *pContext, int teamindex)
 {
-	int teamindex = params[1];
-	if (teamindex >= (int)g_Teams.size() || !g_Teams[teamindex].ClassName)
+	if (g_score_offset == 0)
 	{
-		return pContext->ThrowNativeError("Team index %d is invalid", teamindex);
+		pContext->ThrowNativeError("Failed to get m_iScore prop");
+		return -1;
+	}
+	if (g_score_offset != -1)
+	{
+		return g_score_offset;
 	}
 
 	if (!m_iScore)
@@ -142,24 +185,39 @@ static cell_t GetTeamScore(IPluginContext *pContext, const cell_t *params)
 		m_iScore = g_pGameConf->GetKeyValue("m_iScore");
 		if (!m_iScore)
 		{
-			return pContext->ThrowNativeError("Failed to get m_iScore key");
+			pContext->ThrowNativeError("Failed to get m_iScore key");
+			return -1;
 		}
 	}
 
-	static int offset = -1;
+	SendProp *prop = g_pGameHelpers->FindInSendTable(g_Teams[teamindex].ClassName, m_iScore);
+	if (!prop)
+	{
+		g_score_offset = 0;
+		pContext->ThrowNativeError("Failed to get m_iScore prop");
+		return -1;
+	}
 
-	if (offset == -1)
+	g_score_offset = prop->GetOffset();
+	return g_score_offset;
+}
+
+static cell_t GetTeamScore(IPluginContext *pContext, const cell_t *params)
+{
+	int teamindex = params[1];
+	CBaseEntity *pTeam = GetTeamEnt(teamindex);
+	if (pTeam == NULL)
 	{
-		SendProp *prop = g_pGameHelpers->FindInSendTable(g_Teams[teamindex].ClassName, m_iScore);
-		if (!prop)
-		{
-			return pContext->ThrowNativeError("Failed to get m_iScore prop");
-		}
-		offset = prop->GetOffset();
+		return pContext->ThrowNativeError("Team index %d is invalid", teamindex);
 	}
 
+	int offset = GetScoreOffset(pContext, teamindex);
+	if (offset == -1)
+	{
+		return 0;
+	}
 
-	return *(int *)((unsigned char *)g_Teams[teamindex].pEnt + offset);
+	return *(int *)((unsigned char *)pTeam + offset);
 }
 
 static cell_t SetTeamScore(IPluginContext *pContext, const cell_t *params)
@@ -170,33 +228,18 @@ static cell_t SetTeamScore(IPluginContext *pContext, const cell_t *params)
 	}
 	
 	int teamindex = params[1];
-	if (teamindex >= (int)g_Teams.size() || !g_Teams[teamindex].ClassName)
+	CBaseEntity *pTeam = GetTeamEnt(teamindex);
+	if (pTeam == NULL)
 	{
 		return pContext->ThrowNativeError("Team index %d is invalid", teamindex);
 	}
 
-	if (m_iScore == NULL)
-	{
-		m_iScore = g_pGameConf->GetKeyValue("m_iScore");
-		if (m_iScore == NULL)
-		{
-			return pContext->ThrowNativeError("Failed to get m_iScore key");
-		}
-	}
-
-	static int offset = -1;
-
+	int offset = GetScoreOffset(pContext, teamindex);
 	if (offset == -1)
 	{
-		SendProp *prop = g_pGameHelpers->FindInSendTable(g_Teams[teamindex].ClassName, m_iScore);
-		if (!prop)
-		{
-			return pContext->ThrowNativeError("Failed to get m_iScore prop");
-		}
-		offset = prop->GetOffset();
+		return 0;
 	}
 
-	CBaseEntity *pTeam = g_Teams[teamindex].pEnt;
 	*(int *)((unsigned char *)pTeam + offset) = params[2];
 
 	edict_t *pEdict = gameents->BaseEntityToEdict(pTeam);
@@ -208,26 +251,33 @@ static cell_t SetTeamScore(IPluginContext *pContext, const cell_t *params)
 static cell_t GetTeamClientCount(IPluginContext *pContext, const cell_t *params)
 {
 	int teamindex = params[1];
-	if (teamindex >= (int)g_Teams.size() || !g_Teams[teamindex].ClassName)
+	CBaseEntity *pTeam = GetTeamEnt(teamindex);
+	if (pTeam == NULL)
 	{
 		return pContext->ThrowNativeError("Team index %d is invalid", teamindex);
 	}
 
-	SendProp *pProp = g_pGameHelpers->FindInSendTable(g_Teams[teamindex].ClassName, "\"player_array\"");
+	SendProp *pProp = g_Teams[teamindex].pPlayerArray;
+	if (pProp == NULL)
+	{
+		return pContext->ThrowNativeError("Team player counts are not available on this game.");
+	}
+
 	ArrayLengthSendProxyFn fn = pProp->GetArrayLengthProxy();
 
-	return fn(g_Teams[teamindex].pEnt, 0);
+	return fn(pTeam, 0);
 }
 
 static cell_t GetTeamEntity(IPluginContext *pContext, const cell_t *params)
 {
 	int teamindex = params[1];
-	if (teamindex >= (int)g_Teams.size() || !g_Teams[teamindex].ClassName)
+	CBaseEntity *pTeam = GetTeamEnt(teamindex);
+	if (pTeam == NULL)
 	{
 		return pContext->ThrowNativeError("Team index %d is invalid", teamindex);
 	}
 
-	return gamehelpers->EntityToBCompatRef(g_Teams[teamindex].pEnt);
+	return gamehelpers->EntityToBCompatRef(pTeam);
 }
 
 sp_nativeinfo_t g_TeamNatives[] = 
@@ -33,6 +33,7 @@
 #define _INCLUDE_SOURCEMOD_TEAMNATIVES_H_
 
 void InitTeamNatives();
+void ClearTeamNatives();
 
 extern const char *tools_GetTeamName(int team);
 
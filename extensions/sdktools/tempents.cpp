@@ -110,48 +110,84 @@ ServerClass *TempEntityInfo::GetServerClass()
 	return m_Sc;
 }
 
+void *TempEntityInfo::GetThisPtr()
+{
+	return m_Me;
+}
+
 bool TempEntityInfo::IsValidProp(const char *name)
 {
-	return (g_pGameHelpers->FindInSendTable(m_Sc->GetName(), name)) ? true : false;
+	return (_FindOffset(name) >= 0);
 }
 
-int TempEntityInfo::_FindOffset(const char *name, int *size)
+bool TempEntityInfo::FindProp(const char *name, TEProp *prop)
 {
-	int offset;
+	/* Props are looked up by name for every TE_Write*, so remember them per TE */
+	TEProp *cached;
+	if (m_Props.retrieve(name, &cached))
+	{
+		*prop = *cached;
+		return (prop->offset >= 0);
+	}
 
 	sm_sendprop_info_t info;
-	if (!g_pGameHelpers->FindSendPropInfo(m_Sc->GetName(), name, &info))
+	if (g_pGameHelpers->FindSendPropInfo(m_Sc->GetName(), name, &info))
+	{
+		prop->offset = info.actual_offset;
+		prop->bits = info.prop->m_nBits;
+	}
+	else
+	{
+		prop->offset = -1;
+		prop->bits = 0;
+	}
+
+	m_Props.insert(name, *prop);
+
+	return (prop->offset >= 0);
+}
+
+int TempEntityInfo::_FindOffset(const char *name, int *size)
+{
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return -1;
 	}
 
-	offset = info.actual_offset;
 	if (size)
 	{
-		*size = info.prop->m_nBits;
+		*size = prop.bits;
 	}
 
-	return offset;
+	return prop.offset;
 }
 
-bool TempEntityInfo::TE_SetEntData(const char *name, int value)
+bool TempEntityInfo::SetData(const TEProp &prop, int value)
 {
-	/* Search for our offset */
-	int size;
-	int offset = _FindOffset(name, &size);
-
-	if (offset < 0)
+	if (prop.bits <= 8)
 	{
+		*((uint8_t *)m_Me + prop.offset) = value;
+	} else if (prop.bits <= 16) {
+		*(short *)((uint8_t *)m_Me + prop.offset) = value;
+	} else if (prop.bits <= 32) {
+		*(int *)((uint8_t *)m_Me + prop.offset) = value;
+	} else {
 		return false;
 	}
 
-	if (size <= 8)
+	return true;
+}
+
+bool TempEntityInfo::GetData(const TEProp &prop, int *value)
+{
+	if (prop.bits <= 8)
 	{
-		*((uint8_t *)m_Me + offset) = value;
-	} else if (size <= 16) {
-		*(short *)((uint8_t *)m_Me + offset) = value;
-	} else if (size <= 32) {
-		*(int *)((uint8_t *)m_Me + offset) = value;
+		*value = *((uint8_t *)m_Me + prop.offset);
+	} else if (prop.bits <= 16) {
+		*value = *(short *)((uint8_t *)m_Me + prop.offset);
+	} else if (prop.bits <= 32) {
+		*value = *(int *)((uint8_t *)m_Me + prop.offset);
 	} else {
 		return false;
 	}
@@ -159,43 +195,81 @@ bool TempEntityInfo::TE_SetEntData(const char *name, int value)
 	return true;
 }
 
-bool TempEntityInfo::TE_GetEntData(const char *name, int *value)
+void TempEntityInfo::SetDataEnt(const TEProp &prop, IHandleEntity *value)
 {
-	/* Search for our offset */
-	int size;
-	int offset = _FindOffset(name, &size);
+	auto *pHndl = (CBaseHandle *)((uint8_t *)m_Me + prop.offset);
+	pHndl->Set(value);
+}
 
-	if (offset < 0)
+bool TempEntityInfo::GetDataEnt(const TEProp &prop, IHandleEntity **value)
+{
+	auto *pHndl = (CBaseHandle *)((uint8_t *)m_Me + prop.offset);
+	auto *pEnt = reinterpret_cast<IHandleEntity *>(gamehelpers->ReferenceToEntity(pHndl->GetEntryIndex()));
+	if (!pEnt || *pHndl != pEnt->GetRefEHandle())
+		return false;
+
+	*value = pEnt;
+
+	return true;
+}
+
+void TempEntityInfo::SetDataFloat(const TEProp &prop, float value)
+{
+	*(float *)((uint8_t *)m_Me + prop.offset) = value;
+}
+
+float TempEntityInfo::GetDataFloat(const TEProp &prop)
+{
+	return *(float *)((uint8_t *)m_Me + prop.offset);
+}
+
+void TempEntityInfo::SetDataVector(const TEProp &prop, const float vector[3])
+{
+	Vector *v = (Vector *)((uint8_t *)m_Me + prop.offset);
+	v->x = vector[0];
+	v->y = vector[1];
+	v->z = vector[2];
+}
+
+void TempEntityInfo::GetDataVector(const TEProp &prop, float vector[3])
+{
+	Vector *v = (Vector *)((uint8_t *)m_Me + prop.offset);
+	vector[0] = v->x;
+	vector[1] = v->y;
+	vector[2] = v->z;
+}
+
+bool TempEntityInfo::TE_SetEntData(const char *name, int value)
+{
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return false;
 	}
 
-	if (size <= 8)
+	return SetData(prop, value);
+}
+
+bool TempEntityInfo::TE_GetEntData(const char *name, int *value)
+{
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
-		*value = *((uint8_t *)m_Me + offset);
-	} else if (size <= 16) {
-		*value = *(short *)((uint8_t *)m_Me + offset);
-	} else if (size <= 32) {
-		*value = *(int *)((uint8_t *)m_Me + offset);
-	} else {
 		return false;
 	}
 
-	return true;
+	return GetData(prop, value);
 }
 
 bool TempEntityInfo::TE_SetEntDataEnt(const char *name, IHandleEntity *value)
 {
-	/* Search for our offset */
-	int offset = _FindOffset(name);
-
-	if (offset < 0)
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return false;
 	}
 
-	auto *pHndl = (CBaseHandle *)((uint8_t *)m_Me + offset);
-	pHndl->Set(value);
+	SetDataEnt(prop, value);
 
 	return true;
 }
@@ -203,86 +277,63 @@ bool TempEntityInfo::TE_SetEntDataEnt(const char *name, IHandleEntity *value)
 
 bool TempEntityInfo::TE_GetEntDataEnt(const char *name, IHandleEntity **value)
 {
-	/* Search for our offset */
-	int offset = _FindOffset(name);
-
-	if (offset < 0)
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return false;
 	}
 
-	auto *pHndl = (CBaseHandle *)((uint8_t *)m_Me + offset);
-	auto *pEnt = reinterpret_cast<IHandleEntity *>(gamehelpers->ReferenceToEntity(pHndl->GetEntryIndex()));
-	if (!pEnt || *pHndl != pEnt->GetRefEHandle())
-		return false;
-
-	*value = pEnt;
-
-	return true;
+	return GetDataEnt(prop, value);
 }
 
 bool TempEntityInfo::TE_SetEntDataFloat(const char *name, float value)
 {
-	/* Search for our offset */
-	int offset = _FindOffset(name);
-
-	if (offset < 0)
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return false;
 	}
 
-	*(float *)((uint8_t *)m_Me + offset) = value;
+	SetDataFloat(prop, value);
 
 	return true;
 }
 
 bool TempEntityInfo::TE_GetEntDataFloat(const char *name, float *value)
 {
-	/* Search for our offset */
-	int offset = _FindOffset(name);
-
-	if (offset < 0)
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return false;
 	}
 
-	*value = *(float *)((uint8_t *)m_Me + offset);
+	*value = GetDataFloat(prop);
 
 	return true;
 }
 
 bool TempEntityInfo::TE_SetEntDataVector(const char *name, float vector[3])
 {
-	/* Search for our offset */
-	int offset = _FindOffset(name);
-
-	if (offset < 0)
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return false;
 	}
 
-	Vector *v = (Vector *)((uint8_t *)m_Me + offset);
-	v->x = vector[0];
-	v->y = vector[1];
-	v->z = vector[2];
+	SetDataVector(prop, vector);
 
 	return true;
 }
 
 bool TempEntityInfo::TE_GetEntDataVector(const char *name, float vector[3])
 {
-	/* Search for our offset */
-	int offset = _FindOffset(name);
-
-	if (offset < 0)
+	TEProp prop;
+	if (!FindProp(name, &prop))
 	{
 		return false;
 	}
 
-	Vector *v = (Vector *)((uint8_t *)m_Me + offset);
-	vector[0] = v->x;
-	vector[1] = v->y;
-	vector[2] = v->z;
+	GetDataVector(prop, vector);
 
 	return true;
 }
@@ -37,6 +37,14 @@
 #include <sh_list.h>
 #include <sh_string.h>
 #include <stdio.h>
+#include <vector>
+
+/* A resolved temp entity prop. An offset of -1 marks a cached miss. */
+struct TEProp
+{
+	int offset;
+	int bits;
+};
 
 class TempEntityInfo
 {
@@ -45,7 +53,17 @@ public:
 public:
 	const char *GetName();
 	ServerClass *GetServerClass();
+	void *GetThisPtr();
 	bool IsValidProp(const char *name);
+	bool FindProp(const char *name, TEProp *prop);
+	bool SetData(const TEProp &prop, int value);
+	bool GetData(const TEProp &prop, int *value);
+	void SetDataEnt(const TEProp &prop, IHandleEntity *value);
+	bool GetDataEnt(const TEProp &prop, IHandleEntity **value);
+	void SetDataFloat(const TEProp &prop, float value);
+	float GetDataFloat(const TEProp &prop);
+	void SetDataVector(const TEProp &prop, const float vector[3]);
+	void GetDataVector(const TEProp &prop, float vector[3]);
 	bool TE_SetEntData(const char *name, int value);
 	bool TE_SetEntDataEnt(const char *name, IHandleEntity *value);
 	bool TE_SetEntDataFloat(const char *name, float value);
@@ -62,6 +80,14 @@ private:
 	void *m_Me;
 	ServerClass *m_Sc;
 	SourceHook::String m_Name;
+	StringHashMap<TEProp> m_Props;
+};
+
+/* A temp entity with a fixed set of props resolved up front. */
+struct TETemplate
+{
+	TempEntityInfo *te;
+	std::vector<TEProp> fields;
 };
 
 class TempEntityManager
@@ -105,6 +131,7 @@ public:
 	bool RemoveHook(const char *name, IPluginFunction *pFunc);
 	void OnPlaybackTempEntity(IRecipientFilter &filter, float delay, const void *pSender, const SendTable *pST, int classID);
 private:
+	TEHookInfo *_FindHookInfo(const void *pSender);
 	void _IncRefCounter();
 	void _DecRefCounter();
 	size_t _FillInPlayers(int *pl_array, IRecipientFilter *pFilter);
@@ -115,6 +142,7 @@ private:
 };
 
 extern TempEntityManager g_TEManager;
+extern HandleType_t g_TETemplateHandle;
 extern TempEntHooks s_TempEntHooks;
 
 #endif //_INCLUDE_SOURCEMOD_TEMPENTS_H_
@@ -198,13 +198,31 @@ bool TempEntHooks::RemoveHook(const char *name, IPluginFunction *pFunc)
 	return true;
 }
 
+TEHookInfo *TempEntHooks::_FindHookInfo(const void *pSender)
+{
+	/* Every TE is a singleton, so its this pointer identifies it. Only a
+	 * handful of TEs are ever hooked, which makes this cheaper than hashing
+	 * the name of every effect the game sends.
+	 */
+	SourceHook::List<TEHookInfo *>::iterator iter;
+	for (iter=m_HookInfo.begin(); iter!=m_HookInfo.end(); iter++)
+	{
+		if ((*iter)->te->GetThisPtr() == pSender)
+		{
+			return (*iter);
+		}
+	}
+
+	return NULL;
+}
+
 void TempEntHooks::OnPlaybackTempEntity(IRecipientFilter &filter, float delay, const void *pSender, const SendTable *pST, int classID)
 {
-	TEHookInfo *pInfo;
-	const char *name = g_TEManager.GetNameFromThisPtr(const_cast<void *>(pSender));
+	TEHookInfo *pInfo = _FindHookInfo(pSender);
 
-	if (m_TEHooks->Retrieve(name, reinterpret_cast<void **>(&pInfo)))
+	if (pInfo)
 	{
+		const char *name = pInfo->te->GetName();
 		SourceHook::List<IPluginFunction *>::iterator iter;
 		IPluginFunction *pFunc;
 		size_t size;
@@ -593,6 +611,258 @@ static cell_t smn_RemoveTempEntHook(IPluginContext *pContext, const cell_t *para
 	return 1;
 }
 
+static TETemplate *ReadTETemplate(IPluginContext *pContext, Handle_t hndl)
+{
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	HandleError err;
+	TETemplate *tmpl;
+
+	if ((err = handlesys->ReadHandle(hndl, g_TETemplateHandle, &sec, (void **)&tmpl))
+		!= HandleError_None)
+	{
+		pContext->ThrowNativeError("Invalid TETemplate handle %x (error %d)", hndl, err);
+		return NULL;
+	}
+
+	return tmpl;
+}
+
+/* Reads and writes go to the TE itself, so they are only valid while that TE
+ * is current: after TETemplate.Start() or inside a hook on it.
+ */
+static const TEProp *GetTemplateField(IPluginContext *pContext, const cell_t *params)
+{
+	if (!g_TEManager.IsAvailable())
+	{
+		pContext->ThrowNativeError("TempEntity System unsupported or not available, file a bug report");
+		return NULL;
+	}
+
+	TETemplate *tmpl = ReadTETemplate(pContext, params[1]);
+	if (!tmpl)
+	{
+		return NULL;
+	}
+
+	if (g_CurrentTE != tmpl->te)
+	{
+		pContext->ThrowNativeError("No \"%s\" TempEntity call is in progress", tmpl->te->GetName());
+		return NULL;
+	}
+
+	if (params[2] < 0 || (size_t)params[2] >= tmpl->fields.size())
+	{
+		pContext->ThrowNativeError("Invalid field %d (template has %d fields)", params[2], (int)tmpl->fields.size());
+		return NULL;
+	}
+
+	return &tmpl->fields[params[2]];
+}
+
+static cell_t smn_TETemplate(IPluginContext *pContext, const cell_t *params)
+{
+	if (!g_TEManager.IsAvailable())
+	{
+		return pContext->ThrowNativeError("TempEntity System unsupported or not available, file a bug report");
+	}
+
+	char *name;
+	pContext->LocalToString(params[1], &name);
+
+	TempEntityInfo *te = g_TEManager.GetTempEntityInfo(name);
+	if (!te)
+	{
+		return pContext->ThrowNativeError("Invalid TempEntity name: \"%s\"", name);
+	}
+
+	TETemplate *tmpl = new TETemplate;
+	tmpl->te = te;
+
+	Handle_t hndl = handlesys->CreateHandle(g_TETemplateHandle, tmpl, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+	if (hndl == BAD_HANDLE)
+	{
+		delete tmpl;
+	}
+
+	return hndl;
+}
+
+static cell_t smn_TETemplateAddField(IPluginContext *pContext, const cell_t *params)
+{
+	if (!g_TEManager.IsAvailable())
+	{
+		return pContext->ThrowNativeError("TempEntity System unsupported or not available, file a bug report");
+	}
+
+	TETemplate *tmpl = ReadTETemplate(pContext, params[1]);
+	if (!tmpl)
+	{
+		return 0;
+	}
+
+	char *prop;
+	pContext->LocalToString(params[2], &prop);
+
+	TEProp field;
+	if (!tmpl->te->FindProp(prop, &field))
+	{
+		return pContext->ThrowNativeError("Temp entity property \"%s\" not found", prop);
+	}
+
+	tmpl->fields.push_back(field);
+
+	return (cell_t)tmpl->fields.size() - 1;
+}
+
+static cell_t smn_TETemplateStart(IPluginContext *pContext, const cell_t *params)
+{
+	if (!g_TEManager.IsAvailable())
+	{
+		return pContext->ThrowNativeError("TempEntity System unsupported or not available, file a bug report");
+	}
+
+	TETemplate *tmpl = ReadTETemplate(pContext, params[1]);
+	if (!tmpl)
+	{
+		return 0;
+	}
+
+	g_CurrentTE = tmpl->te;
+
+	return 1;
+}
+
+static cell_t smn_TETemplateWriteNum(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	if (!g_CurrentTE->SetData(*field, params[3]))
+	{
+		return pContext->ThrowNativeError("Field %d is not an integer of 32 bits or less", params[2]);
+	}
+
+	return 1;
+}
+
+static cell_t smn_TETemplateReadNum(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	int val;
+	if (!g_CurrentTE->GetData(*field, &val))
+	{
+		return pContext->ThrowNativeError("Field %d is not an integer of 32 bits or less", params[2]);
+	}
+
+	return val;
+}
+
+static cell_t smn_TETemplateWriteFloat(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	g_CurrentTE->SetDataFloat(*field, sp_ctof(params[3]));
+
+	return 1;
+}
+
+static cell_t smn_TETemplateReadFloat(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	return sp_ftoc(g_CurrentTE->GetDataFloat(*field));
+}
+
+static cell_t smn_TETemplateWriteVector(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	cell_t *addr;
+	pContext->LocalToPhysAddr(params[3], &addr);
+	float vec[3] = {sp_ctof(addr[0]), sp_ctof(addr[1]), sp_ctof(addr[2])};
+
+	g_CurrentTE->SetDataVector(*field, vec);
+
+	return 1;
+}
+
+static cell_t smn_TETemplateReadVector(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	cell_t *addr;
+	float vec[3];
+	pContext->LocalToPhysAddr(params[3], &addr);
+
+	g_CurrentTE->GetDataVector(*field, vec);
+
+	addr[0] = sp_ftoc(vec[0]);
+	addr[1] = sp_ftoc(vec[1]);
+	addr[2] = sp_ftoc(vec[2]);
+
+	return 1;
+}
+
+static cell_t smn_TETemplateWriteEnt(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	CBaseEntity *pEntity = gamehelpers->ReferenceToEntity(params[3]);
+	if (!pEntity && params[3] != -1)
+	{
+		return pContext->ThrowNativeError("Entity %d (%d) is invalid", gamehelpers->ReferenceToIndex(params[3]), params[3]);
+	}
+
+	g_CurrentTE->SetDataEnt(*field, reinterpret_cast<IHandleEntity *>(pEntity));
+
+	return 1;
+}
+
+static cell_t smn_TETemplateReadEnt(IPluginContext *pContext, const cell_t *params)
+{
+	const TEProp *field = GetTemplateField(pContext, params);
+	if (!field)
+	{
+		return 0;
+	}
+
+	IHandleEntity *val;
+	if (!g_CurrentTE->GetDataEnt(*field, &val))
+	{
+		return -1;
+	}
+
+	return gamehelpers->EntityToBCompatRef(reinterpret_cast<CBaseEntity *>(val));
+}
+
 sp_nativeinfo_t g_TENatives[] = 
 {
 	{"TE_Start",				smn_TEStart},
@@ -610,5 +880,16 @@ sp_nativeinfo_t g_TENatives[] =
 	{"TE_WriteFloatArray",		smn_TEWriteFloatArray},
 	{"AddTempEntHook",			smn_AddTempEntHook},
 	{"RemoveTempEntHook",		smn_RemoveTempEntHook},
+	{"TETemplate.TETemplate",	smn_TETemplate},
+	{"TETemplate.AddField",		smn_TETemplateAddField},
+	{"TETemplate.Start",		smn_TETemplateStart},
+	{"TETemplate.WriteNum",		smn_TETemplateWriteNum},
+	{"TETemplate.ReadNum",		smn_TETemplateReadNum},
+	{"TETemplate.WriteFloat",	smn_TETemplateWriteFloat},
+	{"TETemplate.ReadFloat",	smn_TETemplateReadFloat},
+	{"TETemplate.WriteVector",	smn_TETemplateWriteVector},
+	{"TETemplate.ReadVector",	smn_TETemplateReadVector},
+	{"TETemplate.WriteEnt",		smn_TETemplateWriteEnt},
+	{"TETemplate.ReadEnt",		smn_TETemplateReadEnt},
 	{NULL,						NULL}
 };
@@ -40,6 +40,10 @@ ValveCall::ValveCall()
 	retinfo = NULL;
 	thisinfo = NULL;
 	retbuf = NULL;
+	batchOffsets = NULL;
+	batchRowCells = 0;
+	batchRetCells = 0;
+	batchSupported = false;
 }
 
 ValveCall::~ValveCall()
@@ -56,6 +60,7 @@ ValveCall::~ValveCall()
 	}
 	delete [] retbuf;
 	delete [] vparams;
+	delete [] batchOffsets;
 }
 
 unsigned char *ValveCall::stk_get()
@@ -52,6 +52,10 @@ struct ValveCall
 	size_t stackEnd;							/**< End of the bintools stack */
 	unsigned char *retbuf;						/**< Return buffer */
 	SourceHook::CStack<unsigned char *> stk;	/**< Parameter stack */
+	unsigned int *batchOffsets;					/**< SDKCallBatch: cell offset of each parameter in a row */
+	unsigned int batchRowCells;					/**< SDKCallBatch: cells per parameter row */
+	unsigned int batchRetCells;					/**< SDKCallBatch: cells per return value */
+	bool batchSupported;						/**< SDKCallBatch: whether the call can be batched */
 
 	unsigned char *stk_get();
 	void stk_put(unsigned char *ptr);
@@ -84,6 +84,97 @@ inline void DecodePassMethod(ValveType vtype, SDKPassMethod method, PassType &ty
 	}
 }
 
+/* Number of plugin cells a value takes in an SDKCallBatch row or result,
+ * or 0 if the type can't be batched.
+ */
+static unsigned int BatchCellsForType(ValveType vtype)
+{
+	switch (vtype)
+	{
+	case Valve_Vector:
+	case Valve_QAngle:
+		return 3;
+	case Valve_CBaseEntity:
+	case Valve_CBasePlayer:
+	case Valve_POD:
+	case Valve_Float:
+	case Valve_Edict:
+	case Valve_Bool:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* Works out where each parameter lives in an SDKCallBatch row, so the
+ * batch native only has to add offsets.
+ */
+static void ResolveBatchLayout(ValveCall *vc)
+{
+	if (vc->type != ValveCall_Entity && vc->type != ValveCall_Player)
+	{
+		return;
+	}
+
+	if (vc->retinfo)
+	{
+		vc->batchRetCells = BatchCellsForType(vc->retinfo->vtype);
+		if (!vc->batchRetCells)
+		{
+			return;
+		}
+	}
+
+	unsigned int callparams = vc->call->GetParamCount();
+	vc->batchOffsets = new unsigned int[callparams + 1];
+	vc->batchRowCells = 0;
+	for (unsigned int i=0; i<callparams; i++)
+	{
+		/* Rows are const, so there is nowhere to copy back to. */
+		unsigned int cells = BatchCellsForType(vc->vparams[i].vtype);
+		if (!cells || (vc->vparams[i].encflags & VENCODE_FLAG_COPYBACK))
+		{
+			return;
+		}
+		vc->batchOffsets[i] = vc->batchRowCells;
+		vc->batchRowCells += cells;
+	}
+
+	vc->batchSupported = true;
+}
+
+/* Converts a return value that fits in a single cell. */
+static cell_t DecodeCellReturn(ValveCall *vc)
+{
+	if (vc->retinfo->vtype == Valve_CBaseEntity
+		|| vc->retinfo->vtype == Valve_CBasePlayer)
+	{
+		CBaseEntity *pEntity = *(CBaseEntity **)(vc->retbuf);
+		return gamehelpers->EntityToBCompatRef(pEntity);
+	} else if (vc->retinfo->vtype == Valve_Edict) {
+		edict_t *pEdict = *(edict_t **)(vc->retbuf);
+		if (!pEdict || pEdict->IsFree())
+		{
+			return -1;
+		}
+		return IndexOfEdict(pEdict);
+	} else if (vc->retinfo->vtype == Valve_Bool) {
+		bool *addr = (bool  *)vc->retbuf;
+		if (vc->retinfo->flags & PASSFLAG_ASPOINTER)
+		{
+			addr = *(bool **)addr;
+		}
+		return *addr ? 1 : 0;
+	}
+
+	cell_t *addr = (cell_t *)vc->retbuf;
+	if (vc->retinfo->flags & PASSFLAG_ASPOINTER)
+	{
+		addr = *(cell_t **)addr;
+	}
+	return *addr;
+}
+
 static cell_t StartPrepSDKCall(IPluginContext *pContext, const cell_t *params)
 {
 	s_numparams = 0;
@@ -286,6 +377,8 @@ static cell_t EndPrepSDKCall(IPluginContext *pContext, const cell_t *params)
 		vc->thisinfo->decflags |= VDECODE_FLAG_BYREF;
 	}
 
+	ResolveBatchLayout(vc);
+
 	Handle_t hndl = handlesys->CreateHandle(g_CallHandle, vc, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 	if (!hndl)
 	{
@@ -517,36 +610,111 @@ static cell_t SDKCall(IPluginContext *pContext, const cell_t *params)
 			{
 				return 0;
 			}
-		} else if (vc->retinfo->vtype == Valve_CBaseEntity
-					|| vc->retinfo->vtype == Valve_CBasePlayer)
+		} else {
+			return DecodeCellReturn(vc);
+		}
+	}
+
+	return 0;
+}
+
+static cell_t SDKCallBatch(IPluginContext *pContext, const cell_t *params)
+{
+	ValveCall *vc;
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+
+	if ((err = handlesys->ReadHandle(params[1], g_CallHandle, &sec, (void **)&vc)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", params[1], err);
+	}
+
+	if (!vc->batchSupported)
+	{
+		return pContext->ThrowNativeError("SDK call cannot be batched; it must be an Entity or Player call without string, object or copyback values");
+	}
+
+	cell_t count = params[3];
+	bool shareArgs = params[8] != 0;
+	if (count < 0)
+	{
+		return pContext->ThrowNativeError("Invalid entity count %d", count);
+	}
+
+	cell_t needed = count * (cell_t)vc->batchRetCells;
+	if (params[5] < needed)
+	{
+		return pContext->ThrowNativeError("Results array is too small (%d < %d)", params[5], needed);
+	}
+
+	needed = (shareArgs ? 1 : count) * (cell_t)vc->batchRowCells;
+	if (vc->batchRowCells && params[7] < needed)
+	{
+		return pContext->ThrowNativeError("Argument array is too small (%d < %d)", params[7], needed);
+	}
+
+	cell_t *results;
+	pContext->LocalToPhysAddr(params[4], &results);
+
+	unsigned int callparams = vc->call->GetParamCount();
+	cell_t rowBytes = shareArgs ? 0 : (cell_t)(vc->batchRowCells * sizeof(cell_t));
+	unsigned char *ptr = vc->stk_get();
+
+	/* Everything is re-decoded for each call, since the callee is free to
+	 * modify the objects its arguments point at.
+	 */
+	for (cell_t i = 0; i < count; i++)
+	{
+		if (DecodeValveParam(pContext,
+			params[2] + i * sizeof(cell_t),
+			vc,
+			vc->thisinfo,
+			ptr) == Data_Fail)
+		{
+			vc->stk_put(ptr);
+			return i;
+		}
+
+		cell_t row = params[6] + i * rowBytes;
+		for (unsigned int j=0; j<callparams; j++)
 		{
-			CBaseEntity *pEntity = *(CBaseEntity **)(vc->retbuf);
-			return gamehelpers->EntityToBCompatRef(pEntity);
-		} else if (vc->retinfo->vtype == Valve_Edict) {
-			edict_t *pEdict = *(edict_t **)(vc->retbuf);
-			if (!pEdict || pEdict->IsFree())
+			if (DecodeValveParam(pContext,
+				row + vc->batchOffsets[j] * sizeof(cell_t),
+				vc,
+				&(vc->vparams[j]),
+				ptr) == Data_Fail)
 			{
-				return -1;
+				vc->stk_put(ptr);
+				return i;
 			}
-			return IndexOfEdict(pEdict);
-		} else if (vc->retinfo->vtype == Valve_Bool) {
-			bool *addr = (bool  *)vc->retbuf;
-			if (vc->retinfo->flags & PASSFLAG_ASPOINTER)
+		}
+
+		vc->call->Execute(ptr, vc->retbuf);
+
+		if (!vc->retinfo)
+		{
+			continue;
+		}
+
+		if (vc->batchRetCells == 3)
+		{
+			if (EncodeValveParam(pContext,
+				params[4] + i * 3 * sizeof(cell_t),
+				vc,
+				vc->retinfo,
+				vc->retbuf) == Data_Fail)
 			{
-				addr = *(bool **)addr;
+				vc->stk_put(ptr);
+				return i + 1;
 			}
-			return *addr ? 1 : 0;
 		} else {
-			cell_t *addr = (cell_t *)vc->retbuf;
-			if (vc->retinfo->flags & PASSFLAG_ASPOINTER)
-			{
-				addr = *(cell_t **)addr;
-			}
-			return *addr;
+			results[i] = DecodeCellReturn(vc);
 		}
 	}
 
-	return 0;
+	vc->stk_put(ptr);
+
+	return count;
 }
 
 sp_nativeinfo_t g_CallNatives[] = 
@@ -560,5 +728,6 @@ sp_nativeinfo_t g_CallNatives[] =
 	{"PrepSDKCall_AddParameter",	PrepSDKCall_AddParameter},
 	{"EndPrepSDKCall",				EndPrepSDKCall},
 	{"SDKCall",						SDKCall},
+	{"SDKCallBatch",				SDKCallBatch},
 	{NULL,							NULL},
 };
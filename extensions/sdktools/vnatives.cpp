@@ -37,6 +37,7 @@
 #include "vhelpers.h"
 #include "vglobals.h"
 #include "CellRecipientFilter.h"
+#include "classnameindex.h"
 #include <inetchannel.h>
 #include <iclient.h>
 #include "iserver.h"
@@ -1040,6 +1041,62 @@ static cell_t FindEntityByClassname(IPluginContext *pContext, const cell_t *para
 	return gamehelpers->EntityToBCompatRef(pEntity);
 }
 
+static cell_t FindEntitiesByClassname(IPluginContext *pContext, const cell_t *params)
+{
+	char *searchname;
+	pContext->LocalToString(params[1], &searchname);
+
+	cell_t *entities;
+	pContext->LocalToPhysAddr(params[2], &entities);
+
+	static std::vector<cell_t> found;
+	found.clear();
+
+	if (g_ClassnameIndex.IsAvailable())
+	{
+		g_ClassnameIndex.Find(searchname, found);
+	}
+	else
+	{
+#if SOURCE_ENGINE >= SE_ORANGEBOX
+		/* No SDKHooks, so no index; walk the entity list instead. */
+		size_t len = strlen(searchname);
+		bool prefix = (len > 0 && searchname[len - 1] == '*');
+		if (prefix)
+		{
+			len--;
+		}
+
+		CBaseEntity *pEntity = (CBaseEntity *)servertools->FirstEntity();
+		while (pEntity)
+		{
+			const char *classname = gamehelpers->GetEntityClassname(pEntity);
+			if (classname && classname[0] != '\0'
+				&& (prefix ? strncasecmp(searchname, classname, len) == 0 : strcasecmp(searchname, classname) == 0))
+			{
+				found.push_back(gamehelpers->EntityToBCompatRef(pEntity));
+			}
+			pEntity = (CBaseEntity *)servertools->NextEntity(pEntity);
+		}
+#else
+		return pContext->ThrowNativeError("FindEntitiesByClassname requires SDKHooks on this game");
+#endif
+	}
+
+	size_t count = found.size();
+	if (params[3] < 0 || count > (size_t)params[3])
+	{
+		count = params[3] > 0 ? (size_t)params[3] : 0;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		entities[i] = found[i];
+	}
+
+	return (cell_t)count;
+}
+
 #if SOURCE_ENGINE >= SE_ORANGEBOX
 static cell_t CreateEntityByName(IPluginContext *pContext, const cell_t *params)
 {
@@ -1148,7 +1205,14 @@ static cell_t DispatchKeyValue(IPluginContext *pContext, const cell_t *params)
 	pContext->LocalToString(params[2], &key);
 	pContext->LocalToString(params[3], &value);
 
-	return (servertools->SetKeyValue(pEntity, key, value) ? 1 : 0);
+	bool ret = servertools->SetKeyValue(pEntity, key, value);
+
+	if (ret && g_ClassnameIndex.IsAvailable() && strcasecmp(key, "classname") == 0)
+	{
+		g_ClassnameIndex.Refile(pEntity);
+	}
+
+	return ret ? 1 : 0;
 }
 #else
 static cell_t DispatchKeyValue(IPluginContext *pContext, const cell_t *params)
@@ -1816,6 +1880,7 @@ sp_nativeinfo_t g_Natives[] =
 	{"GetClientEyePosition",	GetClientEyePosition},
 	{"GetClientEyeAngles",		GetClientEyeAngles},
 	{"FindEntityByClassname",	FindEntityByClassname},
+	{"FindEntitiesByClassname",	FindEntitiesByClassname},
 	{"CreateEntityByName",		CreateEntityByName},
 	{"DispatchSpawn",			DispatchSpawn},
 	{"DispatchKeyValue",		DispatchKeyValue},
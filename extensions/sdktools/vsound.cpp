@@ -67,6 +67,102 @@ cell_t SoundReferenceToIndex(cell_t ref)
 	return gamehelpers->ReferenceToIndex(ref);
 }
 
+/* Leading characters that select how the engine plays a sample (streamed,
+ * dry mix, spatialized...). A filter that doesn't start with one ignores
+ * them, so a filter on "weapons/" samples also matches ")weapons/...".
+ */
+static inline bool IsSoundChar(char c)
+{
+	return c != '\0' && strchr("*#@><^)}$!?&~", c) != NULL;
+}
+
+static inline char NormalizeSampleChar(char c)
+{
+	return (c == '\\') ? '/' : (char)tolower((unsigned char)c);
+}
+
+/* Pattern is already normalized; '*' matches any run of characters. */
+static bool SampleGlobMatch(const char *pattern, const char *sample)
+{
+	const char *star = NULL;
+	const char *resume = NULL;
+
+	while (*sample)
+	{
+		if (*pattern == '*')
+		{
+			star = pattern++;
+			resume = sample;
+		}
+		else if (*pattern && *pattern == NormalizeSampleChar(*sample))
+		{
+			pattern++;
+			sample++;
+		}
+		else if (star)
+		{
+			pattern = star + 1;
+			sample = ++resume;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (*pattern == '*')
+	{
+		pattern++;
+	}
+	return *pattern == '\0';
+}
+
+SoundHookFilter::SoundHookFilter()
+	: entity(SOUND_FILTER_ANY),
+	  channel(SOUND_FILTER_ANY),
+	  min_level(SOUND_FILTER_ANY),
+	  max_level(SOUND_FILTER_ANY)
+{
+}
+
+bool SoundHookFilter::Matches(const char *sample, int entity, int channel, int level) const
+{
+	if ((this->entity != SOUND_FILTER_ANY && this->entity != entity)
+		|| (this->channel != SOUND_FILTER_ANY && this->channel != channel)
+		|| (min_level != SOUND_FILTER_ANY && level < min_level)
+		|| (max_level != SOUND_FILTER_ANY && level > max_level))
+	{
+		return false;
+	}
+
+	if (this->sample.empty())
+	{
+		return true;
+	}
+
+	if (!IsSoundChar(this->sample[0]))
+	{
+		while (IsSoundChar(*sample))
+		{
+			sample++;
+		}
+	}
+
+	return SampleGlobMatch(this->sample.c_str(), sample);
+}
+
+bool SoundHooks::_ShouldDispatch(const SoundHook &hook, const char *sample, int entity, int channel, int level)
+{
+	if (hook.filtered && !hook.filter.Matches(sample, entity, channel, level))
+	{
+		m_Skipped++;
+		return false;
+	}
+
+	m_Dispatched++;
+	return true;
+}
+
 size_t SoundHooks::_FillInPlayers(int *pl_array, IRecipientFilter *pFilter)
 {
 	size_t size = static_cast<size_t>(pFilter->GetRecipientCount());
@@ -145,7 +241,7 @@ void SoundHooks::OnPluginUnloaded(IPlugin *plugin)
 	{
 		for (iter=m_AmbientFuncs.begin(); iter!=m_AmbientFuncs.end(); )
 		{
-			if ((*iter)->GetParentContext() == pContext)
+			if ((*iter).pFunc->GetParentContext() == pContext)
 			{
 				iter = m_AmbientFuncs.erase(iter);
 				_DecRefCounter(AMBIENT_SOUND_HOOK);
@@ -160,7 +256,7 @@ void SoundHooks::OnPluginUnloaded(IPlugin *plugin)
 	{
 		for (iter=m_NormalFuncs.begin(); iter!=m_NormalFuncs.end(); )
 		{
-			if ((*iter)->GetParentContext() == pContext)
+			if ((*iter).pFunc->GetParentContext() == pContext)
 			{
 				iter = m_NormalFuncs.erase(iter);
 				_DecRefCounter(NORMAL_SOUND_HOOK);
@@ -173,48 +269,52 @@ void SoundHooks::OnPluginUnloaded(IPlugin *plugin)
 	}
 }
 
-void SoundHooks::AddHook(int type, IPluginFunction *pFunc)
+void SoundHooks::AddHook(int type, IPluginFunction *pFunc, const SoundHookFilter *filter)
 {
+	SoundHook hook;
+	hook.pFunc = pFunc;
+	hook.filtered = (filter != NULL);
+	if (filter)
+	{
+		hook.filter = *filter;
+	}
+
 	if (type == NORMAL_SOUND_HOOK)
 	{
-		m_NormalFuncs.push_back(pFunc);
+		m_NormalFuncs.push_back(hook);
 		_IncRefCounter(NORMAL_SOUND_HOOK);
 	}
 	else if (type == AMBIENT_SOUND_HOOK)
 	{
-		m_AmbientFuncs.push_back(pFunc);
+		m_AmbientFuncs.push_back(hook);
 		_IncRefCounter(AMBIENT_SOUND_HOOK);
 	}
 }
 
 bool SoundHooks::RemoveHook(int type, IPluginFunction *pFunc)
 {
-	SoundHookIter iter;
+	SourceHook::List<SoundHook> *list;
 	if (type == NORMAL_SOUND_HOOK)
 	{
-		if ((iter=m_NormalFuncs.find(pFunc)) != m_NormalFuncs.end())
-		{
-			m_NormalFuncs.erase(iter);
-			_DecRefCounter(NORMAL_SOUND_HOOK);
-			return true;
-		}
-		else
-		{
-			return false;
-		}
+		list = &m_NormalFuncs;
 	}
 	else if (type == AMBIENT_SOUND_HOOK)
 	{
-		if ((iter=m_AmbientFuncs.find(pFunc)) != m_AmbientFuncs.end())
+		list = &m_AmbientFuncs;
+	}
+	else
+	{
+		return false;
+	}
+
+	for (SoundHookIter iter=list->begin(); iter!=list->end(); iter++)
+	{
+		if ((*iter).pFunc == pFunc)
 		{
-			m_AmbientFuncs.erase(iter);
-			_DecRefCounter(AMBIENT_SOUND_HOOK);
+			list->erase(iter);
+			_DecRefCounter(type);
 			return true;
 		}
-		else
-		{
-			return false;
-		}
 	}
 
 	return false;
@@ -232,7 +332,12 @@ void SoundHooks::OnEmitAmbientSound(int entindex, const Vector &pos, const char
 
 	for (iter=m_AmbientFuncs.begin(); iter!=m_AmbientFuncs.end(); iter++)
 	{
-		pFunc = (*iter);
+		if (!_ShouldDispatch(*iter, buffer, entindex, SOUND_FILTER_ANY, soundlevel))
+		{
+			continue;
+		}
+
+		pFunc = (*iter).pFunc;
 		pFunc->PushStringEx(buffer, sizeof(buffer), SM_PARAM_STRING_COPY, SM_PARAM_COPYBACK);
 		pFunc->PushCellByRef(&entindex);
 		pFunc->PushFloatByRef(&vol);
@@ -356,9 +461,14 @@ void SoundHooks::OnEmitSound(IRecipientFilter &filter, int iEntIndex, int iChann
 
 	for (iter=m_NormalFuncs.begin(); iter!=m_NormalFuncs.end(); iter++)
 	{
+		if (!_ShouldDispatch(*iter, buffer, iEntIndex, iChannel, iSoundlevel))
+		{
+			continue;
+		}
+
 		int players[SM_MAXPLAYERS], size;
 		size = _FillInPlayers(players, &filter);
-		pFunc = (*iter);
+		pFunc = (*iter).pFunc;
 
 		pFunc->PushArray(players, SM_ARRAYSIZE(players), SM_PARAM_COPYBACK);
 		pFunc->PushCellByRef(&size);
@@ -520,9 +630,14 @@ void SoundHooks::OnEmitSound2(IRecipientFilter &filter, int iEntIndex, int iChan
 
 	for (iter=m_NormalFuncs.begin(); iter!=m_NormalFuncs.end(); iter++)
 	{
+		if (!_ShouldDispatch(*iter, buffer, iEntIndex, iChannel, sndlevel))
+		{
+			continue;
+		}
+
 		int players[SM_MAXPLAYERS], size;
 		size = _FillInPlayers(players, &filter);
-		pFunc = (*iter);
+		pFunc = (*iter).pFunc;
 
 		pFunc->PushArray(players, SM_ARRAYSIZE(players), SM_PARAM_COPYBACK);
 		pFunc->PushCellByRef(&size);
@@ -1548,6 +1663,55 @@ static cell_t smn_AddNormalSoundHook(IPluginContext *pContext, const cell_t *par
 	return 1;
 }
 
+static void ReadSoundHookFilter(IPluginContext *pContext, cell_t sample, SoundHookFilter *filter)
+{
+	char *pattern;
+	pContext->LocalToString(sample, &pattern);
+	for (; *pattern; pattern++)
+	{
+		filter->sample.push_back(NormalizeSampleChar(*pattern));
+	}
+}
+
+static cell_t smn_AddAmbientSoundHookEx(IPluginContext *pContext, const cell_t *params)
+{
+	IPluginFunction *pFunc = pContext->GetFunctionById(params[1]);
+	if (!pFunc)
+	{
+		return pContext->ThrowNativeError("Invalid function id (%X)", params[1]);
+	}
+
+	SoundHookFilter filter;
+	ReadSoundHookFilter(pContext, params[2], &filter);
+	filter.entity = params[3];
+	filter.min_level = params[4];
+	filter.max_level = params[5];
+
+	s_SoundHooks.AddHook(AMBIENT_SOUND_HOOK, pFunc, &filter);
+
+	return 1;
+}
+
+static cell_t smn_AddNormalSoundHookEx(IPluginContext *pContext, const cell_t *params)
+{
+	IPluginFunction *pFunc = pContext->GetFunctionById(params[1]);
+	if (!pFunc)
+	{
+		return pContext->ThrowNativeError("Invalid function id (%X)", params[1]);
+	}
+
+	SoundHookFilter filter;
+	ReadSoundHookFilter(pContext, params[2], &filter);
+	filter.channel = params[3];
+	filter.entity = params[4];
+	filter.min_level = params[5];
+	filter.max_level = params[6];
+
+	s_SoundHooks.AddHook(NORMAL_SOUND_HOOK, pFunc, &filter);
+
+	return 1;
+}
+
 static cell_t smn_RemoveAmbientSoundHook(IPluginContext *pContext, const cell_t *params)
 {
 	IPluginFunction *pFunc = pContext->GetFunctionById(params[1]);
@@ -1580,6 +1744,20 @@ static cell_t smn_RemoveNormalSoundHook(IPluginContext *pContext, const cell_t *
 	return 1;
 }
 
+static cell_t smn_GetSoundHookStats(IPluginContext *pContext, const cell_t *params)
+{
+	uint64_t dispatched, skipped;
+	s_SoundHooks.GetStats(&dispatched, &skipped);
+
+	cell_t *addr;
+	pContext->LocalToPhysAddr(params[1], &addr);
+	*addr = (cell_t)dispatched;
+	pContext->LocalToPhysAddr(params[2], &addr);
+	*addr = (cell_t)skipped;
+
+	return 1;
+}
+
 static cell_t smn_GetDistGainFromSoundLevel(IPluginContext *pContext, const cell_t *params)
 {
 	int decibel = params[1];
@@ -1644,6 +1822,9 @@ sp_nativeinfo_t g_SoundNatives[] =
 	{"AddNormalSoundHook",		smn_AddNormalSoundHook},
 	{"RemoveAmbientSoundHook",	smn_RemoveAmbientSoundHook},
 	{"RemoveNormalSoundHook",	smn_RemoveNormalSoundHook},
+	{"AddAmbientSoundHookEx",	smn_AddAmbientSoundHookEx},
+	{"AddNormalSoundHookEx",	smn_AddNormalSoundHookEx},
+	{"GetSoundHookStats",		smn_GetSoundHookStats},
 	{"GetDistGainFromSoundLevel", smn_GetDistGainFromSoundLevel},
 	{"GetGameSoundParams",		smn_GetGameSoundParams},
 	{"PrecacheScriptSound", smn_PrecacheScriptSound},
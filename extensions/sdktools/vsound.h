@@ -33,13 +33,40 @@
 #define _INCLUDE_SOURCEMOD_VSOUND_H_
 
 #include <sh_list.h>
+#include <string>
 #include "extension.h"
 #include "CellRecipientFilter.h"
 
 #define NORMAL_SOUND_HOOK		0
 #define AMBIENT_SOUND_HOOK		1
 
-typedef SourceHook::List<IPluginFunction *>::iterator SoundHookIter;
+/* Filter field value that matches anything (cellmin in SourcePawn) */
+#define SOUND_FILTER_ANY		(-2147483647 - 1)
+
+/**
+ * Declarative sound hook filter. Checked before a plugin is entered, so hooks
+ * that only care about a few samples don't pay for every sound on the server.
+ */
+struct SoundHookFilter
+{
+	SoundHookFilter();
+	bool Matches(const char *sample, int entity, int channel, int level) const;
+
+	std::string sample;		/* lowercased glob, empty for any */
+	int entity;
+	int channel;
+	int min_level;
+	int max_level;
+};
+
+struct SoundHook
+{
+	IPluginFunction *pFunc;
+	bool filtered;
+	SoundHookFilter filter;
+};
+
+typedef SourceHook::List<SoundHook>::iterator SoundHookIter;
 
 class SoundHooks : public IPluginsListener
 {
@@ -48,8 +75,13 @@ public: //IPluginsListener
 public:
 	void Initialize();
 	void Shutdown();
-	void AddHook(int type, IPluginFunction *pFunc);
+	void AddHook(int type, IPluginFunction *pFunc, const SoundHookFilter *filter = NULL);
 	bool RemoveHook(int type, IPluginFunction *pFunc);
+	void GetStats(uint64_t *dispatched, uint64_t *skipped) const
+	{
+		*dispatched = m_Dispatched;
+		*skipped = m_Skipped;
+	}
 
 	void OnEmitAmbientSound(int entindex, const Vector &pos, const char *samp, float vol, soundlevel_t soundlevel, int fFlags, int pitch, float delay);
 
@@ -98,11 +130,14 @@ private:
 	size_t _FillInPlayers(int *pl_array, IRecipientFilter *pFilter);
 	void _IncRefCounter(int type);
 	void _DecRefCounter(int type);
+	bool _ShouldDispatch(const SoundHook &hook, const char *sample, int entity, int channel, int level);
 private:
-	SourceHook::List<IPluginFunction *> m_AmbientFuncs;
-	SourceHook::List<IPluginFunction *> m_NormalFuncs;
+	SourceHook::List<SoundHook> m_AmbientFuncs;
+	SourceHook::List<SoundHook> m_NormalFuncs;
 	size_t m_NormalCount;
 	size_t m_AmbientCount;
+	uint64_t m_Dispatched;
+	uint64_t m_Skipped;
 };
 
 extern SoundHooks s_SoundHooks;
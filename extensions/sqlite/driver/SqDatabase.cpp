@@ -33,8 +33,12 @@
 #include "SqDatabase.h"
 #include "SqQuery.h"
 
-SqDatabase::SqDatabase(sqlite3 *sq3, bool persistent) : 
-	m_sq3(sq3), m_Persistent(persistent)
+/* Longer queries almost always have values formatted into them, so they are
+ * unlikely to ever be run again verbatim. */
+static const size_t kMaxCachedQueryLength = 2048;
+
+SqDatabase::SqDatabase(sqlite3 *sq3, bool persistent, size_t stmtCacheSize) : 
+	m_sq3(sq3), m_Persistent(persistent), m_StmtCacheSize(stmtCacheSize)
 {
 	// DBI, for historical reasons, guarantees an initial refcount of 1.
 	AddRef();
@@ -44,6 +48,7 @@ SqDatabase::~SqDatabase()
 {
 	if (m_Persistent)
 		g_SqDriver.RemovePersistent(this);
+	ClearStatementCache();
 	sqlite3_close(m_sq3);
 }
 
@@ -178,9 +183,24 @@ IPreparedQuery *SqDatabase::PrepareQuery(const char *query,
 										 char *error, 
 										 size_t maxlength, 
 										 int *errCode/* =NULL */)
+{
+	return Prepare(query, -1, error, maxlength);
+}
+
+IPreparedQuery *SqDatabase::PrepareQueryEx(const char *query, 
+										   size_t len, 
+										   char *error, 
+										   size_t maxlength, 
+										   int *errCode/* =NULL */)
+{
+	return Prepare(query, static_cast<int>(len), error, maxlength);
+}
+
+IPreparedQuery *SqDatabase::Prepare(const char *query, int len, char *error, size_t maxlength)
 {
 	sqlite3_stmt *stmt = NULL;
-	if ((m_LastErrorCode = sqlite3_prepare_v2(m_sq3, query, -1, &stmt, NULL)) != SQLITE_OK
+	std::string key;
+	if ((m_LastErrorCode = AcquireStatement(query, len, &stmt, key)) != SQLITE_OK
 		|| !stmt)
 	{
 		const char *msg;
@@ -198,35 +218,85 @@ IPreparedQuery *SqDatabase::PrepareQuery(const char *query,
 		m_LastError.assign(msg);
 		return NULL;
 	}
-	return new SqQuery(this, stmt);
+	return new SqQuery(this, stmt, key);
 }
 
-IPreparedQuery *SqDatabase::PrepareQueryEx(const char *query, 
-										   size_t len, 
-										   char *error, 
-										   size_t maxlength, 
-										   int *errCode/* =NULL */)
+int SqDatabase::AcquireStatement(const char *query, int len, sqlite3_stmt **stmt, std::string &key)
 {
-	sqlite3_stmt *stmt = NULL;
-	if ((m_LastErrorCode = sqlite3_prepare_v2(m_sq3, query, len, &stmt, NULL)) != SQLITE_OK
-		|| !stmt)
+	size_t length = (len < 0) ? strlen(query) : static_cast<size_t>(len);
+	if (m_StmtCacheSize && length <= kMaxCachedQueryLength)
 	{
-		const char *msg;
-		if (m_LastErrorCode != SQLITE_OK)
+		key.assign(query, length);
+
+		std::lock_guard<std::mutex> lock(m_StmtLock);
+		auto iter = m_StmtIndex.find(key);
+		if (iter != m_StmtIndex.end())
 		{
-			msg = sqlite3_errmsg(m_sq3);
-		} else {
-			msg = "Invalid query string";
-			m_LastErrorCode = SQLITE_ERROR;
+			*stmt = iter->second->stmt;
+			m_StmtCache.erase(iter->second);
+			m_StmtIndex.erase(iter);
+			g_SqDriver.GetStats().stmtCacheHits++;
+			return SQLITE_OK;
 		}
-		if (error)
+		g_SqDriver.GetStats().stmtCacheMisses++;
+	}
+
+	return sqlite3_prepare_v2(m_sq3, query, len, stmt, NULL);
+}
+
+void SqDatabase::ReleaseStatement(sqlite3_stmt *stmt, std::string &key)
+{
+	if (key.empty())
+	{
+		sqlite3_finalize(stmt);
+		return;
+	}
+
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+
+	sqlite3_stmt *evicted = NULL;
+	{
+		std::lock_guard<std::mutex> lock(m_StmtLock);
+
+		/* Two queries with the same text were alive at once; keep one. */
+		if (m_StmtIndex.find(key) != m_StmtIndex.end())
 		{
-			strncopy(error, msg, maxlength);
+			evicted = stmt;
 		}
-		m_LastError.assign(msg);
-		return NULL;
+		else
+		{
+			if (m_StmtCache.size() >= m_StmtCacheSize)
+			{
+				evicted = m_StmtCache.back().stmt;
+				m_StmtIndex.erase(m_StmtCache.back().sql);
+				m_StmtCache.pop_back();
+				g_SqDriver.GetStats().stmtCacheEvictions++;
+			}
+
+			CachedStmt entry;
+			entry.sql.swap(key);
+			entry.stmt = stmt;
+			m_StmtCache.push_front(std::move(entry));
+			m_StmtIndex[m_StmtCache.front().sql] = m_StmtCache.begin();
+		}
+	}
+
+	if (evicted)
+	{
+		sqlite3_finalize(evicted);
+	}
+}
+
+void SqDatabase::ClearStatementCache()
+{
+	std::lock_guard<std::mutex> lock(m_StmtLock);
+	for (auto iter = m_StmtCache.begin(); iter != m_StmtCache.end(); iter++)
+	{
+		sqlite3_finalize(iter->stmt);
 	}
-	return new SqQuery(this, stmt);
+	m_StmtCache.clear();
+	m_StmtIndex.clear();
 }
 
 sqlite3 *SqDatabase::GetDb()
@@ -33,7 +33,10 @@
 #define _INCLUDE_SQLITE_SOURCEMOD_DATABASE_H_
 
 #include <am-refcounting-threadsafe.h>
+#include <list>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include "SqDriver.h"
 
 class SqDatabase
@@ -41,7 +44,7 @@ class SqDatabase
 	  public ke::RefcountedThreadsafe<SqDatabase>
 {
 public:
-	SqDatabase(sqlite3 *sq3, bool persistent);
+	SqDatabase(sqlite3 *sq3, bool persistent, size_t stmtCacheSize);
 	~SqDatabase();
 public:
 	bool Close();
@@ -68,12 +71,42 @@ public:
 	{
 		m_Persistent = false;
 	}
+
+	/**
+	 * Takes a compiled statement for the given SQL out of the statement
+	 * cache, or compiles a new one. key receives the cache key to hand back
+	 * to ReleaseStatement(), or is left empty if the statement must not be
+	 * cached.
+	 */
+	int AcquireStatement(const char *query, int len, sqlite3_stmt **stmt, std::string &key);
+
+	/**
+	 * Resets a statement and puts it back at the front of the cache, evicting
+	 * the least recently used one if the cache is full.
+	 */
+	void ReleaseStatement(sqlite3_stmt *stmt, std::string &key);
+private:
+	IPreparedQuery *Prepare(const char *query, int len, char *error, size_t maxlength);
+	void ClearStatementCache();
 private:
+	struct CachedStmt
+	{
+		std::string sql;
+		sqlite3_stmt *stmt;
+	};
+	typedef std::list<CachedStmt> StmtList;
 	sqlite3 *m_sq3;
 	std::recursive_mutex m_FullLock;
 	bool m_Persistent;
 	String m_LastError;
 	int m_LastErrorCode;
+
+	/* Most recently used first. Statements that are checked out by a query
+	 * are not in the cache. */
+	std::mutex m_StmtLock;
+	StmtList m_StmtCache;
+	std::unordered_map<std::string, StmtList::iterator> m_StmtIndex;
+	size_t m_StmtCacheSize;
 };
 
 #endif //_INCLUDE_SQLITE_SOURCEMOD_DATABASE_H_
@@ -54,8 +54,13 @@ unsigned int strncopy(char *dest, const char *src, size_t count)
 	return (dest - start);
 }
 
+/* Statements kept per connection unless databases.cfg says otherwise. */
+static const size_t kDefaultStatementCacheSize = 16;
+
 int busy_handler(void *unused1, int unused2)
 {
+	g_SqDriver.GetStats().busyWaits++;
+
 #if defined PLATFORM_WINDOWS
 	Sleep(100);
 #elif defined PLATFORM_POSIX
@@ -281,7 +286,14 @@ IDatabase *SqDriver::Connect(const DatabaseInfo *info, bool persistent, char *er
 
 	sqlite3_busy_handler(sql, busy_handler, NULL);
 
-	SqDatabase *pdb = new SqDatabase(sql, persistent);
+	size_t stmtCacheSize = kDefaultStatementCacheSize;
+	if (!ApplyOptions(sql, info, &stmtCacheSize, error, maxlength))
+	{
+		sqlite3_close(sql);
+		return NULL;
+	}
+
+	SqDatabase *pdb = new SqDatabase(sql, persistent, stmtCacheSize);
 
 	if (persistent)
 	{
@@ -294,6 +306,108 @@ IDatabase *SqDriver::Connect(const DatabaseInfo *info, bool persistent, char *er
 	return pdb;
 }
 
+static bool ParseInteger(const char *value, bool allowNegative, long long *out)
+{
+	char *end;
+	long long num = strtoll(value, &end, 10);
+	if (end == value || *end != '\0' || (!allowNegative && num < 0))
+	{
+		return false;
+	}
+	*out = num;
+	return true;
+}
+
+static bool IsOneOf(const char *value, const char *const *list)
+{
+	for (; *list != NULL; list++)
+	{
+		if (strcasecmp(value, *list) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Applies the SQLite specific keys from databases.cfg. Values are checked
+ * before being pasted into a PRAGMA, since PRAGMA arguments can't be bound.
+ */
+bool SqDriver::ApplyOptions(sqlite3 *sql, const DatabaseInfo *info, size_t *stmtCacheSize, char *error, size_t maxlength)
+{
+	static const char *const kJournalModes[] = {"delete", "truncate", "persist", "memory", "wal", "off", NULL};
+	static const char *const kSyncModes[] = {"off", "normal", "full", "extra", NULL};
+
+	char pragmas[512];
+	size_t len = 0;
+	long long num;
+	const char *value;
+
+	pragmas[0] = '\0';
+
+	if ((value = info->GetOption("journal_mode")) != NULL)
+	{
+		if (!IsOneOf(value, kJournalModes))
+		{
+			ke::SafeSprintf(error, maxlength, "Invalid journal_mode \"%s\"", value);
+			return false;
+		}
+		len += ke::SafeSprintf(&pragmas[len], sizeof(pragmas) - len, "PRAGMA journal_mode=%s;", value);
+	}
+	if ((value = info->GetOption("synchronous")) != NULL)
+	{
+		if (!IsOneOf(value, kSyncModes))
+		{
+			ke::SafeSprintf(error, maxlength, "Invalid synchronous mode \"%s\"", value);
+			return false;
+		}
+		len += ke::SafeSprintf(&pragmas[len], sizeof(pragmas) - len, "PRAGMA synchronous=%s;", value);
+	}
+	if ((value = info->GetOption("mmap_size")) != NULL)
+	{
+		if (!ParseInteger(value, false, &num))
+		{
+			ke::SafeSprintf(error, maxlength, "Invalid mmap_size \"%s\"", value);
+			return false;
+		}
+		len += ke::SafeSprintf(&pragmas[len], sizeof(pragmas) - len, "PRAGMA mmap_size=%lld;", num);
+	}
+	if ((value = info->GetOption("cache_size")) != NULL)
+	{
+		/* Negative values are a size in KiB, positive ones a page count. */
+		if (!ParseInteger(value, true, &num))
+		{
+			ke::SafeSprintf(error, maxlength, "Invalid cache_size \"%s\"", value);
+			return false;
+		}
+		len += ke::SafeSprintf(&pragmas[len], sizeof(pragmas) - len, "PRAGMA cache_size=%lld;", num);
+	}
+	if ((value = info->GetOption("statement_cache")) != NULL)
+	{
+		if (!ParseInteger(value, false, &num))
+		{
+			ke::SafeSprintf(error, maxlength, "Invalid statement_cache \"%s\"", value);
+			return false;
+		}
+		*stmtCacheSize = (size_t)num;
+	}
+
+	if (len == 0)
+	{
+		return true;
+	}
+
+	char *errmsg = NULL;
+	if (sqlite3_exec(sql, pragmas, NULL, NULL, &errmsg) != SQLITE_OK)
+	{
+		strncopy(error, errmsg ? errmsg : sqlite3_errmsg(sql), maxlength);
+		sqlite3_free(errmsg);
+		return false;
+	}
+
+	return true;
+}
+
 void SqDriver::RemovePersistent(IDatabase *pdb)
 {
 	std::lock_guard<std::mutex> lock(m_OpenLock);
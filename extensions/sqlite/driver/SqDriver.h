@@ -36,6 +36,7 @@
 #include <IDBDriver.h>
 #include <sh_list.h>
 #include <sh_string.h>
+#include <atomic>
 #include <mutex>
 #include "sqlite-source/sqlite3.h"
 
@@ -48,6 +49,20 @@ struct SqDbInfo
 	IDatabase *db;
 };
 
+/**
+ * Driver-wide counters, updated from any thread that uses a connection.
+ */
+struct SqDriverStats
+{
+	SqDriverStats() : busyWaits(0), stmtCacheHits(0), stmtCacheMisses(0), stmtCacheEvictions(0)
+	{
+	}
+	std::atomic<unsigned int> busyWaits;
+	std::atomic<unsigned int> stmtCacheHits;
+	std::atomic<unsigned int> stmtCacheMisses;
+	std::atomic<unsigned int> stmtCacheEvictions;
+};
+
 /**
  * Tee-hee.. sounds like "screw driver," except maybe if
  * Elmer Fudd was saying it.
@@ -70,12 +85,19 @@ public:
 	void ShutdownThreadSafety();
 public:
 	void RemovePersistent(IDatabase *pdb);
+	SqDriverStats &GetStats()
+	{
+		return m_Stats;
+	}
+private:
+	bool ApplyOptions(sqlite3 *sql, const DatabaseInfo *info, size_t *stmtCacheSize, char *error, size_t maxlength);
 private:
 	Handle_t m_Handle;
 	std::mutex m_OpenLock;
 	List<SqDbInfo> m_Cache;
 	bool m_bThreadSafe;
 	bool m_bShutdown;
+	SqDriverStats m_Stats;
 };
 
 extern SqDriver g_SqDriver;
@@ -31,9 +31,10 @@
 
 #include "SqQuery.h"
 
-SqQuery::SqQuery(SqDatabase *parent, sqlite3_stmt *stmt) : 
+SqQuery::SqQuery(SqDatabase *parent, sqlite3_stmt *stmt, std::string &cacheKey) : 
  m_pParent(parent), m_pStmt(stmt), m_pResults(NULL), m_AffectedRows(0), m_InsertID(0)
 {
+	m_CacheKey.swap(cacheKey);
 	m_ParamCount = sqlite3_bind_parameter_count(m_pStmt);
 	m_ColCount = sqlite3_column_count(m_pStmt);
 }
@@ -41,7 +42,7 @@ SqQuery::SqQuery(SqDatabase *parent, sqlite3_stmt *stmt) :
 SqQuery::~SqQuery()
 {
 	delete m_pResults;
-	sqlite3_finalize(m_pStmt);
+	m_pParent->ReleaseStatement(m_pStmt, m_CacheKey);
 }
 
 IResultSet *SqQuery::GetResultSet()
@@ -40,7 +40,7 @@ class SqQuery :
 	public IPreparedQuery
 {
 public:
-	SqQuery(SqDatabase *parent, sqlite3_stmt *stmt);
+	SqQuery(SqDatabase *parent, sqlite3_stmt *stmt, std::string &cacheKey);
 	~SqQuery();
 public: //IQuery
 	IResultSet *GetResultSet();
@@ -84,6 +84,7 @@ public:
 private:
 	ke::RefPtr<SqDatabase> m_pParent;
 	sqlite3_stmt *m_pStmt;
+	std::string m_CacheKey;
 	SqResults *m_pResults;
 	unsigned int m_ParamCount;
 	String m_LastError;
@@ -46,16 +46,29 @@ bool SqliteExt::SDK_OnLoad(char *error, size_t maxlength, bool late)
 {
 	g_SqDriver.Initialize();
 	dbi->AddDriver(&g_SqDriver);
+	rootconsole->AddRootConsoleCommand3("sqlite", "SQLite driver statistics", this);
 
 	return true;
 }
 
 void SqliteExt::SDK_OnUnload()
 {
+	rootconsole->RemoveRootConsoleCommand("sqlite", this);
 	dbi->RemoveDriver(&g_SqDriver);
 	g_SqDriver.Shutdown();
 }
 
+void SqliteExt::OnRootConsoleCommand(const char *cmdname, const ICommandArgs *command)
+{
+	SqDriverStats &stats = g_SqDriver.GetStats();
+
+	rootconsole->ConsolePrint("[SM] SQLite %s:", sqlite3_libversion());
+	rootconsole->ConsolePrint("  Busy waits:                 %u", stats.busyWaits.load());
+	rootconsole->ConsolePrint("  Statement cache hits:       %u", stats.stmtCacheHits.load());
+	rootconsole->ConsolePrint("  Statement cache misses:     %u", stats.stmtCacheMisses.load());
+	rootconsole->ConsolePrint("  Statement cache evictions:  %u", stats.stmtCacheEvictions.load());
+}
+
 size_t UTIL_Format(char *buffer, size_t maxlength, const char *fmt, ...)
 {
 	va_list ap;
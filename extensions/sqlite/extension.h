@@ -45,7 +45,9 @@
  * @brief Sample implementation of the SDK Extension.
  * Note: Uncomment one of the pre-defined virtual functions in order to use it.
  */
-class SqliteExt : public SDKExtension
+class SqliteExt :
+	public SDKExtension,
+	public IRootConsoleCommand
 {
 public:
 	/**
@@ -85,6 +87,8 @@ public:
 	 * @return			True if working, false otherwise.
 	 */
 	//virtual bool QueryRunning(char *error, size_t maxlength);
+public: //IRootConsoleCommand
+	void OnRootConsoleCommand(const char *cmdname, const ICommandArgs *command);
 public:
 #if defined SMEXT_CONF_METAMOD
 	/**
@@ -0,0 +1,248 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod Updater Extension
+ * Copyright (C) 2004-2009 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sm_platform.h>
+#include <atomic>
+#include <thread>
+#include "FileHashes.h"
+#include "md5.h"
+
+#define CACHE_HEADER		"// SourceMod updater checksum cache v1"
+
+/* Threads used to hash changed files. Reading is usually the bottleneck, so
+ * a handful is plenty even on large machines.
+ */
+static const unsigned int kMaxHashThreads = 4;
+
+void HashCache::Load(const char *path)
+{
+	FILE *fp = fopen(path, "r");
+	if (fp == NULL)
+	{
+		return;
+	}
+
+	char line[PLATFORM_MAX_PATH + 128];
+	if (fgets(line, sizeof(line), fp) == NULL ||
+		strncmp(line, CACHE_HEADER, sizeof(CACHE_HEADER) - 1) != 0)
+	{
+		/* Unknown format; start over. */
+		fclose(fp);
+		return;
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		char checksum[33];
+		unsigned long long size;
+		long long mtime;
+		int name;
+
+		if (sscanf(line, "%32s %llu %lld %n", checksum, &size, &mtime, &name) != 3 ||
+			strlen(checksum) != 32)
+		{
+			continue;
+		}
+
+		size_t len = strlen(line + name);
+		while (len && (line[name + len - 1] == '\n' || line[name + len - 1] == '\r'))
+		{
+			len--;
+		}
+		if (!len)
+		{
+			continue;
+		}
+
+		Entry &entry = m_Entries[std::string(line + name, len)];
+		entry.size = size;
+		entry.mtime = (time_t)mtime;
+		entry.live = false;
+		strcpy(entry.checksum, checksum);
+	}
+
+	fclose(fp);
+}
+
+bool HashCache::Save(const char *path)
+{
+	/* Write a new file and swap it in, so a crash never leaves a torn cache. */
+	std::string temp(path);
+	temp.append(".tmp");
+
+	FILE *fp = fopen(temp.c_str(), "w");
+	if (fp == NULL)
+	{
+		return false;
+	}
+
+	fprintf(fp, "%s\n", CACHE_HEADER);
+	for (auto iter = m_Entries.begin(); iter != m_Entries.end(); iter++)
+	{
+		const Entry &entry = iter->second;
+		if (!entry.live)
+		{
+			continue;
+		}
+		fprintf(fp, "%s %llu %lld %s\n",
+			entry.checksum,
+			(unsigned long long)entry.size,
+			(long long)entry.mtime,
+			iter->first.c_str());
+	}
+
+	bool ok = (fclose(fp) == 0);
+	if (ok)
+	{
+		remove(path);
+		ok = (rename(temp.c_str(), path) == 0);
+	}
+	if (!ok)
+	{
+		remove(temp.c_str());
+	}
+	return ok;
+}
+
+bool HashCache::Lookup(FileHash *file)
+{
+	auto iter = m_Entries.find(file->file);
+	if (iter == m_Entries.end())
+	{
+		return false;
+	}
+
+	Entry &entry = iter->second;
+	if (entry.size != file->size || entry.mtime != file->mtime)
+	{
+		return false;
+	}
+
+	entry.live = true;
+	strcpy(file->checksum, entry.checksum);
+	file->valid = true;
+	return true;
+}
+
+void HashCache::Store(const FileHash &file)
+{
+	Entry &entry = m_Entries[file.file];
+	entry.size = file.size;
+	entry.mtime = file.mtime;
+	entry.live = true;
+	strcpy(entry.checksum, file.checksum);
+}
+
+bool StatFile(const char *path, uint64_t *size, time_t *mtime)
+{
+#ifdef PLATFORM_WINDOWS
+	struct _stat64 s;
+	if (_stat64(path, &s) != 0)
+#elif defined PLATFORM_POSIX
+	struct stat s;
+	if (stat(path, &s) != 0)
+#endif
+	{
+		return false;
+	}
+
+	*size = (uint64_t)s.st_size;
+	*mtime = s.st_mtime;
+	return true;
+}
+
+bool HashFile(const char *path, char checksum[33])
+{
+	FILE *fp = fopen(path, "rb");
+	if (fp == NULL)
+	{
+		return false;
+	}
+
+	MD5 md5;
+	unsigned char buffer[64 * 1024];
+	size_t len;
+	while ((len = fread(buffer, 1, sizeof(buffer), fp)) != 0)
+	{
+		md5.update(buffer, (unsigned int)len);
+	}
+
+	bool ok = !ferror(fp);
+	fclose(fp);
+	if (!ok)
+	{
+		return false;
+	}
+
+	md5.finalize();
+	md5.hex_digest(checksum);
+	return true;
+}
+
+void HashFiles(const std::vector<FileHash *> &files)
+{
+	std::atomic<size_t> next(0);
+	auto worker = [&files, &next]() -> void {
+		size_t i;
+		while ((i = next++) < files.size())
+		{
+			FileHash *file = files[i];
+			file->valid = HashFile(file->path.c_str(), file->checksum);
+		}
+	};
+
+	unsigned int threads = std::thread::hardware_concurrency();
+	if (threads > kMaxHashThreads)
+	{
+		threads = kMaxHashThreads;
+	}
+	if (threads > files.size())
+	{
+		threads = (unsigned int)files.size();
+	}
+
+	/* This thread takes a share of the work too. */
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		pool.emplace_back(worker);
+	}
+	worker();
+	for (size_t i = 0; i < pool.size(); i++)
+	{
+		pool[i].join();
+	}
+}
@@ -0,0 +1,88 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod Updater Extension
+ * Copyright (C) 2004-2009 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#ifndef _INCLUDE_SOURCEMOD_UPDATER_FILEHASHES_H_
+#define _INCLUDE_SOURCEMOD_UPDATER_FILEHASHES_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A file whose checksum is reported to the update server.
+ */
+struct FileHash
+{
+	std::string file;		/* SourceMod-relative name sent to the server */
+	std::string path;		/* Full path on disk */
+	uint64_t size;
+	time_t mtime;
+	char checksum[33];
+	bool valid;				/* True once checksum has been filled in */
+};
+
+/**
+ * Remembers the checksum of every file by (name, size, mtime), so files that
+ * have not changed since the last run are never read again.
+ */
+class HashCache
+{
+public:
+	void Load(const char *path);
+	bool Save(const char *path);
+
+	/* Fills in the checksum if a matching entry exists. */
+	bool Lookup(FileHash *file);
+
+	void Store(const FileHash &file);
+private:
+	struct Entry
+	{
+		uint64_t size;
+		time_t mtime;
+		char checksum[33];
+		bool live;			/* Seen during this run; only live entries are saved */
+	};
+	std::unordered_map<std::string, Entry> m_Entries;
+};
+
+bool StatFile(const char *path, uint64_t *size, time_t *mtime);
+bool HashFile(const char *path, char checksum[33]);
+
+/* Hashes every file across a few threads. Files that cannot be read are left
+ * invalid.
+ */
+void HashFiles(const std::vector<FileHash *> &files);
+
+#endif /* _INCLUDE_SOURCEMOD_UPDATER_FILEHASHES_H_ */
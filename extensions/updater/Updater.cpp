@@ -30,8 +30,10 @@
  */
 
 #include <stdlib.h>
+#include <time.h>
 #include "extension.h"
 #include "Updater.h"
+#include "FileHashes.h"
 #include "md5.h"
 #include <sourcemod_version.h>
 
@@ -250,64 +252,25 @@ void UpdateReader::HandleFolder(const char *folder)
 	LinkPart(part);
 }
 
-static bool md5_file(const char *file, char checksum[33])
-{
-	MD5 md5;
-	FILE *fp;
-	long length;
-	void *fdata;
-
-	if ((fp = fopen(file, "rb")) == NULL)
-	{
-		return false;
-	}
-
-	fseek(fp, 0, SEEK_END);
-	length = ftell(fp);
-	fseek(fp, 0, SEEK_SET);
-	fdata = malloc(length);
-	if (fread(fdata, 1, length, fp) != size_t(length))
-	{
-		free(fdata);
-		fclose(fp);
-		return false;
-	}
-	fclose(fp);
-
-	md5.update((unsigned char*)fdata, length);
-	md5.finalize();
-	md5.hex_digest(checksum);
-
-	free(fdata);
-
-	return true;
-}
-
 /* Path should be sourcemod relative, not gamedata relative */
-static bool add_file(IWebForm *form, const char *file, unsigned int &num_files)
+static void add_file(std::vector<FileHash> &files, const char *file)
 {
+	FileHash hash;
 	char path[PLATFORM_MAX_PATH];
 
 	smutils->BuildPath(Path_SM, path, sizeof(path), "%s", file);
-
-	char checksum[33];
-	if (!md5_file(path, checksum))
+	if (!StatFile(path, &hash.size, &hash.mtime))
 	{
-		return false;
+		return;
 	}
 
-	char name[32];
-	smutils->Format(name, sizeof(name), "file_%d_name", num_files);
-	form->AddString(name, file);
-	smutils->Format(name, sizeof(name), "file_%d_md5", num_files);
-	form->AddString(name, checksum);
-
-	num_files++;
-
-	return true;
+	hash.file.assign(file);
+	hash.path.assign(path);
+	hash.valid = false;
+	files.push_back(hash);
 }
 
-static void add_folders(IWebForm *form, const char *root, unsigned int &num_files)
+static void add_folders(std::vector<FileHash> &files, const char *root)
 {
 	IDirectory *dir;
 	char path[PLATFORM_MAX_PATH];
@@ -332,11 +295,11 @@ static void add_folders(IWebForm *form, const char *root, unsigned int &num_file
 		smutils->Format(name, sizeof(name), "%s/%s", root, dir->GetEntryName());
 		if (dir->IsEntryDirectory())
 		{
-			add_folders(form, name, num_files);
+			add_folders(files, name);
 		}
 		else if (dir->IsEntryFile())
 		{
-			add_file(form, name, num_files);
+			add_file(files, name);
 		}
 		dir->NextEntry();
 	}
@@ -344,6 +307,41 @@ static void add_folders(IWebForm *form, const char *root, unsigned int &num_file
 	libsys->CloseDirectory(dir);
 }
 
+/* Fills in checksums from the cache where possible and hashes the rest. */
+static void hash_files(std::vector<FileHash> &files)
+{
+	char path[PLATFORM_MAX_PATH];
+	smutils->BuildPath(Path_SM, path, sizeof(path), "data/updater_checksums.txt");
+
+	HashCache cache;
+	cache.Load(path);
+
+	std::vector<FileHash *> changed;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (!cache.Lookup(&files[i]))
+		{
+			changed.push_back(&files[i]);
+		}
+	}
+
+	HashFiles(changed);
+
+	/* A file written during the same second as its timestamp can change
+	 * again without the timestamp moving, so only cache older files.
+	 */
+	time_t now = time(NULL);
+	for (size_t i = 0; i < changed.size(); i++)
+	{
+		if (changed[i]->valid && changed[i]->mtime < now - 1)
+		{
+			cache.Store(*changed[i]);
+		}
+	}
+
+	cache.Save(path);
+}
+
 void UpdateReader::PerformUpdate(const char *url)
 {
 	IWebForm *form;
@@ -358,8 +356,26 @@ void UpdateReader::PerformUpdate(const char *url)
 
 	form->AddString("version", SOURCEMOD_VERSION);
 
+	std::vector<FileHash> files;
+	add_folders(files, "gamedata");
+	hash_files(files);
+
 	unsigned int num_files = 0;
-	add_folders(form, "gamedata", num_files);
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (!files[i].valid)
+		{
+			continue;
+		}
+
+		char name[32];
+		smutils->Format(name, sizeof(name), "file_%d_name", num_files);
+		form->AddString(name, files[i].file.c_str());
+		smutils->Format(name, sizeof(name), "file_%d_md5", num_files);
+		form->AddString(name, files[i].checksum);
+
+		num_files++;
+	}
 
 	char temp[24];
 	smutils->Format(temp, sizeof(temp), "%d", num_files);
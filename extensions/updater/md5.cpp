@@ -356,9 +356,6 @@ void MD5::transform (uint1 block[64]){
   state[2] += c;
   state[3] += d;
 
-  // Zeroize sensitive information.
-  memset ( (uint1 *) x, 0, sizeof(x));
-
 }
 
 
@@ -384,35 +381,33 @@ void MD5::encode (uint1 *output, uint4 *input, uint4 len) {
 // a multiple of 4.
 void MD5::decode (uint4 *output, uint1 *input, uint4 len){
 
+#if defined(_M_IX86) || defined(_M_X64) || \
+    (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  // The byte order already matches, so copy whole words.
+  ::memcpy(output, input, len);
+#else
   unsigned int i, j;
 
   for (i = 0, j = 0; j < len; i++, j += 4)
     output[i] = ((uint4)input[j]) | (((uint4)input[j+1]) << 8) |
       (((uint4)input[j+2]) << 16) | (((uint4)input[j+3]) << 24);
+#endif
 }
 
 
 
 
 
-// Note: Replace "for loop" with standard memcpy if possible.
 void MD5::memcpy (uint1 *output, uint1 *input, uint4 len){
 
-  unsigned int i;
-
-  for (i = 0; i < len; i++)
-    output[i] = input[i];
+  ::memcpy(output, input, len);
 }
 
 
 
-// Note: Replace "for loop" with standard memset if possible.
 void MD5::memset (uint1 *output, uint1 value, uint4 len){
 
-  unsigned int i;
-
-  for (i = 0; i < len; i++)
-    output[i] = value;
+  ::memset(output, value, len);
 }
 
 
@@ -426,14 +421,15 @@ inline unsigned int MD5::rotate_left  (uint4 x, uint4 n){
 
 
 
-// F, G, H and I are basic MD5 functions.
+// F, G, H and I are basic MD5 functions. F and G are written as
+// selects, which need one fewer operation than the textbook forms.
 
 inline unsigned int MD5::F            (uint4 x, uint4 y, uint4 z){
-  return (x & y) | (~x & z);
+  return z ^ (x & (y ^ z));
 }
 
 inline unsigned int MD5::G            (uint4 x, uint4 y, uint4 z){
-  return (x & z) | (y & ~z);
+  return y ^ (z & (x ^ y));
 }
 
 inline unsigned int MD5::H            (uint4 x, uint4 y, uint4 z){
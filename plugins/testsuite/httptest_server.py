@@ -0,0 +1,40 @@
+# Local HTTP server for httptest.sp.
+#
+#   python3 httptest_server.py [port]
+#
+# then run "test_http http://127.0.0.1:<port>" on the server console.
+
+import http.server
+import socketserver
+import sys
+import time
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def reply(self, code, body):
+        self.send_response(code)
+        self.send_header('Content-Type', 'text/plain')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path == '/slow':
+            time.sleep(3)
+            return self.reply(200, b'slow')
+        if self.path.startswith('/status/'):
+            return self.reply(int(self.path[len('/status/'):]), b'status')
+        if self.path == '/header':
+            return self.reply(200, self.headers.get('X-Test', '').encode())
+        self.reply(200, b'hello')
+
+    def do_POST(self):
+        length = int(self.headers.get('Content-Length', 0))
+        self.reply(200, self.rfile.read(length))
+
+class Server(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+
+port = int(sys.argv[1]) if len(sys.argv) > 1 else 8080
+Server(('127.0.0.1', port), Handler).serve_forever()
@@ -42,7 +42,7 @@
  */
 
 #define SMINTERFACE_DBI_NAME		"IDBI"
-#define SMINTERFACE_DBI_VERSION		9
+#define SMINTERFACE_DBI_VERSION		10
 
 namespace SourceMod
 {
@@ -635,6 +635,7 @@ namespace SourceMod
 			dbiVersion = SMINTERFACE_DBI_VERSION;
 			port = 0;
 			maxTimeout = 0;
+			options = NULL;
 		}
 		unsigned int dbiVersion;		/**< DBI Version for backwards compatibility */
 		const char *host;				/**< Host string */
@@ -644,6 +645,33 @@ namespace SourceMod
 		const char *driver;				/**< Driver to use */
 		unsigned int port;				/**< Port to use, 0=default */
 		unsigned int maxTimeout;		/**< Maximum timeout, 0=default */
+		const char *const *options;		/**< Driver-specific options as a NULL-terminated
+											 list of key/value pairs, or NULL (DBI 10+) */
+
+		/**
+		 * @brief Finds a driver-specific option.
+		 *
+		 * Options are any keys in a databases.cfg section that DBI itself
+		 * does not use, for example SQLite's "journal_mode".
+		 *
+		 * @param key			Option name (case sensitive).
+		 * @return				Option value, or NULL if not set.
+		 */
+		const char *GetOption(const char *key) const
+		{
+			if (dbiVersion < 10 || !options)
+			{
+				return NULL;
+			}
+			for (const char *const *iter = options; iter[0] != NULL; iter += 2)
+			{
+				if (strcmp(iter[0], key) == 0)
+				{
+					return iter[1];
+				}
+			}
+			return NULL;
+		}
 	};
 
 	/**
@@ -40,7 +40,7 @@
  */
 
 #define SMINTERFACE_WEBTERNET_NAME		"IWebternet"
-#define SMINTERFACE_WEBTERNET_VERSION	3
+#define SMINTERFACE_WEBTERNET_VERSION	4
 
 namespace SourceMod
 {
@@ -55,6 +55,7 @@ namespace SourceMod
 
 	class IWebTransfer;
 	class IWebternet;
+	class IAsyncWebRequest;
 
 	/**
 	 * @brief Form for POSTing data.
@@ -201,6 +202,112 @@ namespace SourceMod
 		virtual bool SetFailOnHTTPError(bool fail) = 0;
 	};
 
+	/**
+	 * @brief Completion handler for asynchronous requests.
+	 */
+	class IAsyncTransferHandler
+	{
+	public:
+		/**
+		 * @brief Must return the interface version this listener is compatible with.
+		 *
+		 * @return					Interface version.
+		 */
+		virtual unsigned int GetURLInterfaceVersion()
+		{
+			return SMINTERFACE_WEBTERNET_VERSION;
+		}
+
+		/**
+		 * @brief Called on the game thread once a request has finished,
+		 * successfully or not. Ownership of the request returns to the
+		 * caller, who must delete it.
+		 *
+		 * @param request			Finished request.
+		 * @param userdata			User data passed to StartAsyncRequest().
+		 */
+		virtual void OnAsyncTransferComplete(IAsyncWebRequest *request, void *userdata) = 0;
+	};
+
+	/**
+	 * @brief An HTTP request run on webternet's background thread.
+	 *
+	 * Configure the request, then pass it to IWebternet::StartAsyncRequest().
+	 * Once started it must not be touched until its handler is called, except
+	 * to cancel it.
+	 */
+	class IAsyncWebRequest
+	{
+	public:
+		/**
+		 * @brief Virtual destructor.  Call delete to release the resources.
+		 * Started requests must be cancelled instead.
+		 */
+		virtual ~IAsyncWebRequest()
+		{
+		}
+
+		/**
+		 * @brief Adds a request header.
+		 *
+		 * @param header			Header line, such as "Accept: text/plain".
+		 * @return					True on success, false on failure.
+		 */
+		virtual bool AddHeader(const char *header) = 0;
+
+		/**
+		 * @brief Turns the request into a POST with the given body. The data
+		 * is copied locally and may go out of scope.
+		 *
+		 * @param data				Body data.
+		 * @param length			Length of the body data.
+		 */
+		virtual void SetPostData(const void *data, size_t length) = 0;
+
+		/**
+		 * @brief Sets the maximum time the whole transfer may take.
+		 *
+		 * @param seconds			Timeout in seconds, or 0 for none.
+		 */
+		virtual void SetTimeout(unsigned int seconds) = 0;
+
+		/**
+		 * @brief Cancels a started request. Its handler will never be called,
+		 * and webternet deletes the request itself.
+		 */
+		virtual void Cancel() = 0;
+
+		/**
+		 * @brief Returns whether the transfer completed. HTTP error statuses
+		 * still count as a completed transfer.
+		 *
+		 * @return					True if a response was received.
+		 */
+		virtual bool Succeeded() = 0;
+
+		/**
+		 * @brief Returns the HTTP status code of the response.
+		 *
+		 * @return					Status code, or 0 if there was no response.
+		 */
+		virtual int GetStatusCode() = 0;
+
+		/**
+		 * @brief Returns the response body.
+		 *
+		 * @param length			Optional pointer to store the body length.
+		 * @return					Null terminated body data.
+		 */
+		virtual const char *GetBody(size_t *length) = 0;
+
+		/**
+		 * @brief Returns a human-readable error message if the transfer failed.
+		 *
+		 * @return					Error message.
+		 */
+		virtual const char *LastErrorMessage() = 0;
+	};
+
 	/**
 	 * @brief Interface for managing web URL sessions.
 	 */
@@ -223,6 +330,32 @@ namespace SourceMod
 		 * @return				New form, or NULL on failure.
 		 */
 		virtual IWebForm *CreateForm() = 0;
+
+		/**
+		 * @brief Creates an asynchronous HTTP request.
+		 *
+		 * @param url			URL to request.
+		 * @return				New request, or NULL on failure.
+		 */
+		virtual IAsyncWebRequest *CreateAsyncRequest(const char *url) = 0;
+
+		/**
+		 * @brief Starts an asynchronous request. Transfers share one thread
+		 * and reuse connections; only a few run at the same time and the
+		 * rest wait their turn.
+		 *
+		 * Must be called from the game thread.
+		 *
+		 * @param request		Request from CreateAsyncRequest().
+		 * @param handler		Handler called on completion.
+		 * @param userdata		User data pointer.
+		 * @return				True if started, false if too many requests
+		 *						are in flight. The caller keeps ownership
+		 *						on failure.
+		 */
+		virtual bool StartAsyncRequest(IAsyncWebRequest *request,
+			IAsyncTransferHandler *handler,
+			void *userdata) = 0;
 	};
 }
 
@@ -0,0 +1,200 @@
+/**
+ * vim: set ts=4 sw=4 tw=99 noet :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#ifndef _include_sourcemod_ringbuffer_h_
+#define _include_sourcemod_ringbuffer_h_
+
+/**
+ * @file sm_ringbuffer.h
+ *
+ * @brief Bounded, lock-free queue for handing work between threads. Any
+ * number of threads may push; exactly one thread at a time may pop. The
+ * capacity is fixed at construction and rounded up to a power of two.
+ *
+ * Producers never wait on the consumer and vice versa: a push into a full
+ * ring and a pop from an empty ring both fail immediately, so callers decide
+ * how to handle backpressure. Each slot carries a sequence number (Vyukov's
+ * bounded queue), which keeps producers from racing each other for a slot
+ * and lets the consumer tell a claimed-but-unwritten slot from a full one.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+
+namespace SourceMod
+{
+
+template <typename T>
+class RingBuffer
+{
+	struct Slot
+	{
+		std::atomic<size_t> seq;
+		T value;
+	};
+
+public:
+	explicit RingBuffer(size_t capacity)
+		: head_(0),
+		  tail_(0)
+	{
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+
+		mask_ = size - 1;
+		slots_ = new Slot[size];
+		for (size_t i = 0; i < size; i++)
+			slots_[i].seq.store(i, std::memory_order_relaxed);
+	}
+	~RingBuffer()
+	{
+		delete [] slots_;
+	}
+
+	RingBuffer(const RingBuffer &other) = delete;
+	RingBuffer &operator =(const RingBuffer &other) = delete;
+
+	size_t capacity() const
+	{
+		return mask_ + 1;
+	}
+
+	// Safe to call from any producer thread. Returns false if the ring is
+	// full, in which case |value| is left untouched.
+	bool TryPush(const T &value)
+	{
+		Slot *slot;
+		size_t pos = tail_.load(std::memory_order_relaxed);
+		while (true)
+		{
+			slot = &slots_[pos & mask_];
+			size_t seq = slot->seq.load(std::memory_order_acquire);
+			intptr_t diff = intptr_t(seq) - intptr_t(pos);
+			if (diff == 0)
+			{
+				if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = tail_.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->value = value;
+		slot->seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer thread only. Returns false if the ring is empty.
+	bool TryPop(T *out)
+	{
+		size_t pos = head_.load(std::memory_order_relaxed);
+		Slot *slot = &slots_[pos & mask_];
+		if (slot->seq.load(std::memory_order_acquire) != pos + 1)
+			return false;
+
+		*out = std::move(slot->value);
+		slot->seq.store(pos + mask_ + 1, std::memory_order_release);
+		head_.store(pos + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Consumer thread only. Pops up to |max| items into |out| and returns how
+	// many were taken. Stops early at the first slot a producer has claimed
+	// but not finished writing, so ordering is preserved.
+	size_t PopBatch(T *out, size_t max)
+	{
+		size_t pos = head_.load(std::memory_order_relaxed);
+		size_t count = 0;
+		while (count < max)
+		{
+			Slot *slot = &slots_[pos & mask_];
+			if (slot->seq.load(std::memory_order_acquire) != pos + 1)
+				break;
+
+			out[count++] = std::move(slot->value);
+			slot->seq.store(pos + mask_ + 1, std::memory_order_release);
+			pos++;
+		}
+		head_.store(pos, std::memory_order_relaxed);
+		return count;
+	}
+
+	// Consumer thread only. Pops everything currently visible and hands each
+	// item to |fn| in order. Returns the number of items drained.
+	template <typename Fn>
+	size_t Drain(Fn &&fn)
+	{
+		T buffer[kDrainChunk];
+		size_t total = 0;
+		size_t count;
+		while ((count = PopBatch(buffer, kDrainChunk)) != 0)
+		{
+			for (size_t i = 0; i < count; i++)
+				fn(buffer[i]);
+			total += count;
+		}
+		return total;
+	}
+
+	// Approximate when other threads are pushing; exact from the consumer
+	// when no producer is active.
+	bool empty() const
+	{
+		size_t pos = head_.load(std::memory_order_relaxed);
+		return slots_[pos & mask_].seq.load(std::memory_order_acquire) != pos + 1;
+	}
+
+private:
+	static constexpr size_t kDrainChunk = 32;
+
+	Slot *slots_;
+	size_t mask_;
+
+	// Kept on separate cache lines so producers and the consumer don't
+	// bounce the same line back and forth.
+	alignas(64) std::atomic<size_t> head_;
+	alignas(64) std::atomic<size_t> tail_;
+};
+
+} // namespace SourceMod
+
+#endif //_include_sourcemod_ringbuffer_h_
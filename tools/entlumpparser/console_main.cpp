@@ -1,12 +1,56 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
 #include "LumpManager.h"
 
+static int RunBenchmark(const std::string& data, int iterations) {
+	using Clock = std::chrono::steady_clock;
+	
+	EntityLumpManager lumpmgr;
+	
+	auto start = Clock::now();
+	for (int i = 0; i < iterations; i++) {
+		EntityLumpParseResult result = lumpmgr.Parse(data.c_str());
+		if (!result) {
+			std::cout << "Parse error at offset " << result.m_Position << ": " << result.Description() << "\n";
+			return 1;
+		}
+	}
+	std::chrono::duration<double, std::milli> parseTime = Clock::now() - start;
+	
+	// Look up every entry's classname once; the first lookup builds the index.
+	start = Clock::now();
+	size_t found = 0;
+	for (size_t i = 0; i < lumpmgr.Length(); i++) {
+		auto entry = lumpmgr.Get(i).lock();
+		for (const auto& pair : *entry) {
+			if (pair.first == "classname") {
+				if (lumpmgr.Find(Index_Classname, pair.second.c_str(), -1) != -1) {
+					found++;
+				}
+				break;
+			}
+		}
+	}
+	std::chrono::duration<double, std::milli> findTime = Clock::now() - start;
+	
+	double perParse = parseTime.count() / iterations;
+	std::cout << "Entities:        " << lumpmgr.Length() << "\n";
+	std::cout << "Lump size:       " << data.size() << " bytes\n";
+	std::cout << "Parse:           " << perParse << " ms (" << iterations << " iterations, "
+			<< (data.size() / (1024.0 * 1024.0)) / (perParse / 1000.0) << " MB/s)\n";
+	std::cout << "Classname finds: " << findTime.count() << " ms for " << found << " lookups, including index build\n";
+	return 0;
+}
+
 int main(int argc, char *argv[]) {
 	if (argc < 2) {
 		std::cout << "Missing input file\n";
+		std::cout << "Usage: " << argv[0] << " <file> [--bench [iterations]]\n";
 		return 0;
 	}
 	
@@ -15,6 +59,11 @@ int main(int argc, char *argv[]) {
 	std::ifstream input(filepath, std::ios_base::binary);
 	std::string data((std::istreambuf_iterator<char>(input)),  std::istreambuf_iterator<char>());
 	
+	if (argc >= 3 && strcmp(argv[2], "--bench") == 0) {
+		int iterations = argc >= 4 ? atoi(argv[3]) : 100;
+		return RunBenchmark(data, iterations > 0 ? iterations : 1);
+	}
+	
 	EntityLumpManager lumpmgr;
 	lumpmgr.Parse(data.c_str());
 	
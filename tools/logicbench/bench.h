@@ -0,0 +1,104 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#ifndef _INCLUDE_SOURCEMOD_LOGICBENCH_H_
+#define _INCLUDE_SOURCEMOD_LOGICBENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A fixed workload. run() performs the given number of iterations and
+ * returns a checksum of its results, which is printed alongside the timing
+ * so a behavioural change shows up as well as a slowdown.
+ *
+ * Cases register themselves at static initialization time, the same way
+ * SMGlobalClass does.
+ */
+class BenchCase
+{
+public:
+	typedef uint64_t (*RunFn)(size_t iterations);
+
+	BenchCase(const char *name, size_t iterations, RunFn run)
+		: name_(name), iterations_(iterations), run_(run)
+	{
+		next_ = head;
+		head = this;
+	}
+
+	const char *name() const
+	{
+		return name_;
+	}
+	size_t iterations() const
+	{
+		return iterations_;
+	}
+	uint64_t run(size_t iterations) const
+	{
+		return run_(iterations);
+	}
+	BenchCase *next() const
+	{
+		return next_;
+	}
+public:
+	static BenchCase *head;
+private:
+	const char *name_;
+	size_t iterations_;
+	RunFn run_;
+	BenchCase *next_;
+};
+
+/* Deterministic generator so every run uses the same data. */
+class BenchRandom
+{
+public:
+	explicit BenchRandom(uint32_t seed) : state_(seed)
+	{
+	}
+	uint32_t next()
+	{
+		state_ = state_ * 1664525u + 1013904223u;
+		return state_ >> 8;
+	}
+	uint32_t next(uint32_t bound)
+	{
+		return next() % bound;
+	}
+private:
+	uint32_t state_;
+};
+
+#endif //_INCLUDE_SOURCEMOD_LOGICBENCH_H_
@@ -0,0 +1,373 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+/* Fixed workloads for engine-independent pieces of logic. Data is generated
+ * from fixed seeds so that timings and checksums are comparable between
+ * builds.
+ */
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "common_logic.h"
+#include "sprintf.h"
+#include "TextParsers.h"
+#include "CellArray.h"
+#include "CDataPack.h"
+#include "LumpManager.h"
+#include <sm_hashmap.h>
+#include <sm_namehashset.h>
+
+using namespace SourceMod;
+
+static const size_t kKeyCount = 4096;
+static const size_t kLumpEntities = 2000;
+
+static uint64_t Mix(uint64_t checksum, uint64_t value)
+{
+	return (checksum ^ value) * 1099511628211ull;
+}
+
+static const std::vector<std::string> &GetKeys()
+{
+	static std::vector<std::string> keys;
+	if (keys.empty())
+	{
+		BenchRandom rand(1);
+		char buffer[64];
+		for (size_t i = 0; i < kKeyCount; i++)
+		{
+			snprintf(buffer, sizeof(buffer), "key_%u_%zu", rand.next(), i);
+			keys.push_back(buffer);
+		}
+	}
+	return keys;
+}
+
+/**
+ * gnprintf, the formatter behind phrase and core message formatting.
+ */
+static uint64_t RunGnprintf(size_t iterations)
+{
+	char buffer[256];
+	const char *name = "Player";
+	const char *auth = "STEAM_1:0:12345";
+	uint64_t checksum = 0;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		int userid = (int)i;
+		int score = (int)(i * 7);
+		float ratio = (float)(i % 1000) / 10.0f;
+		unsigned int flags = (unsigned int)i * 2654435761u;
+
+		void *params[] = {(void *)name, &userid, (void *)auth, &score, &ratio, &flags};
+		unsigned int curparam = 0;
+		size_t length = 0;
+		gnprintf(buffer, sizeof(buffer), "%s<%d><%s> scored %d (%.2f%%) flags %x",
+			NULL, params, sizeof(params) / sizeof(params[0]), curparam, &length, NULL);
+		checksum = Mix(checksum, length);
+	}
+	return checksum;
+}
+static BenchCase s_Gnprintf("sprintf.gnprintf", 500000, RunGnprintf);
+
+/**
+ * SMC parsing of an in-memory document shaped like an admin or phrase file.
+ */
+class CountingListener : public ITextListener_SMC
+{
+public:
+	CountingListener() : count(0)
+	{
+	}
+	SMCResult ReadSMC_NewSection(const SMCStates *states, const char *name)
+	{
+		count = Mix(count, strlen(name));
+		return SMCResult_Continue;
+	}
+	SMCResult ReadSMC_KeyValue(const SMCStates *states, const char *key, const char *value)
+	{
+		count = Mix(count, strlen(key) + strlen(value));
+		return SMCResult_Continue;
+	}
+	SMCResult ReadSMC_LeavingSection(const SMCStates *states)
+	{
+		return SMCResult_Continue;
+	}
+public:
+	uint64_t count;
+};
+
+static const std::string &GetSMCDocument()
+{
+	static std::string doc;
+	if (doc.empty())
+	{
+		const std::vector<std::string> &keys = GetKeys();
+		doc = "\"Phrases\"\n{\n";
+		for (size_t i = 0; i < 2000; i++)
+		{
+			doc += "\t\"" + keys[i] + "\"\n\t{\n";
+			doc += "\t\t\"#format\"\t\"{1:s},{2:d}\"\n";
+			doc += "\t\t\"en\"\t\t\"{1} has {2} points // not a comment\"\n";
+			doc += "\t\t\"de\"\t\t\"{1} hat {2} Punkte\"\n";
+			doc += "\t\t// trailing comment\n";
+			doc += "\t}\n";
+		}
+		doc += "}\n";
+	}
+	return doc;
+}
+
+static uint64_t RunSMCParse(size_t iterations)
+{
+	const std::string &doc = GetSMCDocument();
+	uint64_t checksum = 0;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		CountingListener listener;
+		SMCStates states = {0, 0};
+		char error[64];
+		g_TextParser.ParseSMCStream(doc.c_str(), doc.size(), &listener, &states, error, sizeof(error));
+		checksum = Mix(checksum, listener.count);
+	}
+	return checksum;
+}
+static BenchCase s_SMCParse("textparse.smc_stream", 200, RunSMCParse);
+
+/**
+ * ArrayList storage: push blocks, then read every block back.
+ */
+static uint64_t RunCellArray(size_t iterations)
+{
+	CellArray array(3);
+	uint64_t checksum = 0;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		cell_t *blk = array.push();
+		blk[0] = (cell_t)i;
+		blk[1] = (cell_t)(i * 3);
+		blk[2] = (cell_t)(i ^ 0x5a5a);
+	}
+	for (size_t i = 0; i < array.size(); i++)
+	{
+		cell_t *blk = array.at(i);
+		checksum = Mix(checksum, (uint32_t)(blk[0] + blk[1] + blk[2]));
+	}
+	return checksum;
+}
+static BenchCase s_CellArray("cellarray.push_read", 2000000, RunCellArray);
+
+/**
+ * DataPack: pack a cell, a float and a string, then read them all back.
+ */
+static uint64_t RunDataPack(size_t iterations)
+{
+	CDataPack pack;
+	uint64_t checksum = 0;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		pack.PackCell((cell_t)i);
+		pack.PackFloat((float)i * 0.5f);
+		pack.PackString("weapon_ak47");
+	}
+
+	pack.Reset();
+	for (size_t i = 0; i < iterations; i++)
+	{
+		size_t len = 0;
+		cell_t cell = pack.ReadCell();
+		float f = pack.ReadFloat();
+		pack.ReadString(&len);
+		checksum = Mix(checksum, (uint64_t)cell + (uint64_t)f + len);
+	}
+	return checksum;
+}
+static BenchCase s_DataPack("datapack.pack_read", 500000, RunDataPack);
+
+/**
+ * StringMap storage: hits and misses against a pre-filled map, then an
+ * insert/remove churn.
+ */
+static uint64_t RunStringMapLookup(size_t iterations)
+{
+	static StringHashMap<int> map;
+	const std::vector<std::string> &keys = GetKeys();
+	if (map.elements() == 0)
+	{
+		for (size_t i = 0; i < keys.size(); i += 2)
+			map.insert(keys[i].c_str(), (int)i);
+	}
+
+	uint64_t checksum = 0;
+	for (size_t i = 0; i < iterations; i++)
+	{
+		int value = -1;
+		map.retrieve(keys[i % keys.size()].c_str(), &value);
+		checksum = Mix(checksum, (uint32_t)value);
+	}
+	return checksum;
+}
+static BenchCase s_StringMapLookup("stringhashmap.lookup", 2000000, RunStringMapLookup);
+
+static uint64_t RunStringMapChurn(size_t iterations)
+{
+	StringHashMap<int> map;
+	const std::vector<std::string> &keys = GetKeys();
+	uint64_t checksum = 0;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		const char *key = keys[i % keys.size()].c_str();
+		if (!map.insert(key, (int)i))
+			map.remove(key);
+		checksum = Mix(checksum, map.elements());
+	}
+	return checksum;
+}
+static BenchCase s_StringMapChurn("stringhashmap.insert_remove", 1000000, RunStringMapChurn);
+
+/**
+ * NameHashSet, used for command and convar lookups.
+ */
+struct BenchNamed
+{
+	std::string name;
+	int value;
+
+	static inline bool matches(const char *key, const BenchNamed *named)
+	{
+		return named->name == key;
+	}
+	static inline uint32_t hash(const detail::CharsAndLength &key)
+	{
+		return key.hash();
+	}
+};
+
+static uint64_t RunNameHashSet(size_t iterations)
+{
+	static NameHashSet<BenchNamed *> set;
+	static std::vector<BenchNamed> storage;
+	const std::vector<std::string> &keys = GetKeys();
+	if (storage.empty())
+	{
+		storage.resize(keys.size() / 2);
+		for (size_t i = 0; i < storage.size(); i++)
+		{
+			storage[i].name = keys[i * 2];
+			storage[i].value = (int)i;
+			set.insert(storage[i].name.c_str(), &storage[i]);
+		}
+	}
+
+	uint64_t checksum = 0;
+	for (size_t i = 0; i < iterations; i++)
+	{
+		BenchNamed *named = NULL;
+		if (set.retrieve(keys[i % keys.size()].c_str(), &named))
+			checksum = Mix(checksum, named->value);
+	}
+	return checksum;
+}
+static BenchCase s_NameHashSet("namehashset.lookup", 2000000, RunNameHashSet);
+
+/**
+ * Entity lump parsing and classname lookups.
+ */
+static const std::string &GetEntityLump()
+{
+	static std::string lump;
+	if (lump.empty())
+	{
+		static const char *classnames[] = {
+			"info_player_terrorist", "info_player_counterterrorist", "prop_static",
+			"func_brush", "light", "env_sprite", "trigger_multiple", "func_door",
+		};
+		static const size_t numClassnames = sizeof(classnames) / sizeof(classnames[0]);
+
+		BenchRandom rand(2);
+		char buffer[512];
+		for (size_t i = 0; i < kLumpEntities; i++)
+		{
+			snprintf(buffer, sizeof(buffer),
+				"{\n\"origin\" \"%u %u %u\"\n\"angles\" \"0 %u 0\"\n\"targetname\" \"ent_%zu\"\n"
+				"\"hammerid\" \"%zu\"\n\"classname\" \"%s\"\n\"OnTrigger\" \"ent_%u,Toggle,,0,-1\"\n}\n",
+				rand.next(4096), rand.next(4096), rand.next(512), rand.next(360),
+				i, i + 1, classnames[rand.next(numClassnames)], rand.next((uint32_t)kLumpEntities));
+			lump += buffer;
+		}
+	}
+	return lump;
+}
+
+static uint64_t RunEntityLumpParse(size_t iterations)
+{
+	const std::string &lump = GetEntityLump();
+	EntityLumpManager manager;
+	uint64_t checksum = 0;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		manager.Parse(lump.c_str());
+		checksum = Mix(checksum, manager.Length());
+	}
+	return checksum;
+}
+static BenchCase s_EntityLumpParse("entlump.parse", 100, RunEntityLumpParse);
+
+static uint64_t RunEntityLumpFind(size_t iterations)
+{
+	static EntityLumpManager manager;
+	if (manager.Length() == 0)
+		manager.Parse(GetEntityLump().c_str());
+
+	/* Walk every match of a common classname; the index is built on the
+	 * first lookup and reused afterwards. */
+	uint64_t checksum = 0;
+	for (size_t i = 0; i < iterations; i++)
+	{
+		int found = -1;
+		size_t matches = 0;
+		while ((found = manager.Find(Index_Classname, "prop_static", found)) != -1)
+			matches++;
+		checksum = Mix(checksum, matches);
+	}
+	return checksum;
+}
+static BenchCase s_EntityLumpFind("entlump.find_classname", 20000, RunEntityLumpFind);
@@ -0,0 +1,144 @@
+/**
+ * vim: set ts=4 :
+ * =============================================================================
+ * SourceMod
+ * Copyright (C) 2004-2008 AlliedModders LLC.  All rights reserved.
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, AlliedModders LLC gives you permission to link the
+ * code of this program (as well as its derivative works) to "Half-Life 2," the
+ * "Source Engine," the "SourcePawn JIT," and any Game MODs that run on software
+ * by the Valve Corporation.  You must obey the GNU General Public License in
+ * all respects for all other code used.  Additionally, AlliedModders LLC grants
+ * this exception to all derivative works.  AlliedModders LLC defines further
+ * exceptions, found in LICENSE.txt (as of this writing, version JULY-31-2007),
+ * or <http://www.sourcemod.net/license.php>.
+ *
+ * Version: $Id$
+ */
+
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "bench.h"
+
+BenchCase *BenchCase::head = NULL;
+
+static void Usage(const char *argv0)
+{
+	fprintf(stderr, "Usage: %s [--list] [--text] [--filter <substring>] [--scale <factor>]\n", argv0);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Runs every benchmark and prints one JSON object per line:\n");
+	fprintf(stderr, "  {\"name\":...,\"iterations\":...,\"total_ms\":...,\"ns_per_op\":...,\"checksum\":...}\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "  --list     Print benchmark names and exit\n");
+	fprintf(stderr, "  --text     Print an aligned table instead of JSON\n");
+	fprintf(stderr, "  --filter   Only run benchmarks whose name contains the substring\n");
+	fprintf(stderr, "  --scale    Multiply every iteration count (default 1.0)\n");
+}
+
+int main(int argc, char **argv)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	bool list = false;
+	bool text = false;
+	const char *filter = NULL;
+	double scale = 1.0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--list") == 0)
+		{
+			list = true;
+		}
+		else if (strcmp(argv[i], "--text") == 0)
+		{
+			text = true;
+		}
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+		{
+			scale = atof(argv[++i]);
+			if (scale <= 0.0)
+			{
+				fprintf(stderr, "Invalid scale: %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+
+	/* Registration prepends, so flip the list to run in source order. */
+	std::vector<BenchCase *> cases;
+	for (BenchCase *bc = BenchCase::head; bc; bc = bc->next())
+	{
+		if (!filter || strstr(bc->name(), filter))
+			cases.insert(cases.begin(), bc);
+	}
+
+	if (list)
+	{
+		for (size_t i = 0; i < cases.size(); i++)
+			printf("%s\n", cases[i]->name());
+		return 0;
+	}
+
+	if (text)
+	{
+		printf("%-32s %12s %12s %12s  %s\n", "name", "iterations", "total ms", "ns/op", "checksum");
+	}
+
+	for (size_t i = 0; i < cases.size(); i++)
+	{
+		BenchCase *bc = cases[i];
+		size_t iterations = (size_t)(bc->iterations() * scale);
+		if (iterations == 0)
+			iterations = 1;
+
+		/* Warm caches and allocators before timing. */
+		bc->run(iterations / 10 + 1);
+
+		Clock::time_point start = Clock::now();
+		uint64_t checksum = bc->run(iterations);
+		std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+		double total_ms = elapsed.count();
+		double ns_per_op = total_ms * 1000000.0 / iterations;
+		if (text)
+		{
+			printf("%-32s %12zu %12.3f %12.1f  %016llx\n",
+				bc->name(), iterations, total_ms, ns_per_op, (unsigned long long)checksum);
+		}
+		else
+		{
+			printf("{\"name\":\"%s\",\"iterations\":%zu,\"total_ms\":%.3f,\"ns_per_op\":%.1f,\"checksum\":\"%016llx\"}\n",
+				bc->name(), iterations, total_ms, ns_per_op, (unsigned long long)checksum);
+		}
+		fflush(stdout);
+	}
+
+	return 0;
+}